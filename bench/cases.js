@@ -0,0 +1,259 @@
+'use strict'
+
+// each case opens what it needs, runs its loop through the harness and closes again so the
+// cases can be run alone or in any order. ctx carries the sql module, the connection string,
+// whether the target is the mock driver and the tuning options from the command line.
+
+const { loop, Samples, now, elapsedMs, round } = require('./harness')
+
+function range (n) {
+  return Array.from({ length: n }, (_, i) => i)
+}
+
+function perSec (count, ms) {
+  return round(ms > 0 ? count * 1000 / ms : 0, 1)
+}
+
+// bytes carried by a cell once it is in js - strings are counted as utf16 as that is
+// what the driver reads them as for nvarchar.
+function sizeOf (v) {
+  if (v === null || v === undefined) return 0
+  if (typeof v === 'string') return v.length * 2
+  if (Buffer.isBuffer(v)) return v.length
+  return 8
+}
+
+// a result of rows x (id + width nvarchar(100)) - generated by the mock from the statement
+// itself, on a server cross joined from the catalogue so no table needs to exist.
+function wideSql (ctx, rows, width) {
+  if (ctx.mock) {
+    const cols = ['id:int'].concat(range(width).map(i => `c${i}:nvarchar(100)`))
+    return `mock:rows=${rows};columns={${cols.join(',')}};nullratio=0`
+  }
+  const cols = range(width).map(i => `replicate(N'x', 100) as c${i}`)
+  return `select top (${rows}) row_number() over (order by (select null)) as id, ${cols.join(', ')} from sys.all_objects a cross join sys.all_objects b`
+}
+
+function makeRows (count) {
+  const at = new Date(Date.UTC(2024, 0, 1))
+  return range(count).map(i => {
+    return {
+      id: i,
+      name: `name_${i}`,
+      amount: i * 1.5,
+      created: new Date(at.getTime() + i * 1000)
+    }
+  })
+}
+
+function benchBuilder (conn, tableName) {
+  const builder = conn.tableMgr().makeBuilder(tableName)
+  builder.addColumn('id').asInt().isPrimaryKey(1)
+  builder.addColumn('name').asNVarChar(64)
+  builder.addColumn('amount').asFloat()
+  builder.addColumn('created').asDateTime()
+  return builder
+}
+
+async function withConnection (ctx, fn) {
+  const conn = await ctx.sql.promises.open(ctx.connectionString)
+  try {
+    const res = await fn(conn)
+    res.native = conn.getStats()
+    return res
+  } finally {
+    await conn.promises.close()
+  }
+}
+
+function stream (conn, sql) {
+  return new Promise((resolve, reject) => {
+    let rows = 0
+    let bytes = 0
+    const q = conn.query(sql)
+    q.on('column', (i, v) => { bytes += sizeOf(v) })
+    q.on('row', () => { ++rows })
+    q.on('error', e => reject(e))
+    q.on('done', () => resolve({ rows, bytes }))
+  })
+}
+
+async function bulkInsert (ctx, useBcp) {
+  return withConnection(ctx, async conn => {
+    const builder = benchBuilder(conn, useBcp ? 'bench_bcp' : 'bench_array')
+    const table = builder.toTable()
+    await builder.drop()
+    await builder.create()
+    table.setBatchSize(ctx.options.batch)
+    if (useBcp) {
+      table.setUseBcp(true)
+    }
+    const rows = makeRows(ctx.options.rows)
+    const res = await loop({ seconds: ctx.options.seconds, iterations: ctx.options.iterations }, async () => {
+      await builder.truncate()
+      await table.promises.insert(rows)
+    })
+    await builder.drop()
+    return {
+      rowsPerBatch: rows.length,
+      rowsPerSec: perSec(res.iterations * rows.length, res.elapsedMs),
+      ...res
+    }
+  })
+}
+
+const cases = [
+  {
+    name: 'oltp',
+    description: 'single row select issued back to back on one connection',
+    run: async ctx => withConnection(ctx, async conn => {
+      const res = await loop({ ...ctx.options, warmup: 20 }, () => conn.promises.query('select 1 as n'))
+      return {
+        queriesPerSec: perSec(res.iterations, res.elapsedMs),
+        ...res
+      }
+    })
+  },
+
+  {
+    name: 'stream',
+    description: 'wide rows streamed through column events',
+    run: async ctx => withConnection(ctx, async conn => {
+      const sql = wideSql(ctx, ctx.options.rows, ctx.options.width)
+      let rows = 0
+      let bytes = 0
+      const res = await loop({ ...ctx.options, warmup: 1 }, async () => {
+        const r = await stream(conn, sql)
+        rows += r.rows
+        bytes += r.bytes
+      })
+      return {
+        rowsPerSec: perSec(rows, res.elapsedMs),
+        mbPerSec: round(bytes / (1024 * 1024) / (res.elapsedMs / 1000), 2),
+        bytes,
+        ...res
+      }
+    })
+  },
+
+  {
+    name: 'prepared',
+    description: 'one prepared single row select re-executed with a new parameter',
+    run: async ctx => withConnection(ctx, async conn => {
+      const ps = await conn.promises.prepare('select ? as n')
+      try {
+        const res = await loop({ ...ctx.options, warmup: 20 }, i => ps.promises.query([i]))
+        return {
+          queriesPerSec: perSec(res.iterations, res.elapsedMs),
+          ...res
+        }
+      } finally {
+        await ps.promises.free()
+      }
+    })
+  },
+
+  {
+    name: 'array',
+    description: 'bulk table manager insert, each column sent as one array parameter',
+    run: async ctx => bulkInsert(ctx, false)
+  },
+
+  {
+    name: 'bcp',
+    description: 'bulk table manager insert with bcp enabled',
+    run: async ctx => bulkInsert(ctx, true)
+  },
+
+  {
+    name: 'tvp',
+    description: 'rows sent as a table valued parameter to an insert procedure',
+    serverOnly: 'resolves the table type from the catalogue, which the mock driver cannot answer',
+    run: async ctx => withConnection(ctx, async conn => {
+      const builder = benchBuilder(conn, 'bench_tvp')
+      builder.toTable()
+      const promises = conn.promises
+      await builder.drop()
+      await builder.create()
+      await promises.query(builder.dropInsertTvpProcedure)
+      await promises.query(builder.dropTypeSql)
+      await promises.query(builder.userTypeTableSql)
+      await promises.query(builder.insertProcedureTvpSql)
+      const rows = makeRows(ctx.options.rows)
+      const tvpTable = await promises.getUserTypeTable(builder.typeName)
+      const res = await loop({ seconds: ctx.options.seconds, iterations: ctx.options.iterations }, async () => {
+        await builder.truncate()
+        tvpTable.rows = []
+        tvpTable.addRowsFromObjects(rows)
+        await promises.query(`exec ${builder.insertTvpProcedureName} @tvp = ?;`, [ctx.sql.TvpFromTable(tvpTable)])
+      })
+      await promises.query(builder.dropInsertTvpProcedure)
+      await builder.drop()
+      await promises.query(builder.dropTypeSql)
+      return {
+        rowsPerBatch: rows.length,
+        rowsPerSec: perSec(res.iterations * rows.length, res.elapsedMs),
+        ...res
+      }
+    })
+  },
+
+  {
+    name: 'pool',
+    description: 'single row selects submitted to a pool faster than it can serve them',
+    run: async ctx => {
+      const size = ctx.options.poolSize
+      const pool = new ctx.sql.Pool({ connectionString: ctx.connectionString, floor: size, ceiling: size })
+      const waits = new Samples()
+      pool.on('status', s => {
+        if (s.op === 'checkout' && s.waitMs !== undefined) waits.add(s.waitMs)
+      })
+      await pool.promises.open()
+      try {
+        // every round keeps concurrency queries in flight so most of them queue for a connection
+        const concurrency = size * 4
+        const res = await loop({ ...ctx.options, warmup: 2 }, () =>
+          Promise.all(range(concurrency).map(() => pool.promises.query('select 1 as n'))))
+        return {
+          poolSize: size,
+          concurrency,
+          queriesPerSec: perSec(res.iterations * concurrency, res.elapsedMs),
+          checkoutWait: waits.summary(),
+          ...res,
+          native: pool.getStats()
+        }
+      } finally {
+        await pool.promises.close()
+      }
+    }
+  },
+
+  {
+    name: 'blocking',
+    description: 'a wide result materialised in one callback - watch eventLoop, not throughput',
+    run: async ctx => withConnection(ctx, async conn => {
+      const sql = wideSql(ctx, ctx.options.rows, ctx.options.width)
+      // a 1ms ticker measures the longest time the loop went without running it
+      let longest = 0
+      let last = now()
+      const ticker = setInterval(() => {
+        longest = Math.max(longest, elapsedMs(last))
+        last = now()
+      }, 1)
+      try {
+        const res = await loop({ ...ctx.options, warmup: 1 }, () => conn.promises.query(sql))
+        return {
+          longestStallMs: round(longest),
+          ...res
+        }
+      } finally {
+        clearInterval(ticker)
+      }
+    })
+  }
+]
+
+module.exports = {
+  cases,
+  wideSql
+}
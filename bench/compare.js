@@ -0,0 +1,54 @@
+'use strict'
+
+// node bench/compare.js <base.json> <head.json>
+// prints the headline rate and p99 of each case from two runs side by side with the change,
+// rates higher is better, latencies lower is better.
+
+const fs = require('fs')
+
+function load (file) {
+  return JSON.parse(fs.readFileSync(file, 'utf8'))
+}
+
+function headline (r) {
+  if (!r || r.skipped || r.error) return null
+  if (r.mbPerSec !== undefined) return { metric: 'MB/s', value: r.mbPerSec }
+  if (r.rowsPerSec !== undefined) return { metric: 'rows/s', value: r.rowsPerSec }
+  if (r.queriesPerSec !== undefined) return { metric: 'queries/s', value: r.queriesPerSec }
+  return { metric: 'stall ms', value: r.longestStallMs }
+}
+
+function change (base, head) {
+  if (!base) return ''
+  const pct = (head - base) * 100 / base
+  return `${pct >= 0 ? '+' : ''}${pct.toFixed(1)}%`
+}
+
+function main () {
+  const [baseFile, headFile] = process.argv.slice(2)
+  if (!baseFile || !headFile) {
+    console.error('usage: node bench/compare.js <base.json> <head.json>')
+    process.exit(1)
+  }
+  const base = load(baseFile)
+  const head = load(headFile)
+  console.log(`base ${base.commit} (${base.target}, ${base.node})  head ${head.commit} (${head.target}, ${head.node})`)
+  if (base.target !== head.target) {
+    console.log('warning - the runs were against different targets')
+  }
+  const byName = new Map(base.results.map(r => [r.name, r]))
+  head.results.forEach(h => {
+    const b = byName.get(h.name)
+    const hh = headline(h)
+    const bh = headline(b)
+    if (!hh || !bh) {
+      console.log(`${h.name.padEnd(10)} ${h.skipped || h.error || (b && (b.skipped || b.error)) || 'not in base'}`)
+      return
+    }
+    const p99 = `p99 ${b.latency.p99Ms} -> ${h.latency.p99Ms} ms (${change(b.latency.p99Ms, h.latency.p99Ms)})`
+    const loop = `loop p99 ${b.eventLoop.p99Ms} -> ${h.eventLoop.p99Ms} ms`
+    console.log(`${h.name.padEnd(10)} ${hh.metric} ${bh.value} -> ${hh.value} (${change(bh.value, hh.value)})  ${p99}  ${loop}`)
+  })
+}
+
+main()
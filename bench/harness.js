@@ -0,0 +1,122 @@
+'use strict'
+
+// timing helpers shared by the bench cases - wall clock from process.hrtime, latencies kept
+// as raw samples so percentiles are exact, and the event loop delay watched for the whole
+// of each case so a path that blocks the loop shows up even when its throughput looks fine.
+
+const { monitorEventLoopDelay } = require('perf_hooks')
+
+function now () {
+  return process.hrtime.bigint()
+}
+
+function elapsedMs (from) {
+  return Number(process.hrtime.bigint() - from) / 1e6
+}
+
+function round (v, places) {
+  const p = Math.pow(10, places === undefined ? 3 : places)
+  return Math.round(v * p) / p
+}
+
+class Samples {
+  constructor () {
+    this.values = []
+  }
+
+  add (ms) {
+    this.values.push(ms)
+  }
+
+  percentile (sorted, p) {
+    if (sorted.length === 0) return 0
+    const at = Math.min(sorted.length - 1, Math.ceil(p / 100 * sorted.length) - 1)
+    return sorted[Math.max(0, at)]
+  }
+
+  summary () {
+    const sorted = this.values.slice().sort((a, b) => a - b)
+    const count = sorted.length
+    const sum = sorted.reduce((agg, v) => agg + v, 0)
+    return {
+      count,
+      meanMs: round(count ? sum / count : 0),
+      p50Ms: round(this.percentile(sorted, 50)),
+      p90Ms: round(this.percentile(sorted, 90)),
+      p99Ms: round(this.percentile(sorted, 99)),
+      maxMs: round(count ? sorted[count - 1] : 0)
+    }
+  }
+}
+
+// run fn back to back until the time budget or the iteration cap is reached, whichever is
+// first - a short warm up is run and discarded so statement caches and the pool are primed.
+async function loop (options, fn) {
+  const samples = new Samples()
+  const warmup = options.warmup || 0
+  for (let i = 0; i < warmup; ++i) {
+    await fn(i)
+  }
+  const budget = options.seconds * 1000
+  const cap = options.iterations || Number.MAX_SAFE_INTEGER
+  const start = now()
+  let i = 0
+  while (i < cap && elapsedMs(start) < budget) {
+    const t = now()
+    await fn(i)
+    samples.add(elapsedMs(t))
+    ++i
+  }
+  return {
+    iterations: i,
+    elapsedMs: round(elapsedMs(start)),
+    latency: samples.summary()
+  }
+}
+
+// the loop delay histogram works in ns at a 10ms sample resolution by default, which
+// would hide the short stalls a synchronous decode causes - sample every 1ms instead.
+function watchEventLoop () {
+  const h = monitorEventLoopDelay({ resolution: 1 })
+  h.enable()
+  return () => {
+    h.disable()
+    const ms = v => round(v / 1e6)
+    return {
+      meanMs: ms(h.mean || 0),
+      p50Ms: ms(h.percentile(50)),
+      p99Ms: ms(h.percentile(99)),
+      maxMs: ms(h.max)
+    }
+  }
+}
+
+async function runCase (c, ctx) {
+  if (c.serverOnly && ctx.mock) {
+    return { name: c.name, skipped: c.serverOnly }
+  }
+  const stop = watchEventLoop()
+  const start = now()
+  try {
+    const res = await c.run(ctx)
+    return {
+      name: c.name,
+      elapsedMs: round(elapsedMs(start)),
+      ...res,
+      eventLoop: stop()
+    }
+  } catch (e) {
+    stop()
+    return { name: c.name, error: e.message }
+  }
+}
+
+module.exports = {
+  Samples,
+  loop,
+  now,
+  elapsedMs,
+  round,
+  watchEventLoop,
+  runCase
+}
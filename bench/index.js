@@ -0,0 +1,133 @@
+'use strict'
+
+// node bench/index.js [--mock[=<library>]] [--connection=<odbc>] [--suite=oltp,stream,...]
+//   [--seconds=5] [--iterations=n] [--rows=10000] [--width=10] [--batch=0] [--pool=4]
+//   [--out=<file>] [--list]
+//
+// runs the cases in cases.js against a server (--connection, MSNODESQLV8_BENCH_CONNECTION
+// or the same connection the tests use) or the mock driver built by npm run build-mock, and
+// writes one json document per run so two commits can be diffed with bench/compare.js.
+
+const fs = require('fs')
+const os = require('os')
+const path = require('path')
+const { execSync } = require('child_process')
+const argv = require('minimist')(process.argv.slice(2))
+
+function mockLibrary (given) {
+  if (typeof given === 'string') return path.resolve(given)
+  const root = path.join(__dirname, '..', 'build', 'Release')
+  const candidates = [
+    path.join(root, 'lib.target', 'libmsnodesqlv8mock.so'),
+    path.join(root, 'libmsnodesqlv8mock.dylib'),
+    path.join(root, 'libmsnodesqlv8mock.so')
+  ]
+  const found = candidates.find(p => fs.existsSync(p))
+  if (!found) {
+    throw new Error('mock driver not found - build it with npm run build-mock')
+  }
+  return found
+}
+
+function serverConnection () {
+  if (argv.connection) return argv.connection
+  if (process.env.MSNODESQLV8_BENCH_CONNECTION) return process.env.MSNODESQLV8_BENCH_CONNECTION
+  const { TestEnv } = require('../test/env/test-env')
+  return new TestEnv().getConnection()
+}
+
+function commit () {
+  try {
+    return execSync('git rev-parse --short HEAD', { cwd: __dirname, stdio: ['ignore', 'pipe', 'ignore'] }).toString().trim()
+  } catch (e) {
+    return 'unknown'
+  }
+}
+
+async function main () {
+  const { cases } = require('./cases')
+  const { runCase } = require('./harness')
+
+  if (argv.list) {
+    cases.forEach(c => console.log(`${c.name.padEnd(10)} ${c.description}`))
+    return
+  }
+
+  const mock = argv.mock !== undefined && argv.mock !== false
+  let connectionString
+  if (mock) {
+    const library = mockLibrary(argv.mock)
+    // bcp is dynloaded on first use, the override has to be in place before then
+    process.env.MSNODESQLV8_BCP_LIBRARY = process.env.MSNODESQLV8_BCP_LIBRARY || library
+    connectionString = `Driver=${library};Rows=1;Columns={n:int}`
+  } else {
+    connectionString = serverConnection()
+  }
+  if (!connectionString) {
+    throw new Error('no connection - pass --connection, set MSNODESQLV8_BENCH_CONNECTION or use --mock')
+  }
+
+  const options = {
+    seconds: Number(argv.seconds || 5),
+    iterations: argv.iterations ? Number(argv.iterations) : 0,
+    rows: Number(argv.rows || 10000),
+    width: Number(argv.width || 10),
+    batch: Number(argv.batch || 0),
+    poolSize: Number(argv.pool || 4)
+  }
+  const wanted = argv.suite ? String(argv.suite).split(',') : cases.map(c => c.name)
+  const unknown = wanted.filter(n => !cases.some(c => c.name === n))
+  if (unknown.length > 0) {
+    throw new Error(`unknown case(s) ${unknown.join(', ')} - see --list`)
+  }
+
+  const ctx = {
+    sql: require('../lib/sql'),
+    connectionString,
+    mock,
+    options
+  }
+
+  const results = []
+  for (const c of cases.filter(c => wanted.includes(c.name))) {
+    process.stdout.write(`${c.name.padEnd(10)} `)
+    const res = await runCase(c, ctx)
+    results.push(res)
+    if (res.skipped) {
+      console.log(`skipped - ${res.skipped}`)
+    } else if (res.error) {
+      console.log(`error - ${res.error}`)
+    } else {
+      const rate = res.mbPerSec !== undefined
+        ? `${res.mbPerSec} MB/s`
+        : res.rowsPerSec !== undefined
+          ? `${res.rowsPerSec} rows/s`
+          : res.queriesPerSec !== undefined
+            ? `${res.queriesPerSec} queries/s`
+            : `stall ${res.longestStallMs} ms`
+      console.log(`${rate.padEnd(22)} p99 ${res.latency.p99Ms} ms  loop p99 ${res.eventLoop.p99Ms} ms`)
+    }
+  }
+
+  const doc = {
+    commit: commit(),
+    time: new Date().toISOString(),
+    target: mock ? 'mock' : 'server',
+    node: process.version,
+    platform: `${os.platform()}-${os.arch()}`,
+    cpus: os.cpus().length,
+    options,
+    results
+  }
+  const out = argv.out
+    ? path.resolve(argv.out)
+    : path.join(__dirname, 'results', `${doc.time.replace(/[:.]/g, '-')}-${doc.commit}-${doc.target}.json`)
+  fs.mkdirSync(path.dirname(out), { recursive: true })
+  fs.writeFileSync(out, JSON.stringify(doc, null, 2))
+  console.log(`results written to ${out}`)
+}
+
+main().catch(e => {
+  console.error(e.message)
+  process.exit(1)
+})
@@ -19,7 +19,31 @@
                   'arch%': '<!(echo %PROCESSOR_ARCHITECTURE%)'
                 }
               }
-            ]
+            ],
+            ['build_mock=="true" and OS!="win"', {
+              'targets': [
+                {
+                  # loaded by unixODBC through Driver=<path to the library> in the connection
+                  # string, see mock/MockDriver.h. not part of the addon.
+                  'target_name': 'msnodesqlv8mock',
+                  'type': 'shared_library',
+                  'sources': [
+                    'mock/MockDriver.cpp',
+                    'mock/MockData.cpp',
+                    'mock/MockBcp.cpp'
+                  ],
+                  'cflags_cc': ['-std=c++17'],
+                  'xcode_settings': {
+                    'CLANG_CXX_LANGUAGE_STANDARD': 'c++17'
+                  },
+                  'include_dirs': [
+                    '/usr/include/',
+                    '/usr/local/include/',
+                    '/opt/homebrew/include'
+                  ]
+                }
+              ]
+            }]
         ],
         'variables': {
           'openssl_fips' : '0',
@@ -29,6 +53,8 @@
             'msodbcsql17'
           ],
           'ext%': '.cpp',
+          # set by npm run build-mock to also build the in memory ODBC driver in mock/
+          'build_mock%': 'false',
           'homebrew%': '/opt/homebrew/lib/libodbc.a',
           'unixlocalodbc%': '-l/usr/local/odbc',
           'linuxodbc%': '-lodbc',
@@ -0,0 +1,232 @@
+'use strict'
+
+// reader for an arrow ipc stream - the schema and record batch messages are walked in place
+// and each column is handed back as slices of the input (validity, offsets, data) so the
+// driver can bind them without a js value per cell. only flat columns are understood, nested,
+// dictionary and compressed batches are refused.
+
+const CONTINUATION = 0xffffffff
+
+const MessageHeader = Object.freeze({
+  Schema: 1,
+  DictionaryBatch: 2,
+  RecordBatch: 3
+})
+
+const TypeId = Object.freeze({
+  Null: 1,
+  Int: 2,
+  FloatingPoint: 3,
+  Binary: 4,
+  Utf8: 5,
+  Bool: 6,
+  Date: 8,
+  Timestamp: 10
+})
+
+const timeUnits = ['s', 'ms', 'us', 'ns']
+
+// minimal flatbuffer table access - a table starts with the signed offset back to its
+// vtable, which lists the position of each field relative to the table or 0 if absent.
+class Table {
+  constructor (view, pos) {
+    this.view = view
+    this.pos = pos
+    this.vtable = pos - view.getInt32(pos, true)
+    this.vtableSize = view.getUint16(this.vtable, true)
+  }
+
+  static root (view, pos) {
+    return new Table(view, pos + view.getUint32(pos, true))
+  }
+
+  field (i) {
+    const at = 4 + i * 2
+    if (at >= this.vtableSize) return 0
+    const off = this.view.getUint16(this.vtable + at, true)
+    return off ? this.pos + off : 0
+  }
+
+  uint8 (i, def) {
+    const at = this.field(i)
+    return at ? this.view.getUint8(at) : def
+  }
+
+  int16 (i, def) {
+    const at = this.field(i)
+    return at ? this.view.getInt16(at, true) : def
+  }
+
+  int32 (i, def) {
+    const at = this.field(i)
+    return at ? this.view.getInt32(at, true) : def
+  }
+
+  int64 (i, def) {
+    const at = this.field(i)
+    return at ? Number(this.view.getBigInt64(at, true)) : def
+  }
+
+  indirect (i) {
+    const at = this.field(i)
+    return at ? at + this.view.getUint32(at, true) : 0
+  }
+
+  table (i) {
+    const at = this.indirect(i)
+    return at ? new Table(this.view, at) : null
+  }
+
+  string (i) {
+    const at = this.indirect(i)
+    if (!at) return null
+    const len = this.view.getUint32(at, true)
+    return Buffer.from(this.view.buffer, this.view.byteOffset + at + 4, len).toString('utf8')
+  }
+
+  vectorLength (i) {
+    const at = this.indirect(i)
+    return at ? this.view.getUint32(at, true) : 0
+  }
+
+  vectorTable (i, j) {
+    const at = this.indirect(i) + 4 + j * 4
+    return new Table(this.view, at + this.view.getUint32(at, true))
+  }
+
+  vectorStruct (i, j, size) {
+    return this.indirect(i) + 4 + j * size
+  }
+}
+
+function fieldType (field) {
+  const typeId = field.uint8(2, 0)
+  const type = field.table(3)
+  switch (typeId) {
+    case TypeId.Null:
+      return { type: 'null', buffers: 0 }
+    case TypeId.Int: {
+      const bitWidth = type.int32(0, 0)
+      const signed = type.uint8(1, 0) !== 0
+      if (!signed) break
+      return { type: `int${bitWidth}`, buffers: 2 }
+    }
+    case TypeId.FloatingPoint: {
+      const precision = type.int16(0, 0)
+      if (precision === 1) return { type: 'float32', buffers: 2 }
+      if (precision === 2) return { type: 'float64', buffers: 2 }
+      break
+    }
+    case TypeId.Binary:
+      return { type: 'binary', buffers: 3 }
+    case TypeId.Utf8:
+      return { type: 'utf8', buffers: 3 }
+    case TypeId.Bool:
+      return { type: 'bool', buffers: 2 }
+    case TypeId.Date:
+      return { type: type.int16(0, 1) === 0 ? 'date32' : 'date64', buffers: 2 }
+    case TypeId.Timestamp:
+      return { type: 'timestamp', unit: timeUnits[type.int16(0, 0)], buffers: 2 }
+  }
+  return null
+}
+
+function readSchema (header) {
+  const count = header.vectorLength(1)
+  const fields = []
+  for (let i = 0; i < count; ++i) {
+    const field = header.vectorTable(1, i)
+    const name = field.string(0)
+    if (field.field(4)) {
+      throw new Error(`arrow: column ${name} is dictionary encoded`)
+    }
+    const type = fieldType(field)
+    if (!type || field.vectorLength(5) > 0) {
+      throw new Error(`arrow: column ${name} has an unsupported type`)
+    }
+    fields.push({ name, nullable: field.uint8(1, 0) !== 0, ...type })
+  }
+  return fields
+}
+
+function readRecordBatch (header, fields, body) {
+  if (header.field(3)) {
+    throw new Error('arrow: compressed record batches are not supported')
+  }
+  const view = header.view
+  const length = header.int64(0, 0)
+  const slice = i => {
+    const at = header.vectorStruct(2, i, 16)
+    const offset = Number(view.getBigInt64(at, true))
+    const len = Number(view.getBigInt64(at + 8, true))
+    return len > 0 ? body.subarray(offset, offset + len) : null
+  }
+  let buffer = 0
+  const columns = fields.map((f, i) => {
+    const at = header.vectorStruct(1, i, 16)
+    const column = {
+      type: f.type,
+      unit: f.unit,
+      length: Number(view.getBigInt64(at, true)),
+      nullCount: Number(view.getBigInt64(at + 8, true)),
+      validity: null,
+      offsets: null,
+      data: null
+    }
+    if (f.buffers > 0) {
+      column.validity = column.nullCount > 0 ? slice(buffer) : null
+      if (f.buffers === 3) column.offsets = slice(buffer + 1)
+      column.data = slice(buffer + f.buffers - 1)
+    }
+    buffer += f.buffers
+    return column
+  })
+  return { length, columns }
+}
+
+// returns { fields, batches } where each batch is { length, columns } in field order.
+function readArrowStream (input) {
+  const buffer = Buffer.isBuffer(input)
+    ? input
+    : Buffer.from(input.buffer, input.byteOffset, input.byteLength)
+  const view = new DataView(buffer.buffer, buffer.byteOffset, buffer.byteLength)
+  let pos = 0
+  let fields = null
+  const batches = []
+  while (pos + 4 <= buffer.length) {
+    let size = view.getUint32(pos, true)
+    pos += 4
+    if (size === CONTINUATION) {
+      if (pos + 4 > buffer.length) break
+      size = view.getUint32(pos, true)
+      pos += 4
+    }
+    if (size === 0) break
+    const message = Table.root(view, pos)
+    const headerType = message.uint8(1, 0)
+    const header = message.table(2)
+    const bodyLength = message.int64(3, 0)
+    pos += size
+    const body = buffer.subarray(pos, pos + bodyLength)
+    pos += bodyLength
+    switch (headerType) {
+      case MessageHeader.Schema:
+        fields = readSchema(header)
+        break
+      case MessageHeader.RecordBatch:
+        if (!fields) throw new Error('arrow: record batch before schema')
+        batches.push(readRecordBatch(header, fields, body))
+        break
+      case MessageHeader.DictionaryBatch:
+        throw new Error('arrow: dictionary batches are not supported')
+      default:
+        throw new Error(`arrow: unknown message type ${headerType}`)
+    }
+  }
+  if (!fields) throw new Error('arrow: stream has no schema')
+  return { fields, batches }
+}
+
+module.exports = {
+  readArrowStream
+}
@@ -0,0 +1,153 @@
+'use strict'
+
+// reader over the column major batches produced natively by ReadColumnarOperation - see
+// src/Columnar.h for the layout. nothing is decoded until asked for, so a view can be posted
+// to a worker (the SharedArrayBuffer form is not copied) and only the cells read there cost.
+
+const MAGIC = 0x4c43534d
+const VERSION = 1
+const HEADER_SIZE = 16
+const DESCRIPTOR_SIZE = 16
+
+const Kind = Object.freeze({
+  Null: 0,
+  Number: 1,
+  Boolean: 2,
+  Date: 3,
+  Utf16: 4,
+  Utf8: 5,
+  Binary: 6
+})
+
+class ColumnarView {
+  // meta is optional - names are only needed for objects(); a worker can be handed
+  // the buffer alone and still read rows positionally.
+  constructor (buffer, meta) {
+    this.buffer = buffer
+    this.meta = meta || null
+    const header = new DataView(buffer, 0, HEADER_SIZE)
+    if (header.getUint32(0, true) !== MAGIC) {
+      throw new Error('columnar: buffer is not a columnar batch')
+    }
+    const version = header.getUint32(4, true)
+    if (version !== VERSION) {
+      throw new Error(`columnar: unsupported version ${version}`)
+    }
+    this.rowCount = header.getUint32(8, true)
+    this.columnCount = header.getUint32(12, true)
+    this.columns = []
+    const descriptors = new DataView(buffer, HEADER_SIZE, this.columnCount * DESCRIPTOR_SIZE)
+    for (let c = 0; c < this.columnCount; ++c) {
+      const at = c * DESCRIPTOR_SIZE
+      const kind = descriptors.getUint8(at)
+      const nulls = new Uint8Array(buffer, descriptors.getUint32(at + 4, true), this.rowCount)
+      const dataOffset = descriptors.getUint32(at + 8, true)
+      let values = null
+      let offsets = null
+      switch (kind) {
+        case Kind.Number:
+        case Kind.Boolean:
+        case Kind.Date:
+          values = new Float64Array(buffer, dataOffset, this.rowCount)
+          break
+        case Kind.Utf16:
+        case Kind.Utf8:
+        case Kind.Binary:
+          offsets = new Uint32Array(buffer, dataOffset, this.rowCount + 1)
+          break
+      }
+      this.columns.push({
+        kind,
+        nulls,
+        values,
+        offsets,
+        arena: descriptors.getUint32(at + 12, true)
+      })
+    }
+  }
+
+  isNull (row, col) {
+    return this.columns[col].nulls[row] !== 0
+  }
+
+  cell (row, col) {
+    const column = this.columns[col]
+    if (column.nulls[row] !== 0) return null
+    switch (column.kind) {
+      case Kind.Number:
+        return column.values[row]
+      case Kind.Boolean:
+        return column.values[row] !== 0
+      case Kind.Date:
+        return new Date(column.values[row])
+      case Kind.Utf16:
+        return this.bytes(column, row).toString('utf16le')
+      case Kind.Utf8:
+        return this.bytes(column, row).toString('utf8')
+      case Kind.Binary:
+        return this.bytes(column, row)
+      default:
+        return null
+    }
+  }
+
+  bytes (column, row) {
+    const start = column.offsets[row]
+    const end = column.offsets[row + 1]
+    return Buffer.from(this.buffer, column.arena + start, end - start)
+  }
+
+  // the raw f64 lane for a Number, Boolean or Date column - null cells read as 0,
+  // check isNull when that matters.
+  values (col) {
+    return this.columns[col].values
+  }
+
+  column (col) {
+    const res = new Array(this.rowCount)
+    for (let r = 0; r < this.rowCount; ++r) {
+      res[r] = this.cell(r, col)
+    }
+    return res
+  }
+
+  row (r) {
+    const res = new Array(this.columnCount)
+    for (let c = 0; c < this.columnCount; ++c) {
+      res[c] = this.cell(r, c)
+    }
+    return res
+  }
+
+  rows () {
+    const res = new Array(this.rowCount)
+    for (let r = 0; r < this.rowCount; ++r) {
+      res[r] = this.row(r)
+    }
+    return res
+  }
+
+  objects () {
+    if (!this.meta) {
+      throw new Error('columnar: objects() needs the result metadata')
+    }
+    const res = new Array(this.rowCount)
+    for (let r = 0; r < this.rowCount; ++r) {
+      const o = {}
+      for (let c = 0; c < this.columnCount; ++c) {
+        o[this.meta[c].name] = this.cell(r, c)
+      }
+      res[r] = o
+    }
+    return res
+  }
+
+  * [Symbol.iterator] () {
+    for (let r = 0; r < this.rowCount; ++r) {
+      yield this.row(r)
+    }
+  }
+}
+
+exports.ColumnarView = ColumnarView
+exports.ColumnarKind = Kind
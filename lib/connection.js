@@ -12,6 +12,8 @@ const { tableModule } = require('./table')
 const { utilModule } = require('./util')
 const { BasePromises } = require('./base-promises')
 const { PreparedStatement } = require('./prepared-statement')
+const { RowBatchStream, defaultBatchRows } = require('./row-stream')
+const { QueryBatch } = require('./query-batch')
 const cppDriver = new utilModule.Native().cppDriver
 
 class PrivateConnection {
@@ -58,6 +60,13 @@ class PrivateConnection {
     this.native.open(this.connectObj, (e, c) => { this.queueCb(e, c) })
   }
 
+  // wrap a connection already opened by the native pool in the given slot
+  adopt (pool, slot) {
+    this.callback2 = this.callback2 || this.defaultCallback
+    const adopted = this.native.adopt(pool, slot)
+    this.queueCb(adopted ? null : new Error(`no open connection in pool slot ${slot}`))
+  }
+
   decodeSqlServerVersion (connectionString) {
     const myRegexp = /Driver=\{ODBC Driver (.*?) for SQL Server}.*$/g
     const match = myRegexp.exec(connectionString)
@@ -87,6 +96,10 @@ class ConnectionWrapperPromises extends BasePromises {
     return this.op(cb => this.tm.getTable(name, cb))
   }
 
+  async bulkInsertArrow (table, ipcBuffer) {
+    return this.op(cb => this.connection.bulkInsertArrow(table, ipcBuffer, cb))
+  }
+
   async getProc (name) {
     return this.op(cb => this.pm.getProc(name, cb))
   }
@@ -132,7 +145,11 @@ class ConnectionWrapper {
     this.useUTC = true
     this.driverVersion = 0
     this.maxPreparedColumnSize = null
+    this.maxInternedStrings = 0
+    this.queryDeadlineMs = 0
+    this.prefetchDepth = 0
     this.useNumericString = false
+    this.useUTF8Data = false
     this.procedureCache = null
     this.tableCache = null
     this.tables = new tableModule.TableMgr(this, sqlMeta, userTypes, this.tableCache)
@@ -161,6 +178,40 @@ class ConnectionWrapper {
     this.maxPreparedColumnSize = m
   }
 
+  getMaxInternedStrings () {
+    return this.maxInternedStrings
+  }
+
+  setMaxInternedStrings (m) {
+    this.maxInternedStrings = m
+  }
+
+  getQueryDeadlineMs () {
+    return this.queryDeadlineMs
+  }
+
+  setQueryDeadlineMs (ms) {
+    this.queryDeadlineMs = ms
+  }
+
+  getPrefetchDepth () {
+    return this.prefetchDepth
+  }
+
+  setPrefetchDepth (depth) {
+    this.prefetchDepth = depth
+  }
+
+  // up to depth queries in flight at once, each on its own statement - the connection
+  // string must turn on MARS (MultipleActiveResultSets=yes) or the server refuses the second.
+  getPipelineDepth () {
+    return this.driverMgr.getPipelineDepth()
+  }
+
+  setPipelineDepth (depth) {
+    this.driverMgr.setPipelineDepth(depth)
+  }
+
   getUseUTC () {
     return this.useUTC
   }
@@ -189,6 +240,14 @@ class ConnectionWrapper {
     this.useNumericString = uns
   }
 
+  getUseUTF8Data () {
+    return this.useUTF8Data
+  }
+
+  setUseUTF8Data (utf8) {
+    this.useUTF8Data = utf8
+  }
+
   procedureMgr () {
     return this.procedures
   }
@@ -197,6 +256,11 @@ class ConnectionWrapper {
     return this.dead
   }
 
+  // latency histograms per native operation and the fetch counters, since open.
+  getStats () {
+    return this.driverMgr.getStats()
+  }
+
   close (immediately, callback) {
     if (this.dead) {
       return
@@ -220,11 +284,34 @@ class ConnectionWrapper {
     })
   }
 
-  queryRawNotify (notify, queryOrObj, chunky) {
-    const queryObj = this.notifier.validateQuery(queryOrObj, this.useUTC, 'queryRaw')
+  // the connection's defaults for whatever the query object leaves unset.
+  queryDefaults (queryObj) {
     if (!Object.hasOwnProperty.call(queryObj, 'numeric_string')) {
       queryObj.numeric_string = this.useNumericString
     }
+    if (!Object.hasOwnProperty.call(queryObj, 'utf8_data')) {
+      queryObj.utf8_data = this.useUTF8Data
+    }
+    if (!Object.hasOwnProperty.call(queryObj, 'max_interned_strings')) {
+      if (this.maxInternedStrings) {
+        queryObj.max_interned_strings = this.maxInternedStrings
+      }
+    }
+    if (!Object.hasOwnProperty.call(queryObj, 'query_deadline_ms')) {
+      if (this.queryDeadlineMs) {
+        queryObj.query_deadline_ms = this.queryDeadlineMs
+      }
+    }
+    if (!Object.hasOwnProperty.call(queryObj, 'prefetch_depth')) {
+      if (this.prefetchDepth) {
+        queryObj.prefetch_depth = this.prefetchDepth
+      }
+    }
+    return queryObj
+  }
+
+  queryRawNotify (notify, queryOrObj, chunky) {
+    const queryObj = this.queryDefaults(this.notifier.validateQuery(queryOrObj, this.useUTC, 'queryRaw'))
     this.driverMgr.readAllQuery(notify, queryObj, chunky.params, chunky.callback)
   }
 
@@ -290,6 +377,31 @@ class ConnectionWrapper {
     return notify
   }
 
+  // for await (const batch of conn.queryStream(sql, params)) - rows arrive as arrays a
+  // batch at a time and the next batch is only read as the previous one is taken.
+  queryStream (queryOrObj, params, options) {
+    options = options || {}
+    const queryObj = Object.assign({}, this.notifier.getQueryObject(queryOrObj))
+    if (!(queryObj.row_batches > 0)) {
+      queryObj.row_batches = options.batchRows || defaultBatchRows
+    }
+    const q = this.queryRaw(queryObj, params || [])
+    return new RowBatchStream(q, options)
+  }
+
+  batchQueryObject (sql) {
+    return this.queryDefaults(this.notifier.validateQuery(sql, this.useUTC, 'batch'))
+  }
+
+  // [{ sql, params }, ...] run one after another in a single native operation - returns a
+  // promise per statement, each settling with that statement's own results.
+  batch (entries, options) {
+    if (this.dead) {
+      throw new Error('[msnodesql] Connection is closed.')
+    }
+    return new QueryBatch(this, entries, options).submit()
+  }
+
   beginTransaction (callback) {
     if (this.dead) {
       throw new Error('[msnodesql] Connection is closed.')
@@ -303,21 +415,11 @@ class ConnectionWrapper {
       throw new Error('[msnodesql] Connection is closed.')
     }
 
-    const qo = notify.getQueryObj()
-    const polling = qo.query_polling || false
     callback = callback || this.defaultCallback
-    const paused = notify.isPaused()
-    const canCancel = paused || polling
-    if (!canCancel) {
-      setImmediate(() => {
-        callback(new Error('Error: [msnodesql] cancel only supported for statements where polling is enabled.'))
-      })
-    } else {
-      this.driverMgr.cancel(notify, (e) => {
-        notify.emit('done')
-        callback(e, null)
-      })
-    }
+    this.driverMgr.cancel(notify, (e) => {
+      notify.emit('done')
+      callback(e, null)
+    })
   }
 
   commit (callback) {
@@ -346,6 +448,11 @@ class ConnectionWrapper {
     notify.setPrepared()
     const chunky = this.notifier.getChunkyArgs(callback)
     const queryObj = this.notifier.validateQuery(queryOrObj, this.useUTC, 'prepare')
+    // a prepared statement binds its columns as wide buffers up front, so there is no
+    // utf8 read to switch to.
+    if (queryObj.utf8_data) {
+      throw new Error('[msnodesql] utf8_data is not supported on a prepared statement.')
+    }
 
     if (!Object.hasOwnProperty.call(queryObj, 'numeric_string')) {
       queryObj.numeric_string = this.useNumericString
@@ -374,6 +481,23 @@ class ConnectionWrapper {
     this.tables.getTable(name, cb)
   }
 
+  // table is a name or a bulk manager from getTable (e.g. with setUseBcp) - the stream
+  // is inserted one record batch at a time, see TableBulkOpMgr.insertArrow.
+  bulkInsertArrow (table, ipcBuffer, cb) {
+    cb = cb || this.defaultCallback
+    if (typeof table !== 'string') {
+      table.insertArrow(ipcBuffer, cb)
+      return
+    }
+    this.tables.getTable(table, (err, bulk) => {
+      if (err) {
+        cb(err, null)
+        return
+      }
+      bulk.insertArrow(ipcBuffer, cb)
+    })
+  }
+
   // returns a promise of aggregated results not a query
   async callprocAggregator (name, params, options) {
     return this.promises.callProc(name, params, options)
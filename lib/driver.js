@@ -30,6 +30,20 @@ const driverModule = ((() => {
       this.reader.setUseUTC(utc)
     }
 
+    // queries each have a statement of their own, so with MARS on the session they can
+    // be in flight together - transactions, prepare and close still run alone.
+    setPipelineDepth (depth) {
+      this.workQueue.setDepth(depth)
+    }
+
+    getPipelineDepth () {
+      return this.workQueue.getDepth()
+    }
+
+    getStats () {
+      return this.cppDriver.getStats()
+    }
+
     emptyQueue () {
       this.workQueue.emptyQueue()
     }
@@ -56,13 +70,10 @@ const driverModule = ((() => {
       // send cancel directly to driver.
       const args = queueItem.args
       const cb = args[3]
-      const peek = this.workQueue.peek()
 
-      if (queueItem.operationId === peek.operationId) {
-        this.cppDriver.pollingMode(qid, true, () => {
-          this.cppDriver.cancelQuery(qid, (e) => {
-            this.forwardCancel(e, callback)
-          })
+      if (this.workQueue.isLive(queueItem)) {
+        this.cppDriver.cancelQuery(qid, (e) => {
+          this.forwardCancel(e, callback)
         })
       } else {
         this.workQueue.dropItem(queueItem)
@@ -162,12 +173,12 @@ const driverModule = ((() => {
         : []
     }
 
-    raiseFree (queryId, notify, callback) {
+    raiseFree (queryId, notify, callback, op) {
       setImmediate(() => {
         callback(null, queryId)
         setImmediate(() => {
           notify.emit('free', queryId)
-          this.workQueue.nextOp()
+          this.workQueue.nextOp(op)
         })
       })
     }
@@ -175,12 +186,12 @@ const driverModule = ((() => {
     freeStatement (notify, callback) {
       const queryId = notify.getQueryId()
       if (queryId >= 0) {
-        this.workQueue.enqueue(driverCommandEnum.FREE_STATEMENT, () => {
+        const op = this.workQueue.enqueue(driverCommandEnum.FREE_STATEMENT, () => {
           this.cppDriver.freeStatement(queryId,
-            () => { this.raiseFree(queryId, notify, callback) })
-        }, [])
+            () => { this.raiseFree(queryId, notify, callback, op) })
+        }, [], true)
       } else {
-        this.raiseFree(queryId, notify, callback)
+        this.raiseFree(queryId, notify, callback, notify.getOperation())
       }
     }
 
@@ -202,42 +213,59 @@ const driverModule = ((() => {
     // only be unbound when rest of query completes. The output params
     // will now be ready to fetch out of the statement.
 
-    next (callback, err) {
+    // op is the item completing, with MARS on the head of the queue may be another.
+    next (callback, err, op) {
       setImmediate(() => {
         callback(err || null, false)
         setImmediate(() => {
-          this.workQueue.nextOp()
+          this.workQueue.nextOp(op)
         })
       })
     }
 
     beginTransaction (callback) {
-      this.workQueue.enqueue(driverCommandEnum.BEGIN_TRANSACTION, () => {
-        this.cppDriver.beginTransaction(err => { this.next(callback, err) })
+      const op = this.workQueue.enqueue(driverCommandEnum.BEGIN_TRANSACTION, () => {
+        this.cppDriver.beginTransaction(err => { this.next(callback, err, op) })
       }, [])
     }
 
     rollback (callback) {
-      this.workQueue.enqueue(driverCommandEnum.ROLLBACK, () => {
-        this.cppDriver.rollback(err => { this.next(callback, err) })
+      const op = this.workQueue.enqueue(driverCommandEnum.ROLLBACK, () => {
+        this.cppDriver.rollback(err => { this.next(callback, err, op) })
       }, [])
     }
 
     commit (callback) {
-      this.workQueue.enqueue(driverCommandEnum.COMMIT, () => {
-        this.cppDriver.commit(err => { this.next(callback, err) })
+      const op = this.workQueue.enqueue(driverCommandEnum.COMMIT, () => {
+        this.cppDriver.commit(err => { this.next(callback, err, op) })
       }, [])
     }
 
     prepare (notify, queryOrObj, callback) {
-      this.workQueue.enqueue(driverCommandEnum.PREPARE, () => {
+      // the statement keeps the date handling it was prepared with
+      queryOrObj.local_dates = this.reader.useUTC === false
+      const op = this.workQueue.enqueue(driverCommandEnum.PREPARE, () => {
         this.cppDriver.prepare(notify.getQueryId(), queryOrObj, (err, meta) => {
           callback(err, meta)
-          this.workQueue.nextOp()
+          this.workQueue.nextOp(op)
         })
       }, [])
     }
 
+    // the whole batch is one operation on one statement, which is freed once every entry
+    // has run and been read.
+    queryBatch (notify, entries, callback) {
+      entries.forEach(e => { e.query.local_dates = this.reader.useUTC === false })
+      notify.setOperation(this.workQueue.enqueue(driverCommandEnum.QUERY, () => {
+        this.cppDriver.queryBatch(notify.getQueryId(), entries, (err, res) => {
+          this.workQueue.nextOp(notify.getOperation())
+          this.freeStatement(notify, () => {
+            callback(err || null, res)
+          })
+        })
+      }, [], true))
+    }
+
     readOperation (notify, queryObj, params, factory, cb) {
       notify.setOperation(this.workQueue.enqueue(driverCommandEnum.QUERY,
         (notify, query, params, callback) => {
@@ -246,7 +274,7 @@ const driverModule = ((() => {
             notify.setQueryWorker(q)
             q.begin()
           })
-        }, [notify, queryObj, params, cb]))
+        }, [notify, queryObj, params, cb], true))
     }
 
     readAllPrepared (notify, queryObj, params, cb) {
@@ -265,6 +293,8 @@ const driverModule = ((() => {
     }
 
     headPaused (notify, queryObj, params, cb) {
+      // a paused query keeps its statement, with MARS on the next can run beside it
+      if (this.workQueue.pipelined()) return false
       const peek = this.workQueue.peek()
       const paused = peek?.paused
       if (paused) {
@@ -2,7 +2,7 @@ declare namespace MsNodeSqlV8 {
   export type sqlJsColumnType = string | boolean | Date | number | Buffer
   export type sqlRecordType = Record<string | number, sqlJsColumnType>
   export type sqlObjectType = sqlRecordType | object | any
-  export type sqlQueryParamType = sqlJsColumnType | sqlJsColumnType[] | ConcreteColumnType | ConcreteColumnType[] | TvpParam
+  export type sqlQueryParamType = sqlJsColumnType | sqlJsColumnType[] | ConcreteColumnType | ConcreteColumnType[] | TvpParam | BindRowsParam
   export type sqlPoolEventType = MessageCb | PoolStatusRecordCb | PoolOptionsEventCb | StatusCb
   export type sqlQueryEventType = SubmittedEventCb | ColumnEventCb | EventColumnCb | StatusCb | RowEventCb | MetaEventCb | RowCountEventCb
   export type sqlProcParamType = sqlObjectType | sqlQueryParamType
@@ -154,11 +154,18 @@ declare namespace MsNodeSqlV8 {
      */
     ceiling?: number
     /**
-     * during no activity a heartbeat is sent every interval to check connection
+     * during no activity idle connections are checked every interval - heartbeatSql is
+     * sent and the driver asked whether the link is dead
      */
     heartbeatSecs?: number
     /**
-     * override the sql used to test the connection
+     * send heartbeatSql on each check (Default true). the driver's dead flag only reflects
+     * what it has already seen, so with this off a link dropped silently is neither found
+     * nor kept alive until a query fails on it.
+     */
+    heartbeatProbe?: boolean
+    /**
+     * override the sql used to test the connection when heartbeatProbe is set
      */
     heartbeatSql?: string
     /**
@@ -173,10 +180,43 @@ declare namespace MsNodeSqlV8 {
      * avoid bigint overflow return string
      */
     useNumericString?: boolean
+    /**
+     * fetch char/varchar columns as UTF-8 rather than UTF-16 (UTF-8 collations, not windows)
+     */
+    useUTF8Data?: boolean
     /**
      * nvarchar(max) prepared columns must be constrained (Default 8k)
      */
     maxPreparedColumnSize?: number
+    /**
+     * share repeated string values within a result set, giving up on a
+     * column once it holds more than this many distinct values (Default 0 off)
+     */
+    maxInternedStrings?: number
+    /**
+     * default deadline in ms given to every query on each pooled connection (Default 0 off)
+     */
+    queryDeadlineMs?: number
+    /**
+     * default row batches read ahead for each query on a pooled connection (Default 0 off)
+     */
+    prefetchDepth?: number
+    /**
+     * queries in flight at once on each pooled connection, work is shared onto busy
+     * connections once none is idle - needs MultipleActiveResultSets=yes (Default 0 off)
+     */
+    pipelineDepth?: number
+    /**
+     * promises.query given { read: true } joins an identical read (same sql and params)
+     * already in flight rather than running again - every waiter gets the same frozen
+     * results (Default false)
+     */
+    coalesceReads?: boolean
+    /**
+     * bytes of native memory for the cache of promises.query results given a ttlMs -
+     * least recently used entries are evicted past this bound (Default 0 off)
+     */
+    resultCacheBytes?: number
     /**
      * the connection string used for each connection opened in pool
      */
@@ -229,6 +269,15 @@ declare namespace MsNodeSqlV8 {
      * each result set either as array of arrays or array of objects with column names as properties
      */
     results: sqlColumnResultsType[][]
+    /**
+     * per result set, the batches read when the query was submitted with columnar set
+     */
+    columnar: ColumnarView[][]
+    /**
+     * per result set, the Arrow IPC bytes read when the query was submitted with columnar
+     * 'arrow' - Buffer.concat of one result set's list is a complete IPC stream.
+     */
+    arrow: Buffer[][]
     /**
      * output params if any from a proc call
      */
@@ -282,6 +331,22 @@ declare namespace MsNodeSqlV8 {
      * replace meta empty col name with Column0, Column1
      */
     replaceEmptyColumnNames?: boolean
+    /**
+     * the query only reads - on a pool with coalesceReads it may share the results of
+     * an identical query already running.
+     */
+    read?: boolean
+    /**
+     * on a pool with resultCacheBytes, keep the results for this long and answer the
+     * same sql and params from the cache until then. sql is read uncached the first time it
+     * is seen, to learn its columns - sql returning a date or time column is never cached,
+     * the cached form would lose the nanoseconds.
+     */
+    ttlMs?: number
+    /**
+     * tags a cached result is stored with e.g. the tables read, see pool.invalidateTag.
+     */
+    tags?: string[]
   }
 
   export interface PoolPromises extends AggregatorPromises {
@@ -332,6 +397,21 @@ declare namespace MsNodeSqlV8 {
     query (sqlOrQuery: sqlQueryType, paramsOrCb?: sqlQueryParamType[] | QueryCb, cb?: QueryCb): Query
     queryRaw (sqlOrQuery: sqlQueryType, paramsOrCb?: sqlQueryParamType[] | QueryRawCb, cb?: QueryRawCb): Query
     isClosed (): boolean
+    /**
+     * native latency histograms and fetch counters summed over every connection
+     * the pool has held, plus the current pool occupancy.
+     */
+    getStats (): PoolStats
+    /**
+     * drop the cached result of a query by the sql and params it was read with.
+     * @returns true if an entry was dropped
+     */
+    invalidate (sqlOrQuery: sqlQueryType, params?: sqlQueryParamType[]): boolean
+    /**
+     * drop every cached result stored with the tag.
+     * @returns the number of entries dropped
+     */
+    invalidateTag (tag: string): number
     /**
      * event subscription
      * e.g. pool.on('debug', msg => { console.log(msg) })
@@ -619,6 +699,12 @@ declare namespace MsNodeSqlV8 {
   export interface ConnectionPromises extends AggregatorPromises {
     prepare: (sql: sqlQueryType) => Promise<PreparedStatement>
     getTable: (name: string) => Promise<BulkTableMgr>
+    /**
+     * insert the rows of an arrow ipc stream into a table, one insert per record batch.
+     * @param table - table name or a bulk manager from getTable e.g. with bcp on.
+     * @param ipcBuffer - arrow ipc stream format (schema, record batches, end marker).
+     */
+    bulkInsertArrow: (table: string | BulkTableMgr, ipcBuffer: Buffer | Uint8Array) => Promise<any[]>
     getProc: (name: string) => Promise<ProcedureDefinition>
     getUserTypeTable: (name: string) => Promise<Table>
     /**
@@ -681,6 +767,63 @@ declare namespace MsNodeSqlV8 {
      * @returns flag for numeric to string.
      */
     getUseNumericString: () => boolean
+    /**
+     * fetch char, varchar and varchar(max) columns from the driver as
+     * UTF-8 bytes rather than UTF-16. Intended for tables using a _UTF8
+     * collation, where it avoids a transcode in the driver. ignored on windows,
+     * where the driver's narrow encoding is the ANSI code page. applies to queries
+     * and procedure calls, prepared statements always read UTF-16.
+     * @param utf8 boolean true to fetch narrow columns as UTF-8.
+     */
+    setUseUTF8Data: (utf8: boolean) => void
+    /**
+     * returns flag to indicate if narrow columns are fetched as UTF-8
+     * @returns flag for UTF-8 fetch.
+     */
+    getUseUTF8Data: () => boolean
+    /**
+     * intern repeated string values per result set so low cardinality
+     * columns (status, country ...) share one native buffer and one JS
+     * string. A column with more distinct values than the cap is read as
+     * normal. 0 switches interning off.
+     * @param m max distinct values cached per column.
+     */
+    setMaxInternedStrings: (m: number) => void
+    /**
+     * @returns max distinct values cached per column, 0 when off.
+     */
+    getMaxInternedStrings: () => number
+    /**
+     * cancel any query still running this many ms after it was submitted,
+     * failing it with 'Query timeout expired'. Unlike query_timeout this
+     * includes the time spent fetching rows. 0 switches it off.
+     * @param ms default deadline given to each query without its own.
+     */
+    setQueryDeadlineMs: (ms: number) => void
+    /**
+     * @returns default query deadline in ms, 0 when off.
+     */
+    getQueryDeadlineMs: () => number
+    /**
+     * read ahead on the driver thread, see prefetch_depth on the query.
+     * @param depth default number of batches prefetched, 0 is off.
+     */
+    setPrefetchDepth: (depth: number) => void
+    /**
+     * @returns default prefetch depth, 0 when off.
+     */
+    getPrefetchDepth: () => number
+    /**
+     * run up to depth queries concurrently on their own statements. the connection
+     * string must have MultipleActiveResultSets=yes. transactions, prepare and close
+     * still wait for everything ahead of them and run alone.
+     * @param depth queries in flight at once, 1 (the default) runs one at a time.
+     */
+    setPipelineDepth: (depth: number) => void
+    /**
+     * @returns queries allowed in flight at once, 1 when pipelining is off.
+     */
+    getPipelineDepth: () => number
     /**
      * set max length of prepared strings or binary columns. Note this
      * will not work for a connection with always on encryption enabled
@@ -721,12 +864,94 @@ declare namespace MsNodeSqlV8 {
     setFilterNonCriticalErrors: (flag: boolean) => void
     callproc: (name: string, params?: sqlProcParamType[], cb?: CallProcedureCb) => Query
     getTable: (tableName: string, cb: GetTableCb) => void
+    /**
+     * insert the rows of an arrow ipc stream into a table - each table column is matched
+     * by name to a field of the stream and bound from the arrow buffers, no js value is
+     * made per cell.
+     */
+    bulkInsertArrow: (table: string | BulkTableMgr, ipcBuffer: Buffer | Uint8Array, cb?: StatusCb) => void
     callprocAggregator: (name: string, params?: sqlProcParamType, optons?: QueryAggregatorOptions) => Promise<QueryAggregatorResults>
     /**
      * flag indicating if connection is closed and hence can no longer be used
      * for queries.
      */
     isClosed: () => boolean
+    /**
+     * latency histograms per native operation and fetch counters since the
+     * connection opened - a synchronous snapshot.
+     */
+    getStats: () => DriverStats
+    /**
+     * iterate a query a batch of rows at a time - for await (const b of conn.queryStream(sql)).
+     * no 'row' or 'column' events are raised and the next batch is only read from the
+     * driver as earlier ones are taken. leaving the loop early cancels the query.
+     * @param sqlOrQuery the textual query to submit
+     * @param params optional bound parameters
+     * @param options rows per batch and how many batches may wait unread
+     */
+    queryStream: (sqlOrQuery: sqlQueryType, params?: sqlQueryParamType[], options?: QueryStreamOptions) => RowBatchStream
+    /**
+     * send independent statements to the server as one batch in a single round trip, each
+     * wrapped in its own sp_executesql so a failure or declaration in one does not reach
+     * another. a promise per statement settles with that statement's own results.
+     * @param entries the statements with their own scalar input parameters, or plain sql strings
+     * @param options raw for rows as arrays rather than objects
+     */
+    batch: (entries: (string | BatchEntry)[], options?: BatchOptions) => Promise<BatchResult>[]
+  }
+
+  export interface BatchEntry {
+    sql: string
+    params?: sqlQueryParamType[]
+  }
+
+  export interface BatchOptions {
+    raw?: boolean
+  }
+
+  export interface BatchResult {
+    /**
+     * rows of the first result set of the statement or null if it has none.
+     */
+    first: any[] | null
+    meta: Meta[][]
+    results: any[][]
+    counts: number[]
+    /**
+     * info messages raised by the statement e.g. by print.
+     */
+    info: string[]
+  }
+
+  export interface QueryStreamOptions {
+    /**
+     * rows read from the driver per batch, default 1000 - ignored when the
+     * query itself gives row_batches.
+     */
+    batchRows?: number
+    /**
+     * batches held unread before the query is paused, default 1.
+     */
+    highWaterMark?: number
+  }
+
+  export interface RowBatch {
+    /**
+     * columns of the result set the rows belong to.
+     */
+    meta: Meta[]
+    /**
+     * 0 for the first result set, incremented for each that follows.
+     */
+    resultId: number
+    /**
+     * each row an array of values indexed as meta.
+     */
+    rows: sqlJsColumnType[][]
+  }
+
+  export interface RowBatchStream extends AsyncIterableIterator<RowBatch> {
+    meta: Meta[] | null
   }
 
   export interface QueryPromises {
@@ -762,7 +987,20 @@ declare namespace MsNodeSqlV8 {
      *  meta array previously returned.
      *
      *
+     * 'columnar' - a ColumnarView holding a whole batch, raised in place of 'row' and 'column'
+     *  when the query was submitted with columnar set.
+     *
+     *
+     * 'arrow' - a Buffer of Arrow IPC stream messages holding a whole batch, raised in place
+     *  of 'row' and 'column' when the query was submitted with columnar 'arrow'.
+     *
+     *
+     * 'batch' - an array of rows, each an array of values, raised in place of 'row' and 'column'
+     *  when the query was submitted with row_batches set.
+     *
+     *
      * 'row' - indicating the start of a new row of data along with row index 0,1 ..
+     *  and, when the query was submitted with granularity 'row', the row's values.
      *
      *
      * 'rowcount' - number of rows effected
@@ -829,6 +1067,18 @@ declare namespace MsNodeSqlV8 {
      * for BigInt can return string to avoid overflow
      */
     numeric_string?: boolean
+    /**
+     * fetch char/varchar columns as UTF-8 rather than UTF-16 - refused by prepare.
+     */
+    utf8_data?: boolean
+    /**
+     * join FOR JSON fragments natively and return the document as one row
+     */
+    json_reassemble?: boolean
+    /**
+     * as json_reassemble and also parse the document into an object
+     */
+    json_parse?: boolean
     query_timeout?: number
     query_polling?: boolean
     query_tz_adjustment?: number
@@ -839,6 +1089,69 @@ declare namespace MsNodeSqlV8 {
      * query will not prepare and return an error.
      */
     max_prepared_column_size?: number
+    max_interned_strings?: number
+    /**
+     * cancel the query, from execute through the last row fetched, once this
+     * many ms have passed - it then fails with 'Query timeout expired'.
+     */
+    query_deadline_ms?: number
+    /**
+     * fetch up to this many row batches ahead on the driver thread while
+     * JS handles the current one. Nothing further is fetched while the
+     * query is paused. 0 (default) reads a batch only when asked.
+     */
+    prefetch_depth?: number
+    /**
+     * deliver rows as one column major buffer per batch, encoded natively, rather than
+     * cell by cell. 'shared' backs each batch with a SharedArrayBuffer so it can be
+     * posted to a worker without a copy. 'arrow' encodes each batch natively as Arrow IPC
+     * stream messages raised as 'arrow' Buffers - the schema leads the first batch of each
+     * result set and the last closes the stream. numeric_string is ignored in this mode,
+     * decimal and money arrive as Utf8 text. each batch holds row_batches rows, default 1000.
+     */
+    columnar?: boolean | 'shared' | 'arrow'
+    /**
+     * deliver each read of this many rows whole as a 'batch' event rather than
+     * cell by cell - see queryStream. also the rows per batch of a columnar query.
+     */
+    row_batches?: number
+    /**
+     * events raised as rows are read - 'cell' (default) a 'row' then a 'column' per value,
+     * 'row' one 'row' event carrying the row's values, 'batch' one 'batch' event per read
+     * and 'none' no row events at all, the rows only reach the callback.
+     */
+    granularity?: QueryGranularity
+  }
+
+  export type QueryGranularity = 'cell' | 'row' | 'batch' | 'none'
+
+  export enum ColumnarKind {
+    Null = 0,
+    Number = 1,
+    Boolean = 2,
+    Date = 3,
+    Utf16 = 4,
+    Utf8 = 5,
+    Binary = 6
+  }
+
+  export class ColumnarView implements Iterable<sqlJsColumnType[]> {
+    constructor (buffer: ArrayBuffer | SharedArrayBuffer, meta?: Meta[])
+    buffer: ArrayBuffer | SharedArrayBuffer
+    meta: Meta[] | null
+    rowCount: number
+    columnCount: number
+    isNull (row: number, col: number): boolean
+    cell (row: number, col: number): sqlJsColumnType
+    /**
+     * the raw f64 lane of a Number, Boolean or Date column, null cells read 0
+     */
+    values (col: number): Float64Array | null
+    column (col: number): sqlJsColumnType[]
+    row (row: number): sqlJsColumnType[]
+    rows (): sqlJsColumnType[][]
+    objects (): Array<Record<string, sqlJsColumnType>>
+    [Symbol.iterator] (): Iterator<sqlJsColumnType[]>
   }
 
   export interface Meta {
@@ -875,10 +1188,95 @@ declare namespace MsNodeSqlV8 {
     activity: string
     op: string
     lastSql?: string
+    /**
+     * on a work checkout, ms the query waited in the pool for a free connection
+     */
+    waitMs?: number
   }
 
   export type PoolStatusRecordCb = (status: PoolStatusRecord) => void
 
+  /**
+   * log linear histogram in microseconds - each bucket is within 25% of its bound.
+   */
+  export interface LatencyHistogram {
+    count: number
+    sumMicros: number
+    maxMicros: number
+    meanMicros: number
+    p50: number
+    p90: number
+    p99: number
+    p999: number
+    /**
+     * cumulative [upper bound micros, count] for each occupied bucket
+     */
+    buckets: Array<[number, number]>
+  }
+
+  export interface OperationStats {
+    /**
+     * from the call into the driver until a libuv worker picks the operation up
+     */
+    queueWait: LatencyHistogram
+    /**
+     * ODBC work on the worker thread
+     */
+    execute: LatencyHistogram
+    /**
+     * back on the js thread, building the result and running the callback
+     */
+    complete: LatencyHistogram
+  }
+
+  export interface DriverCounters {
+    fetchCalls: number
+    getDataCalls: number
+    bytesFetched: number
+    columnObjects: number
+    /**
+     * batches fetched ahead of the reader with prefetch_depth set
+     */
+    prefetchedBatches: number
+    /**
+     * reads served from a prefetched batch without waiting on the driver
+     */
+    prefetchHits: number
+  }
+
+  export interface DriverStats {
+    /**
+     * keyed by operation e.g. query, readColumn, prepare - only those that have run
+     */
+    operations: { [operation: string]: OperationStats }
+    counters: DriverCounters
+  }
+
+  export interface PoolStats extends DriverStats {
+    pool: {
+      idle: number
+      busy: number
+      parked: number
+      workQueue: number
+      /**
+       * reads that joined an identical query in flight rather than running.
+       */
+      coalesced: number
+    }
+    /**
+     * present when the pool has a result cache.
+     */
+    cache?: {
+      entries: number
+      bytes: number
+      maxBytes: number
+      hits: number
+      misses: number
+      evictions: number
+      expirations: number
+    }
+  }
+
   export type QueryDescriptionCb = (description: QueryDescription) => void
 
   export type MessageCb = (msg: string) => void
@@ -957,6 +1355,13 @@ declare namespace MsNodeSqlV8 {
     delete: (rows: sqlBulkType) => Promise<void>
 
     update: (rows: sqlBulkType) => Promise<void>
+    /**
+     * insert the rows of an arrow ipc stream, columns matched by name to the table,
+     * one insert (or bcp when on) per record batch, all in one transaction that is rolled
+     * back on error - an already open transaction is joined and left to the caller.
+     * @param ipcBuffer - arrow ipc stream format.
+     */
+    insertArrow: (ipcBuffer: Buffer | Uint8Array) => Promise<any[]>
   }
 
   export interface BulkTableMgr {
@@ -1005,6 +1410,8 @@ declare namespace MsNodeSqlV8 {
 
     insertRows: (rows: object[], cb: StatusCb) => void
 
+    insertArrow: (ipcBuffer: Buffer | Uint8Array, cb: StatusCb) => void
+
     /**
      * for a set of objects extract primary key fields only
      * @param vec - array of objects
@@ -1079,9 +1486,10 @@ declare namespace MsNodeSqlV8 {
   export interface TvpParam extends ProcedureParam {
     /**
      * the strongly typed parameters relating to the table type
-     * repremted as rows i.e. array of values per column type
+     * repremted as rows i.e. array of values per column type, or the rows
+     * themselves for the driver to transpose
      */
-    table_value_param: ConcreteColumnType[]
+    table_value_param: ConcreteColumnType[] | BindRowsParam
     /**
      * user table type to which the tvp is targetting
      */
@@ -1102,6 +1510,43 @@ declare namespace MsNodeSqlV8 {
     schema: string
   }
 
+  export interface BindRowsColumn {
+    /**
+     * property read from each object row, array rows are read by column position
+     */
+    key: string
+    /**
+     * the type the column is bound with, its value is set to the column of values -
+     * without one the type is decided from the values
+     */
+    param?: ConcreteColumnType | null
+  }
+
+  export interface BindRowsParam {
+    bind_rows: boolean
+    rows: TvpStreamRow[]
+    columns: BindRowsColumn[]
+  }
+
+  export interface TvpStreamOptions {
+    /**
+     * rows pulled from the source and sent per chunk, the column buffers are sized for
+     * this many rows and reused for every chunk - default 1000
+     */
+    chunkRows?: number
+    /**
+     * bytes carried per row for a max column (nvarchar(max), varbinary(max) ...), a longer
+     * value fails the statement - default 8000
+     */
+    maxBytes?: number
+  }
+
+  export type TvpStreamRow = sqlQueryParamType[] | Record<string, sqlQueryParamType>
+
+  export interface TvpStreamParam extends TvpParam {
+    tvp_stream: boolean
+  }
+
   export interface ProcedureDefinitionPromises {
     call: (params?: sqlProcParamType, options?: QueryAggregatorOptions) => Promise<QueryAggregatorResults>
   }
@@ -1503,6 +1948,9 @@ declare namespace MsNodeSqlV8 {
   export enum QueryEvent {
     meta = 'meta',
     column = 'column',
+    columnar = 'columnar',
+    batch = 'batch',
+    arrow = 'arrow',
     partial = 'partial',
     rowCount = 'rowCount',
     row = 'row',
@@ -1586,6 +2034,16 @@ declare namespace MsNodeSqlV8 {
     data: any[]
   }
 
+  export interface NativeReadColumnarInfo {
+    end_rows: boolean
+    columnar: ArrayBuffer | SharedArrayBuffer
+  }
+
+  export interface NativeReadArrowInfo {
+    end_rows: boolean
+    arrow: Buffer
+  }
+
   export interface NativeNextResultInfo {
     endOfResults: boolean
     endOfRows: boolean
@@ -1596,6 +2054,28 @@ declare namespace MsNodeSqlV8 {
 
   export type NativeReadColumnCb = (err: Error, results: NativeReadColumnInfo) => void
 
+  export type NativeReadColumnarCb = (err: Error, results: NativeReadColumnarInfo) => void
+
+  export type NativeReadArrowCb = (err: Error, results: NativeReadArrowInfo) => void
+
+  export interface NativeBatchEntry {
+    query: QueryDescription
+    params: sqlQueryParamType[]
+  }
+
+  export interface NativeBatchResult {
+    meta?: Meta[]
+    rows?: any[][]
+    rowcount: number
+  }
+
+  export interface NativeBatchEntryInfo {
+    results: NativeBatchResult[]
+    errors: Error[]
+  }
+
+  export type NativeQueryBatchCb = (err: Error, results: NativeBatchEntryInfo[]) => void
+
   export type NativeNextResultCb = (err: Error, results: NativeNextResultInfo) => void
 
   export type NativeUnbindCb = (err: Error, outputVector: any[]) => void
@@ -1607,9 +2087,27 @@ declare namespace MsNodeSqlV8 {
   export interface NativeQueryObj {
     query_str: string
     numeric_string?: boolean
+    /**
+     * read decimal, numeric and money as text - set for arrow output.
+     */
+    decimal_string?: boolean
+    utf8_data?: boolean
+    json_reassemble?: boolean
+    json_parse?: boolean
     query_polling?: boolean
     query_timeout?: number
     max_prepared_column_size?: number
+    max_interned_strings?: number
+    query_deadline_ms?: number
+    prefetch_depth?: number
+    columnar?: boolean | 'shared' | 'arrow'
+    row_batches?: number
+    granularity?: QueryGranularity
+    /**
+     * set from the connection's useUTC - date and time columns are shifted to local time natively
+     * as rows are read, columnar and arrow results stay in UTC.
+     */
+    local_dates?: boolean
   }
 
   export interface NativeCustomBinding {
@@ -1635,11 +2133,41 @@ declare namespace MsNodeSqlV8 {
     value?: sqlQueryParamType
   }
 
+  export type NativePoolOpenCb = (err: Error[] | null, slot: number) => void
+
+  export class NativeConnectionPool {
+    constructor (capacity: number)
+
+    open (connectionObj: ConnectDescription, slots: number[], cb: NativePoolOpenCb): number
+
+    checkout (): number
+
+    checkin (slot: number): boolean
+
+    release (slot: number): void
+
+    idle (): number
+
+    getStats (): DriverStats
+  }
+
   export class NativeConnection {
     constructor ()
 
     readColumn (queryId: number, rowBatchSize: number, cb: NativeReadColumnCb): void
 
+    adopt (pool: NativeConnectionPool, slot: number): boolean
+
+    getStats (): DriverStats
+
+    readColumnar (queryId: number, rowBatchSize: number, shared: boolean, cb: NativeReadColumnarCb): void
+
+    readArrow (queryId: number, rowBatchSize: number, withSchema: boolean, cb: NativeReadArrowCb): void
+
+    pausePrefetch (queryId: number): void
+
+    queryBatch (queryId: number, entries: NativeBatchEntry[], cb: NativeQueryBatchCb): void
+
     nextResult (queryId: number, cb: NativeNextResultCb): void
 
     unbind (queryId: number, cb: NativeUnbindCb): void
@@ -1663,6 +2191,8 @@ declare namespace MsNodeSqlV8 {
     query (qid: number, queryObj: NativeQueryObj, params: NativeParam[], cb: NativeQueryCb): void
 
     callProcedure (qid: number, procedure: string, params: NativeParam[], cb: NativeQueryCb): void
+
+    sendTvpRows (qid: number, params: NativeParam[], cb: NativeQueryCb): void
   }
 
   export interface SqlClient extends UserConversion {
@@ -1720,6 +2250,25 @@ declare namespace MsNodeSqlV8 {
      * @returns the Table Value Parameter instance ready for use in query
      */
     TvpFromTable: (table: Table) => TvpParam
+    /**
+     * construct a tvp parameter whose rows are read from an iterator or async iterator
+     * of row arrays or objects keyed by column name while the statement runs. rows are
+     * sent in chunks through one fixed size buffer per column, so a large set is never
+     * held in memory as a whole. the parameter can be sent once, with a query or a
+     * procedure call but not a prepared statement.
+     * @param table - the user type table, e.g. from getUserTypeTable
+     * @param source - the rows
+     * @param options - chunk size and the width carried for max columns
+     */
+    /**
+     * bind rows as one array parameter per column without building the column arrays in
+     * JS - the driver reads each row once as it binds. this is what the bulk table manager
+     * and TvpFromTable send.
+     * @param rows - objects read by column key or arrays read by position
+     * @param columns - the key and optional type of each column, in parameter order
+     */
+    BindRows: (rows: TvpStreamRow[], columns: BindRowsColumn[]) => BindRowsParam
+    TvpStream: (table: Table, source: Iterable<TvpStreamRow> | AsyncIterable<TvpStreamRow>, options?: TvpStreamOptions) => TvpStreamParam
   }
 }
 
@@ -11,6 +11,8 @@ const poolModule = (() => {
   const { tableModule } = require('./table')
   const userModule = require('./user').userModule
   const { metaModule } = require('./meta')
+  const { SingleFlight } = require('./single-flight')
+  const { ResultCache } = require('./result-cache')
   const cppDriver = new utilModule.Native().cppDriver
 
   class PoolWorkItem {
@@ -22,14 +24,21 @@ const poolModule = (() => {
       this.poolNotifier = poolNotifier
       this.workType = workType
       this.chunky = chunky
+      this.enqueuedAt = process.hrtime.bigint()
+    }
+
+    waitMs () {
+      return Number(process.hrtime.bigint() - this.enqueuedAt) / 1e6
     }
   }
 
   class PoolDscription {
-    constructor (id, pool, connection) {
+    constructor (id, pool, connection, slot) {
       this.id = id
       this.pool = pool
       this.connection = connection
+      this.slot = slot
+      this.state = 'opening'
       this.heartbeatSqlResponse = null
       this.lastActive = new Date()
       this.work = null
@@ -39,6 +48,7 @@ const poolModule = (() => {
       this.queriesSent = 0
       this.beganAt = null
       this.totalElapsedQueryMs = 0
+      this.inflight = 0
     }
 
     begin () {
@@ -65,6 +75,7 @@ const poolModule = (() => {
     assignConnection (c) {
       this.connection = c
       this.work = null
+      this.inflight = 0
       this.heartbeatSqlResponse = null
       this.lastActive = new Date()
       this.keepAliveCount = 0
@@ -72,6 +83,7 @@ const poolModule = (() => {
 
     recreate (conn) {
       this.connection = conn
+      this.inflight = 0
       this.lastActive = new Date()
       this.heartbeatSqlResponse = null
       this.recreateCount++
@@ -86,11 +98,12 @@ const poolModule = (() => {
   }
 
   class PoolEventCaster extends EventEmitter {
-    constructor () {
+    constructor (wake) {
       super()
       this.queryObj = null
       this.paused = false
       this.pendingCancel = false
+      this.wake = wake
     }
 
     isPaused () {
@@ -114,6 +127,7 @@ const poolModule = (() => {
         this.queryObj.cancelQuery(cb)
       } else {
         this.pendingCancel = true
+        this.wake()
         setImmediate(() => {
           if (cb) {
             cb()
@@ -133,6 +147,8 @@ const poolModule = (() => {
       this.paused = false
       if (this.queryObj) {
         this.queryObj.resumeQuery()
+      } else {
+        this.wake()
       }
     }
 
@@ -186,11 +202,24 @@ const poolModule = (() => {
       this.ceiling = Math.max(1, this.getOpt(opt, 'ceiling', 4))
       this.heartbeatSecs = Math.max(1, this.getOpt(opt, 'heartbeatSecs', 20))
       this.heartbeatSql = this.getOpt(opt, 'heartbeatSql', 'select @@SPID as spid')
+      // heartbeats send heartbeatSql as well as asking the driver if the link is dead - the
+      // driver's flag only reflects what it has already seen, so a link dropped silently is
+      // found, and kept from idling out, only by a round trip. false skips it.
+      this.heartbeatProbe = this.getOpt(opt, 'heartbeatProbe', true)
       this.inactivityTimeoutSecs = Math.max(3, this.getOpt(opt, 'inactivityTimeoutSecs', 60))
       this.connectionString = this.getOpt(opt, 'connectionString', '')
       this.useUTC = this.getOpt(opt, 'useUTC', null)
       this.useNumericString = this.getOpt(opt, 'useNumericString', null)
+      this.useUTF8Data = this.getOpt(opt, 'useUTF8Data', null)
       this.maxPreparedColumnSize = this.getOpt(opt, 'maxPreparedColumnSize', null)
+      this.maxInternedStrings = this.getOpt(opt, 'maxInternedStrings', null)
+      this.queryDeadlineMs = this.getOpt(opt, 'queryDeadlineMs', null)
+      this.prefetchDepth = this.getOpt(opt, 'prefetchDepth', null)
+      this.pipelineDepth = this.getOpt(opt, 'pipelineDepth', null)
+      // queries given { read: true } share one execution with identical reads in flight
+      this.coalesceReads = this.getOpt(opt, 'coalesceReads', false)
+      // bytes held by the native cache of queries given { ttlMs }, 0 is off
+      this.resultCacheBytes = Math.max(0, this.getOpt(opt, 'resultCacheBytes', 0))
       this.floor = Math.min(this.floor, this.ceiling)
       this.inactivityTimeoutSecs = Math.max(this.inactivityTimeoutSecs, this.heartbeatSecs)
     }
@@ -224,26 +253,24 @@ const poolModule = (() => {
   class Pool extends EventEmitter {
     constructor (opt) {
       super()
-      const clientPromises = sqlClientModule.promises
-      const idle = []
-      const parked = []
       const workQueue = []
       const pause = []
       let busyConnectionCount = 0
       let parkingConnectionCount = 0
+      let parkedCount = 0
       let opened = false
-      let hbTimer = null
-      let pollTimer = null
+      let maintenanceTimer = null
+      let maintenanceDue = 0
       const _this = this
       let descriptionId = 0
       let commandId = 0
       let pendingCreates = 0
       let closed = false
-      const heartbeatTickMs = 250
       const notifierFactory = new notifyModule.NotifyFactory()
       const poolProcedureCache = {}
       const poolTableCache = {}
       const aggregator = new utilModule.QueryAggregator(this)
+      const flights = new SingleFlight()
       const userTypes = new userModule.SqlTypes()
       const sqlMeta = new metaModule.Meta()
       const native = new cppDriver.Connection()
@@ -257,6 +284,17 @@ const poolModule = (() => {
       }
 
       const options = parseOptions()
+      const cache = options.resultCacheBytes > 0 ? new ResultCache(cppDriver, options.resultCacheBytes) : null
+
+      // slots, the idle queue and warm up threads are native - see src/ConnectionPool.h.
+      // a description per slot carries the JS connection adopted into it.
+      const core = new cppDriver.ConnectionPool(options.ceiling)
+      const descriptions = new Array(options.ceiling).fill(null)
+      const opening = new Array(options.ceiling).fill(false)
+      const connectObj = {
+        conn_str: options.connectionString,
+        conn_timeout: 0
+      }
 
       function getUseUTC () {
         return options.useUTC
@@ -266,22 +304,23 @@ const poolModule = (() => {
         options.useUTC = utc
       }
 
-      function newDescription (c) {
-        return new PoolDscription(descriptionId++, this, c)
-      }
-
-      function parkedDescription (c) {
-        if (parked.length > 0) {
-          const d = parked.pop()
-          d.assignConnection(c)
-          return d
-        } else {
-          return null
+      function getDescription (c, slot) {
+        const existing = descriptions[slot]
+        if (existing) {
+          if (existing.state === 'parked') {
+            parkedCount--
+          }
+          existing.assignConnection(c)
+          return existing
         }
+        const d = new PoolDscription(descriptionId++, _this, c, slot)
+        descriptions[slot] = d
+        return d
       }
 
-      function getDescription (c) {
-        return parkedDescription(c) || newDescription(c)
+      function isFreeSlot (slot) {
+        const d = descriptions[slot]
+        return !opening[slot] && (d === null || d.state === 'parked')
       }
 
       function runTheQuery (q, description, work) {
@@ -297,7 +336,10 @@ const poolModule = (() => {
 
         q.on('free', () => {
           description.free()
-          checkin('work', description)
+          if (--description.inflight <= 0) {
+            description.inflight = 0
+            checkin('work', description)
+          }
           _this.emit('debug', `[${description.id}] free work id ${work.id}`)
           work.poolNotifier.emit('free')
           setImmediate(() => {
@@ -333,6 +375,7 @@ const poolModule = (() => {
       }
 
       function item (description, work) {
+        description.inflight++
         description.begin()
         _this.emit('debug', `[${description.id}] query work id = ${work.id}, workQueue = ${workQueue.length}`)
         const q = getTheQuery(description, work)
@@ -348,10 +391,9 @@ const poolModule = (() => {
 
       function promotePause () {
         const add = []
-        const start = pause.length
         while (pause.length > 0) {
           const item = pause.pop()
-          if (item.isPaused) {
+          if (item.poolNotifier.isPaused()) {
             add.unshift(item)
           } else {
             workQueue.push(item)
@@ -360,36 +402,48 @@ const poolModule = (() => {
         while (add.length > 0) {
           pause.unshift(add.pop())
         }
-        if (start !== pause.length) {
-          setImmediate(() => { crank() })
-        }
-      }
-
-      function poll () {
-        if (pause.length + workQueue.length > 0) {
-          crank()
-        }
       }
 
+      // called whenever something changes - a connection checked in or opened, work
+      // submitted, resumed or cancelled - so waiting work starts without a polling tick.
       function crank () {
         if (closed) {
           return
         }
-        void grow().then(() => {
-          promotePause()
-          while (workQueue.length > 0 && idle.length > 0) {
-            const work = workQueue.pop()
-            if (work.poolNotifier.isPendingCancel()) {
-              _this.emit('debug', `query work id = ${work.id} has been cancelled waiting in pool to execute, workQueue = ${workQueue.length}`)
-              doneFree(work.poolNotifier)
-            } else if (work.poolNotifier.isPaused()) {
-              pause.unshift(work)
-            } else {
-              const description = checkout('work')
-              item(description, work)
+        grow().catch(e => {
+          sendError(e)
+        })
+        dispatch()
+      }
+
+      function dispatch () {
+        promotePause()
+        while (workQueue.length > 0) {
+          const work = workQueue[workQueue.length - 1]
+          if (work.poolNotifier.isPendingCancel()) {
+            workQueue.pop()
+            _this.emit('debug', `query work id = ${work.id} has been cancelled waiting in pool to execute, workQueue = ${workQueue.length}`)
+            doneFree(work.poolNotifier)
+          } else if (work.poolNotifier.isPaused()) {
+            workQueue.pop()
+            pause.unshift(work)
+          } else {
+            const description = checkout('work', work) || share()
+            if (!description) {
+              break
             }
+            workQueue.pop()
+            item(description, work)
           }
-        })
+        }
+      }
+
+      function wake () {
+        if (opened) {
+          setImmediate(() => {
+            crank()
+          })
+        }
       }
 
       const workTypeEnum = {
@@ -424,7 +478,7 @@ const poolModule = (() => {
       }
 
       function submit (sql, paramsOrCallback, callback, type) {
-        const notifier = new PoolEventCaster()
+        const notifier = new PoolEventCaster(wake)
         const work = newWorkItem(sql, paramsOrCallback, callback, notifier, type)
         if (!closed) {
           enqueue(work)
@@ -474,8 +528,57 @@ const poolModule = (() => {
         return checkClosedPromise().then(async () => aggregator.callProc(name, params, options))
       }
 
-      async function queryAggregator (sql, params, options) {
-        return checkClosedPromise().then(async () => aggregator.query(sql, params, options))
+      async function runQuery (sql, params, queryOptions) {
+        const key = options.coalesceReads && queryOptions && queryOptions.read
+          ? flights.keyOf(sql, params, queryOptions)
+          : null
+        return key
+          ? flights.run(key, () => aggregator.query(sql, params, queryOptions))
+          : aggregator.query(sql, params, queryOptions)
+      }
+
+      async function cachedQuery (sql, params, queryOptions) {
+        const key = cache.keyOf(sql, params)
+        if (key === null || cache.bypassed(sql)) {
+          return runQuery(sql, params, queryOptions)
+        }
+        const hit = cache.get(key)
+        if (hit) {
+          return cache.materialise(aggregator.emptyResults(queryOptions), hit.sets, hit.counts)
+        }
+        if (!cache.vetted(sql)) {
+          // first seen - read the ordinary way, its columns say whether it can be cached.
+          const res = await runQuery(sql, params, queryOptions)
+          cache.vet(sql, res.meta)
+          return res
+        }
+        const generation = cache.generation
+        const res = await runQuery(cache.columnarQuery(sql), params, queryOptions)
+        const sets = cache.setsOf(res)
+        // the columns were vetted on an earlier read, sql whose result has changed shape
+        // since is not stored and is read the ordinary way from then on.
+        if (cache.vet(sql, sets.map(s => s.meta)) && cache.generation === generation) {
+          cache.put(key, queryOptions, sets, res.counts)
+        }
+        return cache.materialise(aggregator.emptyResults(queryOptions), sets, res.counts)
+      }
+
+      async function queryAggregator (sql, params, queryOptions) {
+        return checkClosedPromise().then(async () => {
+          return cache && queryOptions && queryOptions.ttlMs > 0
+            ? cachedQuery(sql, params, queryOptions)
+            : runQuery(sql, params, queryOptions)
+        })
+      }
+
+      // drop a cached result by the sql and params it was read with.
+      function invalidate (sql, params) {
+        return cache ? cache.invalidate(sql, params) : false
+      }
+
+      // drop every cached result stored with the tag, returns how many went.
+      function invalidateTag (tag) {
+        return cache ? cache.invalidateTag(tag) : 0
       }
 
       function enqueue (item) {
@@ -493,8 +596,8 @@ const poolModule = (() => {
       function getStatus (work, activity, op) {
         const s = {
           time: new Date(),
-          parked: parked.length,
-          idle: idle.length,
+          parked: parkedCount,
+          idle: core.idle(),
           busy: busyConnectionCount,
           pause: pause.length,
           parking: parkingConnectionCount,
@@ -503,7 +606,7 @@ const poolModule = (() => {
           op
         }
         if (work) {
-          s.lastSql = work.sql
+          s.lastSql = work.sql?.query_str || work.sql
           s.lastParams = work.chunky.params
         }
         return s
@@ -513,69 +616,156 @@ const poolModule = (() => {
         if (closed) {
           return
         }
-        idle.unshift(description)
-        if (busyConnectionCount > 0) {
+        if (description.state === 'busy' && busyConnectionCount > 0) {
           busyConnectionCount--
         }
+        description.state = 'idle'
+        core.checkin(description.slot)
         _this.emit('status', getStatus(description.work, activity, 'checkin'))
         description.work = null
-        _this.emit('debug', `[${description.id}] checkin idle = ${idle.length}, parking = ${parkingConnectionCount}, parked = ${parked.length}, busy = ${busyConnectionCount}, pause = ${pause.length}, workQueue = ${workQueue.length}`)
+        _this.emit('debug', `[${description.id}] checkin idle = ${core.idle()}, parking = ${parkingConnectionCount}, parked = ${parkedCount}, busy = ${busyConnectionCount}, pause = ${pause.length}, workQueue = ${workQueue.length}`)
+        scheduleMaintenance(description.lastActive.getTime() + options.heartbeatSecs * 1000)
       }
 
-      function checkout (activity) {
-        if (idle.length === 0) {
+      function markBusy (description, activity, work) {
+        description.state = 'busy'
+        busyConnectionCount++
+        const s = getStatus(null, activity, 'checkout')
+        if (work) {
+          // time the work spent queued waiting for a free connection
+          s.waitMs = work.waitMs()
+        }
+        _this.emit('status', s)
+        _this.emit('debug', `[${description.id}] checkout idle = ${core.idle()}, parking = ${parkingConnectionCount}, parked = ${parkedCount}, busy = ${busyConnectionCount}, pause = ${pause.length}, workQueue = ${workQueue.length}`)
+      }
+
+      function checkout (activity, work) {
+        const slot = core.checkout()
+        if (slot < 0) {
           return null
         }
-        const description = idle.pop()
-        busyConnectionCount++
-        _this.emit('status', getStatus(null, activity, 'checkout'))
-        _this.emit('debug', `[${description.id}] checkout idle = ${idle.length}, parking = ${parkingConnectionCount}, parked = ${parked.length}, busy = ${busyConnectionCount}, pause = ${pause.length}, workQueue = ${workQueue.length}`)
+        const description = descriptions[slot]
+        markBusy(description, activity, work)
         return description
       }
 
+      // with pipelineDepth set and no connection idle, work joins the least loaded
+      // connection already running queries until each has that many in flight.
+      function share () {
+        if (!(options.pipelineDepth > 1)) {
+          return null
+        }
+        let best = null
+        descriptions.forEach(d => {
+          if (d && d.state === 'busy' && d.inflight > 0 && d.inflight < options.pipelineDepth) {
+            if (!best || d.inflight < best.inflight) {
+              best = d
+            }
+          }
+        })
+        return best
+      }
+
+      function connectionOptions (c) {
+        c.setSharedCache(poolProcedureCache, poolTableCache)
+        if (options.maxPreparedColumnSize) {
+          c.setMaxPreparedColumnSize(options.maxPreparedColumnSize)
+        }
+        if (options.maxInternedStrings) {
+          c.setMaxInternedStrings(options.maxInternedStrings)
+        }
+        if (options.queryDeadlineMs) {
+          c.setQueryDeadlineMs(options.queryDeadlineMs)
+        }
+        if (options.prefetchDepth) {
+          c.setPrefetchDepth(options.prefetchDepth)
+        }
+        if (options.pipelineDepth) {
+          c.setPipelineDepth(options.pipelineDepth)
+        }
+        if (options.useUTC === true || options.useUTC === false) {
+          c.setUseUTC(options.useUTC)
+        }
+        if (options.useNumericString === true || options.useNumericString === false) {
+          c.setUseNumericString(options.useNumericString)
+        }
+        if (options.useUTF8Data === true || options.useUTF8Data === false) {
+          c.setUseUTF8Data(options.useUTF8Data)
+        }
+      }
+
+      // the native pool connects every slot at once on its own thread and reports each
+      // as it completes; onConnection runs once the JS connection has adopted it.
+      function openSlots (slots, onConnection) {
+        pendingCreates += slots.length
+        slots.forEach(slot => { opening[slot] = true })
+        return new Promise((resolve, reject) => {
+          let remaining = slots.length
+          let firstError = null
+          function settle () {
+            if (--remaining > 0) {
+              return
+            }
+            if (firstError) {
+              reject(firstError)
+            } else {
+              resolve(slots.length)
+            }
+          }
+          core.open(connectObj, slots, (err, slot) => {
+            if (err) {
+              --pendingCreates
+              opening[slot] = false
+              firstError = firstError || (Array.isArray(err) && err.length === 1 ? err[0] : err)
+              settle()
+              return
+            }
+            sqlClientModule.adopt(connectObj, core, slot, (e, c) => {
+              --pendingCreates
+              opening[slot] = false
+              if (e) {
+                firstError = firstError || e
+              } else if (closed) {
+                // the pool closed while this slot was opening, nothing else will close it.
+                c.promises.close().then(() => {
+                  core.release(slot)
+                }).catch(() => {
+                  core.release(slot)
+                })
+              } else {
+                connectionOptions(c)
+                onConnection(c, slot)
+              }
+              settle()
+            })
+          })
+        })
+      }
+
       async function grow () {
         if (closed) {
           return
         }
-        const existing = idle.length + busyConnectionCount + pendingCreates + parkingConnectionCount
-
-        if (existing === options.ceiling) {
+        const existing = core.idle() + busyConnectionCount + pendingCreates + parkingConnectionCount
+        if (existing >= options.ceiling) {
           return
         }
-
-        function connectionOptions (c) {
-          c.setSharedCache(poolProcedureCache, poolTableCache)
-          if (options.maxPreparedColumnSize) {
-            c.setMaxPreparedColumnSize(options.maxPreparedColumnSize)
-          }
-          if (options.useUTC === true || options.useUTC === false) {
-            c.setUseUTC(options.useUTC)
-          }
-          if (options.useNumericString === true || options.useNumericString === false) {
-            c.setUseNumericString(options.useNumericString)
+        const slots = []
+        for (let slot = 0; slot < options.ceiling && existing + slots.length < options.ceiling; ++slot) {
+          if (isFreeSlot(slot)) {
+            slots.push(slot)
           }
         }
-
-        const toPromise = []
-        for (let i = existing; i < options.ceiling; ++i) {
-          ++pendingCreates
-          toPromise.push(clientPromises.open(options.connectionString)
-            .then(
-              c => {
-                --pendingCreates
-                connectionOptions(c)
-                checkin('grow', getDescription(c))
-              },
-              async e => {
-                --pendingCreates
-                return Promise.reject(e)
-              }
-            )
-          )
+        if (slots.length === 0) {
+          return
         }
-
-        const res = await Promise.all(toPromise)
-        _this.emit('debug', `grow creates ${res.length} connections for pool idle = ${idle.length}, busy = ${busyConnectionCount}, pending = ${pendingCreates}, parkingConnectionCount = ${parkingConnectionCount}, existing = ${existing}`)
+        const created = await openSlots(slots, (c, slot) => {
+          checkin('grow', getDescription(c, slot))
+          if (opened) {
+            dispatch()
+          }
+        })
+        _this.emit('debug', `grow creates ${created} connections for pool idle = ${core.idle()}, busy = ${busyConnectionCount}, pending = ${pendingCreates}, parkingConnectionCount = ${parkingConnectionCount}, existing = ${existing}`)
       }
 
       function open (cb) {
@@ -586,19 +776,9 @@ const poolModule = (() => {
           if (cb) {
             cb(null, options)
           }
-
-          if (options.heartbeatSecs) {
-            hbTimer = setInterval(() => {
-              park()
-              heartbeat()
-            }, heartbeatTickMs, _this)
-            crank()
-          }
-          pollTimer = setInterval(() => {
-            poll()
-          }, 200, _this)
           opened = true
           _this.emit('open', options)
+          crank()
         }).catch(e => {
           if (cb) {
             cb(e, null)
@@ -607,94 +787,129 @@ const poolModule = (() => {
         })
       }
 
-      function park () {
-        const toParkIndex = idle.findIndex(description => {
-          const inactivePeriod = description.keepAliveCount * options.heartbeatSecs
-          return inactivePeriod >= options.inactivityTimeoutSecs
-        })
-        if (toParkIndex === -1) {
-          return
-        }
-        const description = idle[toParkIndex]
-        if (parkDescription(description)) {
-          idle.splice(toParkIndex, 1)
+      function sendError (e, more) {
+        if (_this.listenerCount('error') > 0) {
+          _this.emit('error', e, more)
         }
       }
 
-      function promoteToFront (index) {
-        if (index < 0 || index >= idle.length) {
+      // armed for when the longest idle connection is next due a heartbeat, rather
+      // than ticking on an interval; checkin brings it forward when needed.
+      function scheduleMaintenance (due) {
+        if (closed || !options.heartbeatSecs) {
           return
         }
-        const description = idle[index]
-        idle.splice(index, 1)
-        idle.push(description)
-      }
-
-      function sendError (e, more) {
-        if (_this.listenerCount('error') > 0) {
-          _this.emit('error', e, more)
+        if (maintenanceTimer && maintenanceDue <= due) {
+          return
         }
+        if (maintenanceTimer) {
+          clearTimeout(maintenanceTimer)
+        }
+        maintenanceDue = due
+        maintenanceTimer = setTimeout(maintain, Math.max(0, due - Date.now()))
       }
 
-      function heartbeat () {
-        const toHeartBeatIndex = idle.findIndex(d => new Date() - d.lastActive >= options.heartbeatSecs * 1000)
-        if (toHeartBeatIndex === -1) {
+      function maintain () {
+        maintenanceTimer = null
+        if (closed) {
           return
         }
-        promoteToFront(toHeartBeatIndex)
-        const description = checkout('heartbeat')
-        const q = description.connection.query(options.heartbeatSql)
-        q.on('column', (i, v) => {
-          description.heartbeatResponse(v)
-        })
-        q.on('done', () => {
-          description.heartbeat() // reset by user query
-          checkin('heartbeat', description)
+        const now = Date.now()
+        const heartbeatMs = options.heartbeatSecs * 1000
+        const idle = []
+        let slot
+        while ((slot = core.checkout()) >= 0) {
+          idle.push(descriptions[slot])
+        }
+        let idleCount = idle.length
+        let nextDue = Infinity
+        const due = []
+        idle.forEach(description => {
           const inactivePeriod = description.keepAliveCount * options.heartbeatSecs
-          _this.emit('debug', `[${description.id}] heartbeat response = '${description.heatbeatSqlResponse}', ${description.lastActive.toLocaleTimeString()}` +
-            `, keepAliveCount = ${description.keepAliveCount} inactivePeriod = ${inactivePeriod}, inactivityTimeoutSecs = ${options.inactivityTimeoutSecs}`)
+          // need to leave at least floor connections in idle pool
+          if (inactivePeriod >= options.inactivityTimeoutSecs && idleCount > options.floor) {
+            --idleCount
+            parkDescription(description)
+          } else if (now - description.lastActive >= heartbeatMs) {
+            due.push(description)
+          } else {
+            core.checkin(description.slot)
+            nextDue = Math.min(nextDue, description.lastActive.getTime() + heartbeatMs)
+          }
         })
-        q.on('error', (e) => {
-          sendError(e)
-          recreate(description)
+        if (due.length > 0) {
+          heartbeat(due)
+        }
+        if (nextDue !== Infinity) {
+          scheduleMaintenance(nextDue)
+        }
+      }
+
+      // one native task checks every due connection, no query goes through the
+      // reader, and with heartbeatProbe turned off nothing is sent to the server.
+      function heartbeat (due) {
+        due.forEach(description => markBusy(description, 'heartbeat'))
+        const probeSql = options.heartbeatProbe ? options.heartbeatSql : null
+        core.probe(due.map(description => description.slot), probeSql, (err, alive) => {
+          due.forEach((description, i) => {
+            if (err || !alive[i]) {
+              sendError(err || new Error(`[${description.id}] pool connection is dead`))
+              recreate(description)
+              return
+            }
+            description.heartbeatResponse(alive[i])
+            description.heartbeat() // reset by user query
+            checkin('heartbeat', description)
+            const inactivePeriod = description.keepAliveCount * options.heartbeatSecs
+            _this.emit('debug', `[${description.id}] heartbeat alive, ${description.lastActive.toLocaleTimeString()}` +
+              `, keepAliveCount = ${description.keepAliveCount} inactivePeriod = ${inactivePeriod}, inactivityTimeoutSecs = ${options.inactivityTimeoutSecs}`)
+          })
         })
       }
 
       function parkDescription (description) {
-        // need to leave at least floor connections in idle pool
-        const canPark = Math.max(0, idle.length - options.floor)
-        if (canPark === 0) {
-          return false
-        }
-        _this.emit('debug', `[${description.id}] close connection and park due to inactivity parked = ${parked.length}, canPark = ${canPark}`)
+        _this.emit('debug', `[${description.id}] close connection and park due to inactivity parked = ${parkedCount}`)
         parkingConnectionCount++
+        description.state = 'parking'
         const connPromises = description.connection.promises
         connPromises.close().then(() => {
           parkingConnectionCount--
+          core.release(description.slot)
           description.park()
-          parked.unshift(description)
-          _this.emit('debug', `[${description.id}] closed connection and park due to inactivity parked = ${parked.length}, idle = ${idle.length}, busy = ${busyConnectionCount}`)
+          description.state = 'parked'
+          parkedCount++
+          _this.emit('debug', `[${description.id}] closed connection and park due to inactivity parked = ${parkedCount}, idle = ${core.idle()}, busy = ${busyConnectionCount}`)
           _this.emit('status', getStatus(null, 'parked', 'parked'))
         }).catch(e => {
+          parkingConnectionCount--
           sendError(e)
         })
-        return true
       }
 
       function recreate (description) {
         _this.emit('debug', `recreate connection [${description.id}]`)
+        if (description.state === 'busy' && busyConnectionCount > 0) {
+          busyConnectionCount--
+        }
+        description.state = 'recreating'
         const toPromise = []
         if (description.connection) {
           const promisedClose = description.connection.promises.close()
           toPromise.push(promisedClose)
         }
         void Promise.all(toPromise).then(() => {
-          clientPromises.open(options.connectionString).then(conn => {
+          core.release(description.slot)
+          return openSlots([description.slot], conn => {
             description.recreate(conn)
             checkin('recreate', description)
-          }).catch(e => {
-            sendError(e)
+            dispatch()
           })
+        }).catch(e => {
+          // leave the slot free so a later grow can try again
+          description.park()
+          description.state = 'parked'
+          parkedCount++
+          sendError(e)
         })
       }
 
@@ -702,23 +917,46 @@ const poolModule = (() => {
         return closed
       }
 
-      function close (cb) {
-        if (hbTimer) {
-          clearInterval(hbTimer)
+      // native stats summed over every connection the pool has held, with the
+      // current occupancy alongside.
+      function getStats () {
+        const stats = core.getStats()
+        stats.pool = {
+          idle: core.idle(),
+          busy: busyConnectionCount,
+          parked: parkedCount,
+          workQueue: workQueue.length,
+          coalesced: flights.stats().joined
         }
-        if (pollTimer) {
-          clearInterval(pollTimer)
+        if (cache) {
+          stats.cache = cache.getStats()
         }
-        // any parked connection will have been closed
-        while (parked.length > 0) {
-          parked.pop()
+        return stats
+      }
+
+      function close (cb) {
+        closed = true
+        if (cache) {
+          cache.clear()
+        }
+        if (maintenanceTimer) {
+          clearTimeout(maintenanceTimer)
+          maintenanceTimer = null
         }
 
         while (workQueue.length > 0) {
           workQueue.pop()
         }
 
-        const toClosePromise = idle.map(description => description.connection.promises.close)
+        // any parked connection will have been closed
+        const idle = []
+        let slot
+        while ((slot = core.checkout()) >= 0) {
+          idle.push(descriptions[slot])
+        }
+        const toClosePromise = idle.map(description => description.connection.promises.close().then(() => {
+          core.release(description.slot)
+        }))
         Promise.all(toClosePromise).then(res => {
           _this.emit('debug', `closed ${res.length} connections due to pool shutdown busy = ${busyConnectionCount}`)
           _this.emit('close')
@@ -730,9 +968,7 @@ const poolModule = (() => {
             cb()
           }
           sendError(e)
-        }).finally(
-          closed = true
-        )
+        })
       }
 
       this.open = open
@@ -745,10 +981,13 @@ const poolModule = (() => {
       this.getTable = getTable
       this.getProc = getProc
       this.queryAggregator = queryAggregator
+      this.invalidate = invalidate
+      this.invalidateTag = invalidateTag
       this.promises = new PoolPromises(this)
       this.getUseUTC = getUseUTC
       this.setUseUTC = setUseUTC
       this.isClosed = isClosed
+      this.getStats = getStats
     }
   }
 
@@ -71,6 +71,7 @@ class ProcedureBound {
 
   callStoredProcedure (notify, signature, paramsOrCallback, callback) {
     const queryOb = new this.notifier.QueryObject(signature, this.timeout, this.polling)
+    queryOb.utf8_data = this.conn.getUseUTF8Data()
     this.notifier.validateParameters(
       [
         new this.notifier.LexicalParam('string', queryOb.query_str, 'query string')
@@ -10,6 +10,8 @@ class AggregatorResults {
     this.metaElapsed = []
     this.counts = []
     this.results = []
+    this.columnar = []
+    this.arrow = []
     this.output = null
     this.info = null
     this.errors = []
@@ -33,6 +35,8 @@ class AggregatorResults {
     this.calcElapsed()
     this.meta.push(meta)
     this.results.push([])
+    this.columnar.push([])
+    this.arrow.push([])
     this.metaElapsed.push(this.elapsed)
     if (this.first === null) {
       this.first = this.results[0]
@@ -99,6 +103,33 @@ class AggregatorResults {
     return this.options.raw ? [this.meta[resultId].length] : {}
   }
 
+  onColumnar (view) {
+    this.columnar[this.resultId()].push(view)
+  }
+
+  onArrow (bytes) {
+    this.arrow[this.resultId()].push(bytes)
+  }
+
+  // a row_batches query hands rows over whole, already in column order.
+  onBatch (rows) {
+    const resultId = this.resultId()
+    const meta = this.meta[resultId]
+    const results = this.results[resultId]
+    rows.forEach(r => {
+      if (this.options.raw) {
+        results.push(r)
+      } else {
+        const row = {}
+        meta.forEach((m, c) => { row[m.name] = r[c] })
+        results.push(row)
+      }
+    })
+    this.rows += rows.length
+    this.calcElapsed()
+    this.rowRate = (this.rows / this.elapsed) * 1000
+  }
+
   onColumn (c, v) {
     const resultId = this.resultId()
     const meta = this.meta[resultId]
@@ -227,10 +258,25 @@ class QueryAggregator {
         ret.onColumn(c, v)
       }
 
+      function onColumnar (view) {
+        ret.onColumnar(view)
+      }
+
+      function onArrow (bytes) {
+        ret.onArrow(bytes)
+      }
+
+      function onBatch (rows) {
+        ret.onBatch(rows)
+      }
+
       function unSubscribe () {
         q.removeListener('submitted', onSubmitted)
         q.removeListener('rowcount', onRowCount)
         q.removeListener('column', onColumn)
+        q.removeListener('columnar', onColumnar)
+        q.removeListener('batch', onBatch)
+        q.removeListener('arrow', onArrow)
         q.removeListener('output', onOutput)
         q.removeListener('error', onError)
         q.removeListener('info', onInfo)
@@ -253,6 +299,9 @@ class QueryAggregator {
         q.on('done', onDone)
         q.on('free', onFree)
         q.on('column', onColumn)
+        q.on('columnar', onColumnar)
+        q.on('batch', onBatch)
+        q.on('arrow', onArrow)
       }
 
       subscribe()
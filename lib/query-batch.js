@@ -0,0 +1,79 @@
+'use strict'
+
+// independent statements sent to the server together - the driver wraps each entry in an
+// sp_executesql of its own, so variables declared in one do not meet another's and a create
+// procedure or view may be an entry, and sends them all as one batch: one round trip to the
+// server and one trip to the thread pool. the results read back are handed to the entry that
+// gave them, apart from the rest. session state such as set options carries from one entry to
+// the next, as it does between any two queries on the connection.
+
+function isInfo (err) {
+  return !!err.sqlstate && err.sqlstate.substring(0, 2) === '01'
+}
+
+class QueryBatch {
+  constructor (connection, entries, options) {
+    this.connection = connection
+    this.options = options || {}
+    this.entries = entries.map(e => typeof e === 'string' ? { sql: e } : e)
+  }
+
+  // info messages, e.g. from print, are kept with the results - an entry is rejected with
+  // the first error it raised.
+  settle (index, res, resolve, reject) {
+    const errors = res.errors.filter(e => !isInfo(e))
+    if (errors.length > 0) {
+      const e = errors[0]
+      e.batchIndex = index
+      reject(e)
+      return
+    }
+    const settled = {
+      first: null,
+      meta: [],
+      results: [],
+      counts: [],
+      info: res.errors.map(e => e.message)
+    }
+    res.results.forEach(r => {
+      if (r.meta) {
+        const rows = this.options.raw ? r.rows : this.connection.driverMgr.objectify(r)
+        settled.meta.push(r.meta)
+        settled.results.push(rows)
+        if (settled.first === null) settled.first = rows
+      } else {
+        settled.counts.push(r.rowcount)
+      }
+    })
+    resolve(settled)
+  }
+
+  submit () {
+    const settlers = []
+    const promises = this.entries.map(() => new Promise((resolve, reject) => {
+      settlers.push({ resolve, reject })
+    }))
+    if (this.entries.length === 0) return promises
+    try {
+      const native = this.entries.map(e => ({
+        query: this.connection.batchQueryObject(e.sql),
+        params: e.params || []
+      }))
+      this.connection.driverMgr.queryBatch(this.connection.getNotify(native[0].query), native, (err, res) => {
+        if (err) {
+          const e = Array.isArray(err) ? err[0] : err
+          settlers.forEach(s => s.reject(e))
+          return
+        }
+        res.forEach((r, i) => this.settle(i, r, settlers[i].resolve, settlers[i].reject))
+      })
+    } catch (e) {
+      settlers.forEach(s => s.reject(e))
+    }
+    return promises
+  }
+}
+
+module.exports = {
+  QueryBatch
+}
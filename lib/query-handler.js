@@ -1,5 +1,7 @@
 'use strict'
 
+const tvpStream = require('./tvp-stream')
+
 class QueryHandler {
   constructor (cppDriver) {
     this.cppDriver = cppDriver
@@ -32,9 +34,15 @@ class NativeQueryHandler extends QueryHandler {
   }
 
   begin (queryId, query, params, callback) {
-    this.cppDriver.query(queryId, query, params, (err, results, more) => {
+    tvpStream.prime(params).then(streamed => {
+      this.cppDriver.query(queryId, query, params, tvpStream.pump(this.cppDriver, queryId, streamed, (err, results, more) => {
+        if (callback) {
+          callback(err, results, more)
+        }
+      }))
+    }).catch(e => {
       if (callback) {
-        callback(err, results, more)
+        callback(e)
       }
     })
   }
@@ -53,9 +61,15 @@ class NativeProcedureQueryHandler extends QueryHandler {
   }
 
   begin (queryId, procedure, params, callback) {
-    this.cppDriver.callProcedure(queryId, procedure, params, (err, results, params) => {
+    tvpStream.prime(params).then(streamed => {
+      this.cppDriver.callProcedure(queryId, procedure, params, tvpStream.pump(this.cppDriver, queryId, streamed, (err, results, params) => {
+        if (callback) {
+          callback(err, results, params)
+        }
+      }))
+    }).catch(e => {
       if (callback) {
-        callback(err, results, params)
+        callback(e)
       }
     })
   }
@@ -63,7 +77,7 @@ class NativeProcedureQueryHandler extends QueryHandler {
   // for a stored procedure with multiple statements, only unbind after all
   // statements are completed
 
-  unbind (more, not, qid, results, callback) {
+  unbind (more, not, qid, results, callback, op) {
     this.cppDriver.unbind(qid, (err, outputVector) => {
       if (err && callback) {
         callback(err, results)
@@ -71,7 +85,7 @@ class NativeProcedureQueryHandler extends QueryHandler {
       not.emit('output', outputVector)
       this.onStatementCompleteHandler.onStatementComplete(not, outputVector, callback, results, more)
       if (!more) {
-        this.workQueue.nextOp()
+        this.workQueue.nextOp(op)
       }
     })
   }
@@ -79,8 +93,8 @@ class NativeProcedureQueryHandler extends QueryHandler {
   end (not, outputParams, callback, results, endMore) {
     if (!endMore) {
       const qid = not.getQueryId()
-      this.workQueue.enqueue(this.unbindEnum, (a) =>
-        setImmediate(() => { this.unbind(a, not, qid, results, callback) }), [endMore])
+      const op = this.workQueue.enqueue(this.unbindEnum, (a) =>
+        setImmediate(() => { this.unbind(a, not, qid, results, callback, op) }), [endMore], true)
     } else {
       this.onStatementCompleteHandler.onStatementComplete(not, null, callback, results, endMore)
     }
@@ -2,13 +2,16 @@
 
 const queueModule = ((() => {
   const priorityQueue = require('./data-struture/priority-queue/PriorityQueue')
+  const comparator = require('./data-struture/utils/comparator/Comparator')
   class WorkItem {
-    constructor (commandType, fn, args, operationId) {
+    constructor (commandType, fn, args, operationId, shared) {
       this.paused = false
       this.commandType = commandType
       this.fn = fn
       this.args = args
       this.operationId = operationId
+      this.shared = shared === true
+      this.started = false
     }
 
     run () {
@@ -20,6 +23,63 @@ const queueModule = ((() => {
     constructor () {
       this.workQueue = new priorityQueue.PriorityQueue()
       this.operationId = 0
+      this.depth = 1
+    }
+
+    // with a depth above one (the connection has MARS on) items marked shared - work on
+    // a statement of its own - run alongside each other up to depth at a time. anything
+    // else acts on the whole connection so waits for all ahead of it and runs alone.
+    setDepth (depth) {
+      this.depth = Math.max(1, depth || 1)
+    }
+
+    getDepth () {
+      return this.depth
+    }
+
+    pipelined () {
+      return this.depth > 1
+    }
+
+    ordered () {
+      return Array.from(this.workQueue.priorities.entries())
+        .sort((a, b) => a[1] - b[1])
+        .map(e => e[0])
+    }
+
+    schedule () {
+      const ops = this.ordered()
+      let active = ops.filter(op => op.started && !op.paused).length
+      for (const op of ops) {
+        if (op.started) {
+          if (!op.paused && !op.shared) break
+          continue
+        }
+        if (!op.shared) {
+          if (active === 0) {
+            op.started = true
+            op.run()
+          }
+          break
+        }
+        if (active >= this.depth) break
+        op.started = true
+        ++active
+        op.run()
+      }
+    }
+
+    // is the item with the driver now rather than waiting its turn.
+    isLive (item) {
+      if (this.pipelined()) {
+        return item.started
+      }
+      const peek = this.workQueue.peek()
+      return peek !== null && item.operationId === peek.operationId
+    }
+
+    removeItem (item) {
+      this.workQueue.remove(item, new comparator.Comparator(this.workQueue.compareValue))
     }
 
     emptyQueue () {
@@ -29,6 +89,11 @@ const queueModule = ((() => {
     }
 
     execQueueOp (op) {
+      if (this.pipelined()) {
+        this.workQueue.add(op, op.operationId)
+        this.schedule()
+        return
+      }
       const peek = this.workQueue.peek()
       this.workQueue.add(op, op.operationId)
       if (peek == null || peek.paused) {
@@ -36,9 +101,9 @@ const queueModule = ((() => {
       }
     }
 
-    enqueue (commandType, fn, args) {
+    enqueue (commandType, fn, args, shared) {
       const id = this.operationId
-      const op = new WorkItem(commandType, fn, args, id)
+      const op = new WorkItem(commandType, fn, args, id, shared)
       ++this.operationId
       this.execQueueOp(op)
       return op
@@ -47,6 +112,10 @@ const queueModule = ((() => {
     park (item) {
       this.workQueue.changePriority(item, Number.MAX_SAFE_INTEGER)
       item.paused = true
+      if (this.pipelined()) {
+        this.schedule()
+        return
+      }
       const peek = this.workQueue.peek()
       if (!peek.paused) {
         this.nextOp()
@@ -59,17 +128,33 @@ const queueModule = ((() => {
     }
 
     dropItem (item) {
+      if (this.pipelined()) {
+        this.removeItem(item)
+        this.schedule()
+        return this.workQueue
+      }
       return this.workQueue.remove(item)
     }
 
     exec () {
+      if (this.pipelined()) {
+        this.schedule()
+        return
+      }
       const op = this.workQueue.peek()
       if (op && !op.paused) {
         op.run()
       }
     }
 
-    nextOp () {
+    // the item completing - only needed when pipelined, otherwise it is always the head.
+    // with no item nothing is removed, the head may be a query still running beside it.
+    nextOp (item) {
+      if (this.pipelined()) {
+        if (item) this.removeItem(item)
+        this.schedule()
+        return
+      }
       this.workQueue.remove(this.workQueue.peek())
       this.exec()
     }
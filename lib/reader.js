@@ -7,6 +7,16 @@
 'use strict'
 
 const { BasePromises } = require('./base-promises')
+const { ColumnarView } = require('./columnar')
+
+const granularities = ['cell', 'row', 'batch', 'none']
+
+// what a read raises - 'cell' a 'row' then a 'column' per value, 'row' one 'row' carrying
+// the values, 'batch' one 'batch' per read and 'none' nothing, rows only reach the callback.
+function granularityOf (query) {
+  if (query && granularities.includes(query.granularity)) return query.granularity
+  return query && query.row_batches > 0 ? 'batch' : 'cell'
+}
 
 class DriverRead {
   constructor (cppDriver, queue) {
@@ -22,6 +32,16 @@ class DriverRead {
   // invokeObject.begin(queryId, query, params, onInvoke)
 
   getQuery (notify, query, params, invokeObject, callback) {
+    // dates are shifted to local time natively as they are read
+    if (query && typeof query === 'object') {
+      query.local_dates = this.useUTC === false
+      // arrow columns are typed from the declared sql type, numbers cannot arrive as strings
+      // other than decimals, which are read as text and kept as Utf8 so no digit is lost
+      if (query.columnar === 'arrow') {
+        query.numeric_string = false
+        query.decimal_string = true
+      }
+    }
     const q = new Query(this.native, this.useUTC, notify, this.workQueue, query, params, invokeObject, callback)
     notify.setQueryWorker(q)
     return q
@@ -51,6 +71,21 @@ class Query extends BasePromises {
     this.done = false
     this.infoFromNextResult = false
     this.rowBatchSize = 50 /* ignored for prepared statements */
+    // true for an ArrayBuffer per batch, 'shared' for a SharedArrayBuffer
+    this.columnar = query && query.columnar ? query.columnar : false
+    // rows per columnar or arrow batch, row_batches when the query gives it
+    this.columnarBatchSize = query && query.row_batches > 0 ? query.row_batches : 1000
+    this.columnarViews = []
+    this.arrowBatches = []
+    this.arrowSchemaSent = false
+    // the driver reads ahead of dispatch, it has to be told when the stream stops
+    this.prefetch = query && query.prefetch_depth > 0
+    this.granularity = granularityOf(query)
+    // rows per native read when handed out a batch at a time, see RowBatchStream
+    if (query && query.row_batches > 0) {
+      this.rowBatchSize = query.row_batches
+    }
+    this.reading = false
   }
 
   isInfo (err) {
@@ -94,9 +129,17 @@ class Query extends BasePromises {
     return this.op(cb => this.native.readColumn(queryId, rowBatchSize, cb))
   }
 
+  async nativeGetColumnar (queryId, rowBatchSize, shared) {
+    return this.op(cb => this.native.readColumnar(queryId, rowBatchSize, shared, cb))
+  }
+
+  async nativeGetArrow (queryId, rowBatchSize, withSchema) {
+    return this.op(cb => this.native.readArrow(queryId, rowBatchSize, withSchema, cb))
+  }
+
   close () {
     this.running = false
-    this.queue.nextOp()
+    this.queue.nextOp(this.notify.getOperation())
   }
 
   emitDone () {
@@ -164,30 +207,32 @@ class Query extends BasePromises {
     })
   }
 
-  dispatchRow (driverRow, currentRow) {
+  dispatchRow (driverRow) {
     for (let column = 0; column < driverRow.length; ++column) {
-      let rowColumn = driverRow[column]
-      if (rowColumn && this.useUTC === false) {
-        if (this.meta[column].type === 'date') {
-          rowColumn = new Date(rowColumn.getTime() - rowColumn.getTimezoneOffset() * -60000)
-        }
-      }
-      if (this.callback) {
-        currentRow[column] = rowColumn
-      }
-      this.notify.emit('column', column, rowColumn, false)
+      this.notify.emit('column', column, driverRow[column], false)
+    }
+  }
+
+  // the whole read goes out at once - as one event for 'batch', silently for 'none'.
+  dispatchBatch (results) {
+    this.batchData = null
+    const resultRows = results ? results.data : null
+    if (!resultRows || resultRows.length === 0) return
+    this.queryRowIndex += resultRows.length
+    if (this.callback) {
+      resultRows.forEach(r => this.rows.push(r))
+    }
+    if (this.granularity === 'batch') {
+      this.notify.emit('batch', resultRows)
     }
   }
 
-  getRow () {
+  getRow (driverRow) {
     this.batchRowIndex++
     this.queryRowIndex++
-    let currentRow
     if (this.callback) {
-      currentRow = []
-      this.rows.push(currentRow)
+      this.rows.push(driverRow)
     }
-    return currentRow
   }
 
   // console.log('fetch ', queryId)
@@ -198,11 +243,17 @@ class Query extends BasePromises {
     if (!resultRows) { return }
     const numberRows = resultRows.length
 
+    const cells = this.granularity === 'cell'
     while (!this.paused && this.batchRowIndex < numberRows) {
       const driverRow = resultRows[this.batchRowIndex]
-      this.notify.emit('row', this.queryRowIndex)
-      const currentRow = this.getRow()
-      this.dispatchRow(driverRow, currentRow)
+      if (cells) {
+        this.notify.emit('row', this.queryRowIndex)
+        this.getRow(driverRow)
+        this.dispatchRow(driverRow)
+      } else {
+        this.notify.emit('row', this.queryRowIndex, driverRow)
+        this.getRow(driverRow)
+      }
     }
   }
 
@@ -242,10 +293,16 @@ class Query extends BasePromises {
   }
 
   metaRows () {
-    return {
+    const res = {
       meta: this.meta,
       rows: this.rows
     }
+    if (this.columnar === 'arrow') {
+      res.arrow = this.arrowBatches
+    } else if (this.columnar) {
+      res.columnar = this.columnarViews
+    }
+    return res
   }
 
   moveToNextResult (nextResultSetInfo) {
@@ -276,6 +333,9 @@ class Query extends BasePromises {
         return
       }
       this.rows = []
+      this.columnarViews = []
+      this.arrowBatches = []
+      this.arrowSchemaSent = false
       if (nextResultSetInfo.endOfResults && nextResultSetInfo.endOfRows) {
         this.close()
       } else {
@@ -294,17 +354,79 @@ class Query extends BasePromises {
   dispatch () {
     if (!this.running) return
     if (this.paused) return // will come back at some later stage
+    if (this.reading) return // a resume while a read is out, it dispatches on return
+    if (this.columnar === 'arrow') {
+      this.dispatchArrow()
+      return
+    }
+    if (this.columnar) {
+      this.dispatchColumnar()
+      return
+    }
 
+    this.reading = true
     this.nativeGetRows(this.queryId, this.rowBatchSize).then(d => {
+      this.reading = false
       this.batchRowIndex = 0
       this.batchData = d
-      this.dispatchRows(d)
+      if (this.granularity === 'batch' || this.granularity === 'none') {
+        this.dispatchBatch(d)
+      } else {
+        this.dispatchRows(d)
+      }
+      if (!d.end_rows) {
+        this.dispatch()
+      } else {
+        this.nextResult()
+      }
+    }).catch(err => {
+      this.reading = false
+      this.end(err)
+    })
+  }
+
+  // each batch arrives as one buffer encoded on the driver thread - no per cell
+  // events are raised, the view is handed out whole.
+  dispatchColumnar () {
+    const shared = this.columnar === 'shared'
+    this.reading = true
+    this.nativeGetColumnar(this.queryId, this.columnarBatchSize, shared).then(d => {
+      this.reading = false
+      const view = new ColumnarView(d.columnar, this.meta)
+      if (view.rowCount > 0) {
+        this.columnarViews.push(view)
+        this.notify.emit('columnar', view)
+      }
       if (!d.end_rows) {
         this.dispatch()
       } else {
         this.nextResult()
       }
     }).catch(err => {
+      this.reading = false
+      this.end(err)
+    })
+  }
+
+  // each batch arrives as Arrow IPC messages encoded on the driver thread, the schema
+  // asked for with the first batch of each result set.
+  dispatchArrow () {
+    const withSchema = !this.arrowSchemaSent
+    this.arrowSchemaSent = true
+    this.reading = true
+    this.nativeGetArrow(this.queryId, this.columnarBatchSize, withSchema).then(d => {
+      this.reading = false
+      if (d.arrow && d.arrow.length > 0) {
+        this.arrowBatches.push(d.arrow)
+        this.notify.emit('arrow', d.arrow)
+      }
+      if (!d.end_rows) {
+        this.dispatch()
+      } else {
+        this.nextResult()
+      }
+    }).catch(err => {
+      this.reading = false
       this.end(err)
     })
   }
@@ -341,6 +463,9 @@ class Query extends BasePromises {
   pause () {
     if (this.paused) return
     this.paused = true
+    if (this.prefetch) {
+      this.native.pausePrefetch(this.queryId)
+    }
     this.queue.park(this.notify.getOperation())
   }
 
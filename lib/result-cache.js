@@ -0,0 +1,145 @@
+'use strict'
+
+// reads given a ttlMs are kept by the native ResultCache (src/ResultCache.h) as the columnar
+// batches the driver encodes, so the cached bytes live outside the js heap and a hit builds
+// its rows straight from them. an entry is keyed by the sql and serialised params and is
+// dropped by the same sql and params or by any of the tags it was stored with.
+//
+// the columnar form keeps a date as its milliseconds - the nanosecondsDelta and the local
+// time shift the row path gives are lost - so sql that returns a date or time column is
+// not cached. sql is read the ordinary way the first time it is seen and its columns decide
+// whether it is read columnar and cached from then on, so a miss never costs a second round
+// trip. a bigint is held as the row path gives it, a Number unless numeric_string has it
+// read as exact text.
+
+const { ColumnarView } = require('./columnar')
+const { serialise } = require('./single-flight')
+
+class ResultCache {
+  constructor (cppDriver, maxBytes) {
+    this.native = new cppDriver.ResultCache(maxBytes)
+    // moved on by every invalidate, a miss still running when it moves does not store
+    // what it read as it may be from before the write the invalidate was for.
+    this.generation = 0
+    this.cacheable = new Set()
+    this.uncacheable = new Set()
+  }
+
+  // null when the request can not be keyed e.g. a param that will not serialise.
+  keyOf (sql, params) {
+    try {
+      return serialise([sql, params || []])
+    } catch (e) {
+      return null
+    }
+  }
+
+  bypassed (sql) {
+    return this.uncacheable.has(this.sqlOf(sql))
+  }
+
+  vetted (sql) {
+    return this.cacheable.has(this.sqlOf(sql))
+  }
+
+  sqlOf (sql) {
+    return typeof sql === 'string' ? sql : sql.query_str
+  }
+
+  // false, and the sql is read uncached from now on, when a result set has a column the
+  // columnar form can not hand back as the row path would.
+  vet (sql, metas) {
+    const exact = metas.every(meta => meta.every(m => m.type !== 'date'))
+    if (exact) {
+      this.cacheable.add(this.sqlOf(sql))
+    } else {
+      this.cacheable.delete(this.sqlOf(sql))
+      this.uncacheable.add(this.sqlOf(sql))
+    }
+    return exact
+  }
+
+  // a miss is read as columnar batches, the form that is stored.
+  columnarQuery (sql) {
+    const queryObj = typeof sql === 'string' ? { query_str: sql } : Object.assign({}, sql)
+    queryObj.columnar = true
+    return queryObj
+  }
+
+  // each result set as its meta and the views over its batches.
+  setsOf (res) {
+    return res.meta.map((meta, i) => ({ meta, views: res.columnar[i] || [] }))
+  }
+
+  put (key, options, sets, counts) {
+    const batches = []
+    const info = {
+      meta: sets.map(s => s.meta),
+      batches: sets.map(s => s.views.length),
+      counts
+    }
+    sets.forEach(s => s.views.forEach(v => batches.push(Buffer.from(v.buffer))))
+    return this.native.put(key, options.ttlMs, options.tags || [], JSON.stringify(info), batches)
+  }
+
+  get (key) {
+    const hit = this.native.get(key)
+    if (!hit) return null
+    const info = JSON.parse(hit.info)
+    let next = 0
+    const sets = info.meta.map((meta, i) => {
+      const views = hit.batches.slice(next, next + info.batches[i]).map(b => new ColumnarView(b, meta))
+      next += info.batches[i]
+      return { meta, views }
+    })
+    return { sets, counts: info.counts }
+  }
+
+  // rows are built from the batches for a miss as well as a hit, so both look the same. a
+  // binary cell is a view of the batch, which for a hit is the cached storage itself, so it
+  // is copied - a caller writing to its Buffer must not change what the next hit reads.
+  materialise (ret, sets, counts) {
+    sets.forEach(s => {
+      ret.onMeta(s.meta)
+      s.views.forEach(v => ret.onBatch(this.ownRows(v)))
+    })
+    ret.counts = counts.slice()
+    ret.onDone()
+    ret.end()
+    return ret
+  }
+
+  ownRows (view) {
+    const rows = view.rows()
+    rows.forEach(row => row.forEach((cell, c) => {
+      if (Buffer.isBuffer(cell)) row[c] = Buffer.from(cell)
+    }))
+    return rows
+  }
+
+  invalidate (sql, params) {
+    ++this.generation
+    const key = this.keyOf(sql, params)
+    return key !== null && this.native.invalidate(key)
+  }
+
+  invalidateTag (tag) {
+    ++this.generation
+    return this.native.invalidateTag(tag)
+  }
+
+  clear () {
+    ++this.generation
+    this.cacheable.clear()
+    this.uncacheable.clear()
+    this.native.clear()
+  }
+
+  getStats () {
+    return this.native.getStats()
+  }
+}
+
+module.exports = {
+  ResultCache
+}
@@ -0,0 +1,108 @@
+'use strict'
+
+// async iterator over a query submitted with row_batches - each native read is handed out
+// whole as one batch and no per cell events are raised. the query is paused once
+// highWaterMark batches are waiting so the driver only reads on as the consumer pulls.
+
+const defaultBatchRows = 1000
+const defaultHighWaterMark = 1
+
+class RowBatchStream {
+  constructor (q, options) {
+    options = options || {}
+    this.q = q
+    this.highWaterMark = options.highWaterMark || defaultHighWaterMark
+    this.batches = []
+    this.waiting = null
+    this.meta = null
+    this.resultId = -1
+    this.paused = false
+    this.ended = false
+    this.error = null
+    this.onMeta = meta => {
+      this.meta = meta
+      ++this.resultId
+    }
+    this.onBatch = rows => this.push(rows)
+    this.onError = (e, more) => {
+      this.error = this.error || e
+      if (!more) this.finish()
+    }
+    this.onDone = () => this.finish()
+    q.on('meta', this.onMeta)
+    q.on('batch', this.onBatch)
+    q.on('error', this.onError)
+    q.on('done', this.onDone)
+  }
+
+  push (rows) {
+    this.batches.push({ meta: this.meta, resultId: this.resultId, rows })
+    if (!this.paused && this.batches.length >= this.highWaterMark) {
+      this.paused = true
+      this.q.pauseQuery()
+    }
+    this.wake()
+  }
+
+  finish () {
+    if (this.ended) return
+    this.ended = true
+    this.q.removeListener('meta', this.onMeta)
+    this.q.removeListener('batch', this.onBatch)
+    this.q.removeListener('error', this.onError)
+    this.q.removeListener('done', this.onDone)
+    this.wake()
+  }
+
+  wake () {
+    if (!this.waiting) return
+    const resolve = this.waiting
+    this.waiting = null
+    resolve()
+  }
+
+  async next () {
+    while (this.batches.length === 0 && !this.ended) {
+      await new Promise(resolve => { this.waiting = resolve })
+    }
+    if (this.batches.length > 0) {
+      const value = this.batches.shift()
+      if (this.paused && this.batches.length < this.highWaterMark) {
+        this.paused = false
+        this.q.resumeQuery()
+      }
+      return { value, done: false }
+    }
+    if (this.error) {
+      const e = this.error
+      this.error = null
+      throw e
+    }
+    return { value: undefined, done: true }
+  }
+
+  // the consumer left early - cancel so the connection is not held by unread rows.
+  async return () {
+    this.batches = []
+    if (!this.ended) {
+      this.finish()
+      await new Promise(resolve => {
+        try {
+          this.q.cancelQuery(() => resolve())
+        } catch (e) {
+          resolve()
+        }
+      })
+    }
+    return { value: undefined, done: true }
+  }
+
+  [Symbol.asyncIterator] () {
+    return this
+  }
+}
+
+module.exports = {
+  RowBatchStream,
+  defaultBatchRows
+}
@@ -0,0 +1,77 @@
+'use strict'
+
+// identical reads submitted while one is already running join it rather than taking a
+// connection of their own - a flight is keyed by the sql text and the serialised params
+// and lives only until it settles, so nothing is cached beyond the one execution. the
+// result handed to every waiter is frozen as they all share the same object.
+
+// a value json would write the same as one of another type is tagged with its type - a
+// bigint and the string of its digits, a Date and its iso string, a Buffer and the plain
+// object it writes as. plain objects are tagged too, their properties as pairs, so none
+// can pass for a tagged value. toJSON has already run on the value the replacer is given,
+// the original is read from the holder.
+function tagged (o) {
+  if (typeof o === 'bigint') return { t: 'bigint', v: o.toString() }
+  if (o instanceof Date) return { t: 'date', v: o.getTime(), ns: o.nanosecondsDelta || 0 }
+  if (Buffer.isBuffer(o)) return { t: 'buf', v: o.toString('hex') }
+  if (ArrayBuffer.isView(o)) {
+    return { t: o.constructor.name, v: Buffer.from(o.buffer, o.byteOffset, o.byteLength).toString('hex') }
+  }
+  if (o !== null && typeof o === 'object' && !Array.isArray(o)) return { t: 'obj', v: Object.entries(o) }
+  return o
+}
+
+function serialise (v) {
+  return JSON.stringify(v, function (k) { return tagged(this[k]) })
+}
+
+function deepFreeze (o) {
+  if (o === null || typeof o !== 'object' || Object.isFrozen(o) || ArrayBuffer.isView(o)) {
+    return o
+  }
+  Object.freeze(o)
+  Object.keys(o).forEach(k => deepFreeze(o[k]))
+  return o
+}
+
+class SingleFlight {
+  constructor () {
+    this.flights = new Map()
+    this.joined = 0
+  }
+
+  // null when the request can not be keyed e.g. a param that will not serialise.
+  keyOf (sql, params, options) {
+    try {
+      const o = options || {}
+      return serialise([sql, params || [], !!o.raw, !!o.replaceEmptyColumnNames, o.timeoutMs || 0])
+    } catch (e) {
+      return null
+    }
+  }
+
+  async run (key, fn) {
+    const inflight = this.flights.get(key)
+    if (inflight) {
+      ++this.joined
+      return inflight
+    }
+    const flight = fn().then(res => deepFreeze(res))
+    this.flights.set(key, flight)
+    const forget = () => this.flights.delete(key)
+    flight.then(forget, forget)
+    return flight
+  }
+
+  stats () {
+    return {
+      inflight: this.flights.size,
+      joined: this.joined
+    }
+  }
+}
+
+module.exports = {
+  SingleFlight,
+  serialise
+}
@@ -128,6 +128,14 @@ class SqlClient {
     return c.connection
   }
 
+  adopt (params, pool, slot, callback) {
+    const c = new PrivateConnection(sqlMeta, userTypes, 'adopt', this.getConnectObject(params), callback, this.nextID)
+    this.nextID += 1
+    c.adopt(pool, slot)
+
+    return c.connection
+  }
+
   query (connectDetails, queryOrObj, paramsOrCallback, callback) {
     return this.queryCloseOnDone('query', (conn, notify, args) => conn.queryNotify(notify, queryOrObj, args), connectDetails, queryOrObj, paramsOrCallback, callback)
   }
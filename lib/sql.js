@@ -87,4 +87,7 @@ exports.TzOffsetQuery = us.TzOffsetQuery
 
 exports.Table = us.Table
 exports.TvpFromTable = us.TvpFromTable
+exports.TvpStream = us.TvpStream
+exports.BindRows = us.BindRows
 exports.Pool = pm.Pool
+exports.ColumnarView = require('./columnar').ColumnarView
@@ -1,6 +1,8 @@
 'use strict'
 
 const { BasePromises } = require('./base-promises')
+const { readArrowStream } = require('./arrow-reader')
+
 class BulkPromises extends BasePromises {
   constructor (bulk) {
     super()
@@ -22,6 +24,10 @@ class BulkPromises extends BasePromises {
   async update (rows) {
     return this.op(cb => this.bulk.updateRows(rows, cb))
   }
+
+  async insertArrow (ipcBuffer) {
+    return this.op(cb => this.bulk.insertArrow(ipcBuffer, cb))
+  }
 }
 
 class TableTypedParam {
@@ -93,38 +99,6 @@ class TableBulkOpMgr {
     return `CREATE TYPE ${name} AS TABLE (${declarations})`
   }
 
-  // create an object of arrays where each array represents all values
-  // for the batch.
-
-  prepare () {
-    const names = this.meta.assignableColumnNames
-    const vecs = names.reduce((agg, name) => {
-      agg[name] = []
-      return agg
-    }, {})
-    return {
-      keys: names,
-      arrays_by_name: vecs
-    }
-  }
-
-  deconstructToArrays (res, instance) {
-    res.keys.reduce((agg, property) => {
-      const columnValues = agg[property]
-      const val = this.hasProp(instance, property)
-        ? instance[property]
-        : null
-      columnValues.push(val)
-      return agg
-    }, res.arrays_by_name)
-  }
-
-  arrayPerColumn (vec) {
-    const res = this.prepare()
-    vec.forEach(instance => { this.deconstructToArrays(res, instance) })
-    return res
-  }
-
   // if batch size is set, split the input into that batch size.
 
   rowBatches (rows) {
@@ -145,25 +119,22 @@ class TableBulkOpMgr {
     return batches
   }
 
-  // driver will have to recognise this is an array of arrays where each array
-  // represents all values for that particular column.
-
-  hasProp (parent, name) {
-    return Object.prototype.hasOwnProperty.call(parent, name)
-  }
+  // the rows go to the driver as they are, it reads each one once and binds a parameter
+  // per column - typed from the table meta unless that has been turned off.
 
   arrayPerColumnForCols (rows, colSubSet, usebcp) {
-    const dataColsByName = this.arrayPerColumn(rows).arrays_by_name
-    return colSubSet.reduce((agg, col) => {
-      if (this.hasProp(dataColsByName, col.name)) {
-        const valueVector = dataColsByName[col.name]
-        const v = this.usetMetaType
-          ? new TableTypedParam(col, valueVector, usebcp, this.bcpVersion, this.meta.bcpTableName)
-          : valueVector
-        agg.push(v)
-      }
-      return agg
-    }, [])
+    const names = this.meta.assignableColumnNames
+    const columns = colSubSet
+      .filter(col => names.includes(col.name))
+      .map(col => {
+        return {
+          key: col.name,
+          param: this.usetMetaType
+            ? new TableTypedParam(col, null, usebcp, this.bcpVersion, this.meta.bcpTableName)
+            : null
+        }
+      })
+    return [this.user.BindRows(rows, columns)]
   }
 
   // given the input array of asObjects consisting of potentially all columns, strip out
@@ -194,6 +165,58 @@ class TableBulkOpMgr {
     this.runOp(rows, this.summary.insertSignature, this.summary.assignableColumns, this.bcp, callback)
   }
 
+  // the table columns are matched by name to the fields of an arrow ipc stream and each
+  // record batch is one insert, its columns bound from the arrow buffers rather than rows.
+
+  arrowColumnsForBatch (fields, batch) {
+    return this.summary.assignableColumns.map(col => {
+      const i = fields.findIndex(f => f.name === col.name)
+      if (i < 0) {
+        throw new Error(`arrow: stream has no column ${col.name}`)
+      }
+      const param = new TableTypedParam(col, null, this.bcp, this.bcpVersion, this.meta.bcpTableName)
+      param.arrow = batch.columns[i]
+      return param
+    })
+  }
+
+  insertArrow (ipcBuffer, callback) {
+    let params
+    try {
+      const { fields, batches } = readArrowStream(ipcBuffer)
+      params = batches
+        .filter(b => b.length > 0)
+        .map(b => this.arrowColumnsForBatch(fields, b))
+    } catch (e) {
+      callback(e, null)
+      return
+    }
+    this.insertArrowBatches(params)
+      .then(res => {
+        callback(null, res)
+      }).catch(e => callback(e, null))
+  }
+
+  // the batches go in one transaction so a stream is inserted whole or not at all - when
+  // the caller already has a transaction open the inserts join it and it is theirs to end.
+  async insertArrowBatches (params) {
+    const conn = this.theConnection.promises
+    const state = await conn.query('SELECT @@TRANCOUNT AS n, @@OPTIONS & 2 AS implicit')
+    const own = state.first[0].n === 0 && state.first[0].implicit === 0
+    if (own) await conn.beginTransaction()
+    try {
+      const res = []
+      for (const p of params) {
+        res.push(await conn.query(this.summary.insertSignature, p))
+      }
+      if (own) await conn.commit()
+      return res
+    } catch (e) {
+      if (own) await conn.rollback().catch(() => {})
+      throw e
+    }
+  }
+
   deleteRows (rows, callback) {
     this.runOp(rows, this.summary.deleteSignature, this.summary.assignableColumns, false, callback)
   }
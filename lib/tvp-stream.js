@@ -0,0 +1,153 @@
+'use strict'
+
+// a table valued parameter read from an iterator a chunk at a time. the first chunk is read
+// before the statement is sent and bound with it, the driver then parks in SQLParamData and
+// each further chunk is pushed with sendTvpRows into the same column buffers - memory is
+// one chunk of rows however many the source yields.
+
+const defaultChunkRows = 1000
+// a max column has no declared width, values up to this many bytes are carried per row.
+const defaultMaxBytes = 8000
+
+class TvpStreamSource {
+  // types gives the column binding of a declared type and the bind rows parameter.
+  constructor (table, source, options, types) {
+    options = options || {}
+    this.table = table
+    this.source = source
+    this.chunkRows = options.chunkRows || defaultChunkRows
+    this.maxBytes = options.maxBytes || defaultMaxBytes
+    this.types = types
+    this.iterator = null
+    this.ended = false
+  }
+
+  // bytes reserved per row for the column, and whether its declared type is max.
+  width (col) {
+    const ty = col.type || {}
+    switch (ty.declaration) {
+      case 'uniqueidentifier':
+        // bound as the 36 character string form, not the 16 stored bytes.
+        return { width: 36, max: false }
+      case 'text':
+      case 'ntext':
+      case 'image':
+        return { width: this.maxBytes, max: true }
+      default:
+        return ty.length > 0
+          ? { width: ty.length, max: false }
+          : { width: this.maxBytes, max: true }
+    }
+  }
+
+  // the chunk is transposed by the driver, the column params are made once per stream.
+  columns (rows) {
+    if (!this.params) {
+      this.params = this.table.columns.map(col => {
+        const { scale, precision, type: ty } = col
+        const param = this.types.toColumn({ scale, precision, ...ty }, null)
+        const { width, max } = this.width(col)
+        param.stream_width = width
+        param.stream_max = max
+        return param
+      })
+    }
+    return this.types.bindRows(rows, this.table.columns.map((col, c) => {
+      return { key: col.name, param: Object.assign({}, this.params[c]) }
+    }))
+  }
+
+  async read () {
+    if (!this.iterator) {
+      const s = this.source
+      this.iterator = s[Symbol.asyncIterator] ? s[Symbol.asyncIterator]() : s[Symbol.iterator]()
+    }
+    const rows = []
+    while (!this.ended && rows.length < this.chunkRows) {
+      const next = await this.iterator.next()
+      if (next.done) {
+        this.ended = true
+      } else {
+        rows.push(next.value)
+      }
+    }
+    return rows
+  }
+
+  // the chunk as a tvp the driver binds - row_count is the capacity the stream is bound with.
+  chunk (param, rows) {
+    return Object.assign(param, {
+      tvp_stream: true,
+      tvp_stream_rows: rows.length,
+      tvp_stream_end: this.ended,
+      row_count: this.chunkRows,
+      table_value_param: rows.length > 0 ? this.columns(rows) : []
+    })
+  }
+
+  header (param) {
+    const { sql_type, table_name, type_id, is_user_defined, is_output, schema } = param
+    return { sql_type, table_name, type_id, is_user_defined, is_output, schema }
+  }
+
+  async first (param) {
+    if (this.iterator) {
+      throw new Error('a streamed table valued parameter can only be sent once')
+    }
+    const rows = await this.read()
+    if (rows.length === 0) {
+      // nothing to stream, sent as an ordinary empty table.
+      return Object.assign(param, {
+        tvp_stream: false,
+        row_count: 0,
+        table_value_param: this.columns([])
+      })
+    }
+    return this.chunk(param, rows)
+  }
+
+  async next (param) {
+    const rows = await this.read()
+    return this.chunk(this.header(param), rows)
+  }
+}
+
+function find (params) {
+  if (!Array.isArray(params)) return null
+  return params.find(p => p && p.tvp_stream && p.stream instanceof TvpStreamSource) || null
+}
+
+// read the first chunk into the parameter before the statement is sent.
+async function prime (params) {
+  const param = find(params)
+  if (!param) return null
+  await param.stream.first(param)
+  return param.tvp_stream ? param : null
+}
+
+// wrap the native callback so each completion asking for rows is answered with the next
+// chunk, the caller sees only the completion of the statement itself.
+function pump (native, queryId, param, callback) {
+  if (!param) return callback
+  const onResult = (err, results, ...rest) => {
+    if (err || !results || !results.tvp_need_rows) {
+      callback(err, results, ...rest)
+      return
+    }
+    param.stream.next(param).then(chunk => {
+      native.sendTvpRows(queryId, [chunk], onResult)
+    }).catch(e => {
+      // the source failed - cancel the parked execute, the error reported is the source's own.
+      native.cancelQuery(queryId, () => {
+        native.sendTvpRows(queryId, [param.stream.chunk(param.stream.header(param), [])], () => callback(e))
+      })
+    })
+  }
+  return onResult
+}
+
+module.exports = {
+  TvpStreamSource,
+  prime,
+  pump
+}
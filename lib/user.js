@@ -1,5 +1,7 @@
 'use strict'
 
+const { TvpStreamSource } = require('./tvp-stream')
+
 const userModule = ((() => {
   /*
  sql.UDT(value)
@@ -319,19 +321,6 @@ const userModule = ((() => {
       }
     }
 
-    function fromRow (rows, c) {
-      let v
-      if (rows.length === 1) {
-        v = rows[0][c]
-      } else {
-        v = []
-        for (let r = 0; r < rows.length; ++r) {
-          v[v.length] = rows[r][c]
-        }
-      }
-      return v
-    }
-
     function Table (typeName, cols) {
       const rows = []
       const columns = []
@@ -375,6 +364,17 @@ const userModule = ((() => {
       }
     }
 
+    // rows (objects read by key, arrays by position) bound as one parameter per column -
+    // the driver transposes them as it binds, each column's param gives its type and is
+    // handed the column of values, a column without a param is bound by value alone.
+    function BindRows (rows, columns) {
+      return {
+        bind_rows: true,
+        rows,
+        columns
+      }
+    }
+
     function TvpFromTable (p) {
       const tp = {
         sql_type: SQL_SS_TABLE,
@@ -390,22 +390,42 @@ const userModule = ((() => {
       if (Object.prototype.hasOwnProperty.call(p, 'columns') &&
         Object.prototype.hasOwnProperty.call(p, 'rows')) {
         const cols = p.columns
-        const rows = p.rows
+        // the row references are copied so the table can be reset once this returns.
+        const rows = p.rows.slice()
         tp.row_count = rows.length
-        for (let c = 0; c < cols.length; ++c) {
-          const v = rows.length > 0 ? fromRow(rows, c) : []
-          const { scale, precision, type: ty } = cols[c]
-          tp.table_value_param[c] = getSqlTypeFromDeclaredType({
-            scale,
-            precision,
-            ...ty
-          }, v)
-        }
+        tp.table_value_param = BindRows(rows, cols.map(col => {
+          const { scale, precision, type: ty } = col
+          return {
+            key: col.name,
+            param: getSqlTypeFromDeclaredType({ scale, precision, ...ty }, null)
+          }
+        }))
       }
 
       return tp
     }
 
+    // the rows of a user table type read from an iterator or async iterator of row arrays
+    // or objects, chunkRows at a time, rather than materialised up front as TvpFromTable.
+    function TvpStream (p, source, options) {
+      return {
+        sql_type: SQL_SS_TABLE,
+        table_name: p.name,
+        type_id: p.name,
+        is_user_defined: true,
+        is_output: false,
+        value: p,
+        table_value_param: [],
+        row_count: 0,
+        schema: p.schema || 'dbo',
+        tvp_stream: true,
+        stream: new TvpStreamSource(p, source, options, {
+          toColumn: getSqlTypeFromDeclaredType,
+          bindRows: BindRows
+        })
+      }
+    }
+
     function getSqlTypeFromDeclaredType (dt, p) {
       const type = dt.declaration || dt.type || dt.type_id
       switch (type) {
@@ -527,6 +547,8 @@ const userModule = ((() => {
       SmallDateTime: DateTime2,
       DateTimeOffset,
       TvpFromTable,
+      TvpStream,
+      BindRows,
       Table,
       getSqlTypeFromDeclaredType
     }
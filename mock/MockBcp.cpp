@@ -0,0 +1,102 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: MockBcp.cpp
+// Contents: bcp_* exports of the mock driver, found by the addon through MSNODESQLV8_BCP_LIBRARY
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#include "MockDriver.h"
+#include <cstring>
+
+// the addon hands bcp_* the driver manager's connection handle, which the mock cannot
+// map back to its own Dbc. a bulk copy runs start to finish on one worker thread, so
+// the state is kept per thread instead.
+
+namespace mock
+{
+	struct BcpColumn
+	{
+		const unsigned char* data;
+		int prefix;
+		int length;
+		int type;
+	};
+
+	struct BcpState
+	{
+		bool active = false;
+		string table;
+		vector<BcpColumn> columns;
+		vector<char> wire;
+		int rows = 0;
+	};
+
+	static thread_local BcpState bcp_state;
+
+	static constexpr short bcp_succeed = 1;
+	static constexpr short bcp_fail = 0;
+}
+
+using namespace mock;
+
+extern "C" {
+
+short bcp_initW(void*, const SQLWCHAR* table, const SQLWCHAR*, const SQLWCHAR*, int)
+{
+	bcp_state = BcpState();
+	bcp_state.active = true;
+	bcp_state.table = narrow(table, SQL_NTS);
+	return bcp_succeed;
+}
+
+short bcp_bind(void*, const unsigned char* data, const int prefix, const int length, const unsigned char*, int, const int type, const int column)
+{
+	if (!bcp_state.active || column < 1) return bcp_fail;
+	if (bcp_state.columns.size() < static_cast<size_t>(column)) bcp_state.columns.resize(column);
+	bcp_state.columns[column - 1] = { data, prefix, length, type };
+	return bcp_succeed;
+}
+
+// reads each bound value as the real driver would to build the row, then drops it.
+int bcp_sendrow(void*)
+{
+	if (!bcp_state.active) return bcp_fail;
+	bcp_state.wire.clear();
+	for (const auto& c : bcp_state.columns)
+	{
+		if (!c.data) continue;
+		SQLLEN n = c.length;
+		if (c.prefix == static_cast<int>(sizeof(SQLLEN)))
+		{
+			memcpy(&n, c.data, sizeof(SQLLEN));
+		}
+		if (n == SQL_NULL_DATA) continue;
+		if (n < 0) n = 0;
+		const auto* value = reinterpret_cast<const char*>(c.data + c.prefix);
+		bcp_state.wire.insert(bcp_state.wire.end(), value, value + n);
+	}
+	++bcp_state.rows;
+	return bcp_succeed;
+}
+
+int bcp_done(void*)
+{
+	if (!bcp_state.active) return -1;
+	const auto rows = bcp_state.rows;
+	bcp_state = BcpState();
+	return rows;
+}
+
+}
@@ -0,0 +1,679 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: MockData.cpp
+// Contents: result set specification, synthetic values and their conversion to the bound C types
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#include "MockDriver.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+namespace mock
+{
+	static string lower(string s)
+	{
+		transform(s.begin(), s.end(), s.begin(), [](const unsigned char c) { return static_cast<char>(tolower(c)); });
+		return s;
+	}
+
+	static string trim(const string& s)
+	{
+		const auto first = s.find_first_not_of(" \t\r\n");
+		if (first == string::npos) return "";
+		const auto last = s.find_last_not_of(" \t\r\n");
+		return s.substr(first, last - first + 1);
+	}
+
+	// printable and varied, so string interning and utf8 paths see realistic input.
+	static string make_pattern(const size_t length, const size_t column)
+	{
+		static const char alphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 ";
+		string pattern(length + 64, ' ');
+		for (size_t i = 0; i < pattern.size(); ++i)
+		{
+			pattern[i] = alphabet[(i * 7 + column * 13) % (sizeof(alphabet) - 1)];
+		}
+		return pattern;
+	}
+
+	// type[(size[,scale])] with an optional name: prefix, e.g. id:int or nvarchar(max)
+	static bool parse_column(const string& text, const size_t index, Column& column, const size_t lob_length, string& problem)
+	{
+		auto spec = trim(text);
+		const auto colon = spec.find(':');
+		column.name = colon == string::npos ? "c" + to_string(index) : trim(spec.substr(0, colon));
+		if (colon != string::npos) spec = trim(spec.substr(colon + 1));
+		string type = lower(spec);
+		string args;
+		const auto open = type.find('(');
+		if (open != string::npos)
+		{
+			const auto close = type.find(')', open);
+			if (close == string::npos)
+			{
+				problem = "unbalanced ( in column " + text;
+				return false;
+			}
+			args = type.substr(open + 1, close - open - 1);
+			type = trim(type.substr(0, open));
+		}
+		const auto comma = args.find(',');
+		const auto first = trim(args.substr(0, comma));
+		const auto is_max = first == "max";
+		const size_t size = first.empty() || is_max ? 0 : strtoul(first.c_str(), nullptr, 10);
+		const auto scale = comma == string::npos ? 0 : static_cast<SQLSMALLINT>(atoi(args.substr(comma + 1).c_str()));
+
+		column.type_name = type;
+		column.scale = 0;
+		if (type == "bit") { column.kind = Kind::Bit; column.sql_type = SQL_BIT; column.column_size = 1; }
+		else if (type == "int") { column.kind = Kind::Int; column.sql_type = SQL_INTEGER; column.column_size = 10; }
+		else if (type == "bigint") { column.kind = Kind::BigInt; column.sql_type = SQL_BIGINT; column.column_size = 19; }
+		else if (type == "float") { column.kind = Kind::Double; column.sql_type = SQL_FLOAT; column.column_size = 53; }
+		else if (type == "decimal" || type == "numeric")
+		{
+			column.kind = Kind::Decimal;
+			column.sql_type = type == "decimal" ? SQL_DECIMAL : SQL_NUMERIC;
+			column.column_size = size ? min<size_t>(size, 38) : 18;
+			column.scale = scale;
+		}
+		else if (type == "nvarchar" || type == "nchar" || type == "varchar" || type == "char")
+		{
+			const auto wide = type[0] == 'n';
+			column.kind = wide ? Kind::WChar : Kind::Char;
+			column.sql_type = is_max
+				? (wide ? SQL_WLONGVARCHAR : SQL_LONGVARCHAR)
+				: (wide ? SQL_WVARCHAR : SQL_VARCHAR);
+			column.column_size = is_max ? 0 : (size ? size : 1);
+			column.length = is_max ? lob_length : column.column_size;
+		}
+		else if (type == "varbinary" || type == "binary")
+		{
+			column.kind = Kind::Binary;
+			column.sql_type = is_max ? SQL_LONGVARBINARY : SQL_VARBINARY;
+			column.column_size = is_max ? 0 : (size ? size : 1);
+			column.length = is_max ? lob_length : column.column_size;
+		}
+		else if (type == "datetime2" || type == "datetime")
+		{
+			column.kind = Kind::Timestamp;
+			column.sql_type = SQL_TYPE_TIMESTAMP;
+			column.column_size = 27;
+			column.scale = 7;
+		}
+		else if (type == "date")
+		{
+			column.kind = Kind::Date;
+			column.sql_type = SQL_TYPE_DATE;
+			column.column_size = 10;
+		}
+		else
+		{
+			problem = "unsupported column type " + text;
+			return false;
+		}
+		column.pattern = make_pattern(column.length, index);
+		return true;
+	}
+
+	bool Spec::parse_columns(const string& value, string& problem)
+	{
+		vector<Column> parsed;
+		size_t depth = 0;
+		size_t start = 0;
+		for (size_t i = 0; i <= value.size(); ++i)
+		{
+			if (i < value.size())
+			{
+				if (value[i] == '(') ++depth;
+				else if (value[i] == ')' && depth) --depth;
+				if (value[i] != ',' || depth) continue;
+			}
+			Column column;
+			if (!parse_column(value.substr(start, i - start), parsed.size(), column, lob_length, problem)) return false;
+			parsed.push_back(std::move(column));
+			start = i + 1;
+		}
+		columns = std::move(parsed);
+		return true;
+	}
+
+	bool Spec::apply(const string& key, const string& value, string& problem)
+	{
+		const auto k = lower(key);
+		if (k == "rows") rows = strtoull(value.c_str(), nullptr, 10);
+		else if (k == "columns") return parse_columns(value, problem);
+		else if (k == "nullratio") null_ratio = min(1.0, max(0.0, atof(value.c_str())));
+		else if (k == "seed") seed = strtoull(value.c_str(), nullptr, 10);
+		else if (k == "results") results = max<uint32_t>(1, static_cast<uint32_t>(strtoul(value.c_str(), nullptr, 10)));
+		else if (k == "delay") delay_ms = static_cast<uint32_t>(strtoul(value.c_str(), nullptr, 10));
+		else if (k == "loblength")
+		{
+			lob_length = strtoul(value.c_str(), nullptr, 10);
+			for (auto& column : columns)
+			{
+				if (column.column_size == 0 && (column.kind == Kind::WChar || column.kind == Kind::Char || column.kind == Kind::Binary))
+				{
+					column.length = lob_length;
+					column.pattern = make_pattern(lob_length, &column - columns.data());
+				}
+			}
+		}
+		else if (k == "error") error = value;
+		return true;
+	}
+
+	// key=value;... - braces quote a value containing ; as in any connection string.
+	// keys the mock does not know (Driver, Server, ...) are ignored.
+	bool parse_settings(const string& text, Spec& spec, string& problem)
+	{
+		size_t i = 0;
+		while (i < text.size())
+		{
+			const auto eq = text.find('=', i);
+			if (eq == string::npos) break;
+			const auto key = trim(text.substr(i, eq - i));
+			auto j = eq + 1;
+			while (j < text.size() && isspace(static_cast<unsigned char>(text[j]))) ++j;
+			string value;
+			if (j < text.size() && text[j] == '{')
+			{
+				const auto close = text.find('}', j);
+				value = text.substr(j + 1, (close == string::npos ? text.size() : close) - j - 1);
+				j = close == string::npos ? text.size() : close + 1;
+				const auto semi = text.find(';', j);
+				i = semi == string::npos ? text.size() : semi + 1;
+			}
+			else
+			{
+				const auto semi = text.find(';', j);
+				value = trim(text.substr(j, (semi == string::npos ? text.size() : semi) - j));
+				i = semi == string::npos ? text.size() : semi + 1;
+			}
+			if (!spec.apply(key, value, problem)) return false;
+		}
+		return true;
+	}
+
+	static uint64_t mix(uint64_t x)
+	{
+		// splitmix64
+		x += 0x9e3779b97f4a7c15ULL;
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+		return x ^ (x >> 31);
+	}
+
+	static void civil_from_days(int64_t z, SQL_TIMESTAMP_STRUCT& ts)
+	{
+		z += 719468;
+		const auto era = (z >= 0 ? z : z - 146096) / 146097;
+		const auto doe = static_cast<unsigned>(z - era * 146097);
+		const auto yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+		const auto doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+		const auto mp = (5 * doy + 2) / 153;
+		const auto d = doy - (153 * mp + 2) / 5 + 1;
+		const auto m = mp < 10 ? mp + 3 : mp - 9;
+		ts.year = static_cast<SQLSMALLINT>(static_cast<int64_t>(yoe) + era * 400 + (m <= 2));
+		ts.month = static_cast<SQLUSMALLINT>(m);
+		ts.day = static_cast<SQLUSMALLINT>(d);
+	}
+
+	Cell make_cell(const Spec& spec, const size_t column, const uint64_t row)
+	{
+		const auto& c = spec.columns[column];
+		const auto h = mix(spec.seed ^ mix(row * 1315423911ULL + column));
+		Cell cell;
+		if (spec.null_ratio > 0 && static_cast<double>(h >> 11) * (1.0 / 9007199254740992.0) < spec.null_ratio)
+		{
+			cell.null = true;
+			return cell;
+		}
+		switch (c.kind)
+		{
+		case Kind::Bit:
+			cell.i = static_cast<int64_t>(h & 1);
+			break;
+		case Kind::Int:
+			cell.i = static_cast<int32_t>(h >> 32);
+			break;
+		case Kind::BigInt:
+			cell.i = static_cast<int64_t>(h);
+			break;
+		case Kind::Double:
+			cell.d = static_cast<double>(h >> 11) * (1.0 / 9007199254740992.0) * 1e6;
+			break;
+		case Kind::Decimal:
+		{
+			const auto digits = min<size_t>(c.column_size, 15);
+			uint64_t limit = 1;
+			for (size_t i = 0; i < digits; ++i) limit *= 10;
+			cell.i = static_cast<int64_t>(h % limit);
+			cell.d = static_cast<double>(cell.i);
+			for (auto i = 0; i < c.scale; ++i) cell.d /= 10;
+			break;
+		}
+		case Kind::WChar:
+		case Kind::Char:
+		case Kind::Binary:
+			cell.bytes = c.pattern.data() + (h & 63);
+			cell.len = c.length;
+			break;
+		case Kind::Timestamp:
+		case Kind::Date:
+		{
+			// any second of 2000 - 2029
+			const auto seconds = static_cast<int64_t>(h % (30ULL * 365 * 86400));
+			civil_from_days(10957 + seconds / 86400, cell.ts);
+			if (c.kind == Kind::Timestamp)
+			{
+				const auto in_day = seconds % 86400;
+				cell.ts.hour = static_cast<SQLUSMALLINT>(in_day / 3600);
+				cell.ts.minute = static_cast<SQLUSMALLINT>(in_day / 60 % 60);
+				cell.ts.second = static_cast<SQLUSMALLINT>(in_day % 60);
+				cell.ts.fraction = static_cast<SQLUINTEGER>((h >> 40) % 1000) * 1000000;
+			}
+			break;
+		}
+		}
+		return cell;
+	}
+
+	static SQLLEN fixed_size(const SQLSMALLINT c_type)
+	{
+		switch (c_type)
+		{
+		case SQL_C_BIT:
+		case SQL_C_TINYINT:
+		case SQL_C_STINYINT:
+		case SQL_C_UTINYINT:
+			return 1;
+		case SQL_C_SHORT:
+		case SQL_C_SSHORT:
+		case SQL_C_USHORT:
+			return 2;
+		case SQL_C_LONG:
+		case SQL_C_SLONG:
+		case SQL_C_ULONG:
+		case SQL_C_FLOAT:
+			return 4;
+		case SQL_C_SBIGINT:
+		case SQL_C_UBIGINT:
+		case SQL_C_DOUBLE:
+			return 8;
+		case SQL_C_TIMESTAMP:
+		case SQL_C_TYPE_TIMESTAMP:
+			return sizeof(SQL_TIMESTAMP_STRUCT);
+		case SQL_C_DATE:
+		case SQL_C_TYPE_DATE:
+			return sizeof(SQL_DATE_STRUCT);
+		case SQL_C_NUMERIC:
+			return sizeof(SQL_NUMERIC_STRUCT);
+		default:
+			return 0;
+		}
+	}
+
+	static SQLSMALLINT default_c_type(const Kind kind)
+	{
+		switch (kind)
+		{
+		case Kind::Bit: return SQL_C_BIT;
+		case Kind::Int: return SQL_C_SLONG;
+		case Kind::BigInt: return SQL_C_SBIGINT;
+		case Kind::Double: return SQL_C_DOUBLE;
+		case Kind::Decimal: return SQL_C_CHAR;
+		case Kind::WChar: return SQL_C_WCHAR;
+		case Kind::Char: return SQL_C_CHAR;
+		case Kind::Binary: return SQL_C_BINARY;
+		case Kind::Timestamp: return SQL_C_TYPE_TIMESTAMP;
+		case Kind::Date: return SQL_C_TYPE_DATE;
+		}
+		return SQL_C_CHAR;
+	}
+
+	// variable length data in chunks, as SQLGetData returns a long value. width is the
+	// bytes per source character in the target encoding, terminator the bytes of the
+	// null the target wants. offset carries progress between calls on the same cell.
+	static SQLRETURN put_var(Stmt& s, const char* src, const size_t chars, const size_t width, const size_t terminator,
+		SQLPOINTER target, const SQLLEN buffer_length, SQLLEN* ind, int64_t* offset)
+	{
+		const auto total = static_cast<int64_t>(chars * width);
+		const auto done = offset ? *offset : -1;
+		if (done >= total && done >= 0 && total > 0) return SQL_NO_DATA;
+		const auto from = max<int64_t>(done, 0);
+		const auto remaining = total - from;
+		int64_t capacity = buffer_length > static_cast<SQLLEN>(terminator) ? buffer_length - static_cast<SQLLEN>(terminator) : 0;
+		capacity -= capacity % static_cast<int64_t>(width);
+		const auto n = min(remaining, capacity);
+		if (target && n > 0)
+		{
+			auto* const out = static_cast<char*>(target);
+			if (width == 1)
+			{
+				memcpy(out, src + from, static_cast<size_t>(n));
+			}
+			else
+			{
+				const auto* in = src + from / 2;
+				auto* const wide = reinterpret_cast<SQLWCHAR*>(out);
+				for (int64_t i = 0; i < n / 2; ++i) wide[i] = static_cast<SQLWCHAR>(static_cast<unsigned char>(in[i]));
+			}
+		}
+		if (target && terminator && buffer_length >= static_cast<SQLLEN>(terminator))
+		{
+			memset(static_cast<char*>(target) + n, 0, terminator);
+		}
+		if (ind) *ind = static_cast<SQLLEN>(remaining);
+		if (remaining > n)
+		{
+			if (offset) *offset = from + n;
+			return s.post("01004", "String data, right truncated", SQL_SUCCESS_WITH_INFO);
+		}
+		if (offset) *offset = total;
+		return SQL_SUCCESS;
+	}
+
+	SQLRETURN Stmt::put(const size_t column, const uint64_t row, SQLSMALLINT c_type, SQLPOINTER target, const SQLLEN buffer_length, SQLLEN* ind, int64_t* offset)
+	{
+		const auto& c = spec.columns[column];
+		const auto cell = make_cell(spec, column, row);
+		if (cell.null)
+		{
+			if (!ind) return post("22002", "Indicator variable required but not supplied");
+			if (offset && *offset >= 0) return SQL_NO_DATA;
+			if (offset) *offset = 0;
+			*ind = SQL_NULL_DATA;
+			return SQL_SUCCESS;
+		}
+		if (c_type == SQL_C_DEFAULT) c_type = default_c_type(c.kind);
+
+		const auto wide = c_type == SQL_C_WCHAR;
+		const auto text = wide || c_type == SQL_C_CHAR;
+		const auto width = wide ? 2 : 1;
+		const auto terminator = text ? width : 0;
+
+		switch (c.kind)
+		{
+		case Kind::WChar:
+		case Kind::Char:
+		case Kind::Binary:
+			if (text || c_type == SQL_C_BINARY)
+			{
+				// nvarchar read as binary is its utf-16 bytes.
+				const auto bytes_width = c_type == SQL_C_BINARY ? (c.kind == Kind::WChar ? 2 : 1) : width;
+				return put_var(*this, cell.bytes, cell.len, bytes_width, terminator, target, buffer_length, ind, offset);
+			}
+			return post("07006", "Restricted data type attribute violation");
+
+		case Kind::Timestamp:
+		case Kind::Date:
+			if (c_type == SQL_C_TIMESTAMP || c_type == SQL_C_TYPE_TIMESTAMP)
+			{
+				if (target) *static_cast<SQL_TIMESTAMP_STRUCT*>(target) = cell.ts;
+				if (ind) *ind = sizeof(SQL_TIMESTAMP_STRUCT);
+				return SQL_SUCCESS;
+			}
+			if (c_type == SQL_C_DATE || c_type == SQL_C_TYPE_DATE)
+			{
+				if (target) *static_cast<SQL_DATE_STRUCT*>(target) = { cell.ts.year, cell.ts.month, cell.ts.day };
+				if (ind) *ind = sizeof(SQL_DATE_STRUCT);
+				return SQL_SUCCESS;
+			}
+			if (text)
+			{
+				char buffer[40];
+				const auto n = snprintf(buffer, sizeof(buffer), "%04d-%02u-%02u %02u:%02u:%02u.%03u",
+					cell.ts.year, cell.ts.month, cell.ts.day, cell.ts.hour, cell.ts.minute, cell.ts.second, cell.ts.fraction / 1000000);
+				const auto chars = c.kind == Kind::Date ? 10 : static_cast<size_t>(n);
+				return put_var(*this, buffer, chars, width, terminator, target, buffer_length, ind, offset);
+			}
+			return post("07006", "Restricted data type attribute violation");
+
+		default:
+			break;
+		}
+
+		// numeric kinds
+		const auto as_double = c.kind == Kind::Double || c.kind == Kind::Decimal ? cell.d : static_cast<double>(cell.i);
+		const auto as_int = c.kind == Kind::Double || c.kind == Kind::Decimal ? static_cast<int64_t>(cell.d) : cell.i;
+		if (text)
+		{
+			char buffer[48];
+			int n;
+			if (c.kind == Kind::Double) n = snprintf(buffer, sizeof(buffer), "%.17g", cell.d);
+			else if (c.kind == Kind::Decimal) n = snprintf(buffer, sizeof(buffer), "%.*f", c.scale, cell.d);
+			else n = snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(cell.i));
+			return put_var(*this, buffer, static_cast<size_t>(n), width, terminator, target, buffer_length, ind, offset);
+		}
+		if (target)
+		{
+			switch (c_type)
+			{
+			case SQL_C_BIT: *static_cast<unsigned char*>(target) = as_int != 0; break;
+			case SQL_C_TINYINT:
+			case SQL_C_STINYINT: *static_cast<signed char*>(target) = static_cast<signed char>(as_int); break;
+			case SQL_C_UTINYINT: *static_cast<unsigned char*>(target) = static_cast<unsigned char>(as_int); break;
+			case SQL_C_SHORT:
+			case SQL_C_SSHORT: *static_cast<SQLSMALLINT*>(target) = static_cast<SQLSMALLINT>(as_int); break;
+			case SQL_C_USHORT: *static_cast<SQLUSMALLINT*>(target) = static_cast<SQLUSMALLINT>(as_int); break;
+			case SQL_C_LONG:
+			case SQL_C_SLONG: *static_cast<SQLINTEGER*>(target) = static_cast<SQLINTEGER>(as_int); break;
+			case SQL_C_ULONG: *static_cast<SQLUINTEGER*>(target) = static_cast<SQLUINTEGER>(as_int); break;
+			case SQL_C_SBIGINT: *static_cast<SQLBIGINT*>(target) = as_int; break;
+			case SQL_C_UBIGINT: *static_cast<SQLUBIGINT*>(target) = static_cast<SQLUBIGINT>(as_int); break;
+			case SQL_C_FLOAT: *static_cast<SQLREAL*>(target) = static_cast<SQLREAL>(as_double); break;
+			case SQL_C_DOUBLE: *static_cast<SQLDOUBLE*>(target) = as_double; break;
+			case SQL_C_NUMERIC:
+			{
+				auto* const n = static_cast<SQL_NUMERIC_STRUCT*>(target);
+				memset(n, 0, sizeof(*n));
+				const auto scaled = c.kind == Kind::Decimal ? cell.i : as_int;
+				auto magnitude = static_cast<uint64_t>(scaled < 0 ? -scaled : scaled);
+				n->precision = static_cast<SQLCHAR>(c.kind == Kind::Decimal ? c.column_size : 19);
+				n->scale = static_cast<SQLSCHAR>(c.kind == Kind::Decimal ? c.scale : 0);
+				n->sign = scaled < 0 ? 0 : 1;
+				for (size_t i = 0; i < 8; ++i, magnitude >>= 8) n->val[i] = static_cast<SQLCHAR>(magnitude & 0xff);
+				break;
+			}
+			default:
+				return post("07006", "Restricted data type attribute violation");
+			}
+		}
+		if (ind) *ind = fixed_size(c_type);
+		return SQL_SUCCESS;
+	}
+
+	SQLRETURN Stmt::get_data(const SQLUSMALLINT column, const SQLSMALLINT c_type, SQLPOINTER target, const SQLLEN buffer_length, SQLLEN* ind)
+	{
+		if (!has_result || !positioned) return post("24000", "Invalid cursor state");
+		if (column == 0 || column > spec.columns.size()) return post("07009", "Invalid descriptor index");
+		auto& offset = offsets[column - 1];
+		return put(column - 1, current, c_type, target, buffer_length, ind, &offset);
+	}
+
+	// one block of rows into the bound columns - column wise unless a row size was set.
+	SQLRETURN Stmt::fetch()
+	{
+		if (!has_result) return post("24000", "Invalid cursor state");
+		const auto rows = spec.rows;
+		if (cursor >= rows)
+		{
+			positioned = false;
+			if (rows_fetched) *rows_fetched = 0;
+			return SQL_NO_DATA;
+		}
+		const auto n = static_cast<SQLULEN>(min<uint64_t>(row_array_size, rows - cursor));
+		current = cursor;
+		positioned = true;
+		fill(offsets.begin(), offsets.end(), -1);
+		auto ret = SQL_SUCCESS;
+		for (size_t c = 0; c < bindings.size() && c < spec.columns.size(); ++c)
+		{
+			const auto& b = bindings[c];
+			if (!b.target && !b.ind) continue;
+			const auto fixed = fixed_size(b.c_type == SQL_C_DEFAULT ? default_c_type(spec.columns[c].kind) : b.c_type);
+			const auto stride = row_bind_type != SQL_BIND_BY_COLUMN
+				? static_cast<SQLLEN>(row_bind_type)
+				: (fixed ? fixed : b.buffer_length);
+			const auto ind_stride = row_bind_type != SQL_BIND_BY_COLUMN ? static_cast<SQLLEN>(row_bind_type) : static_cast<SQLLEN>(sizeof(SQLLEN));
+			for (SQLULEN r = 0; r < n; ++r)
+			{
+				auto* const target = b.target ? static_cast<char*>(b.target) + r * stride : nullptr;
+				auto* const ind = b.ind ? reinterpret_cast<SQLLEN*>(reinterpret_cast<char*>(b.ind) + r * ind_stride) : nullptr;
+				const auto res = put(c, cursor + r, b.c_type, target, b.buffer_length, ind, nullptr);
+				if (res == SQL_ERROR) return res;
+				if (res == SQL_SUCCESS_WITH_INFO) ret = SQL_SUCCESS_WITH_INFO;
+			}
+		}
+		if (row_status)
+		{
+			for (SQLULEN r = 0; r < row_array_size; ++r) row_status[r] = r < n ? SQL_ROW_SUCCESS : SQL_ROW_NOROW;
+		}
+		if (rows_fetched) *rows_fetched = n;
+		cursor += n;
+		return ret;
+	}
+
+	void Stmt::close_cursor()
+	{
+		has_result = false;
+		positioned = false;
+		cursor = 0;
+		result = 0;
+	}
+
+	static bool returns_rows(const string& sql)
+	{
+		static const char* no_rows[] = {
+			"insert", "update", "delete", "merge", "set", "exec", "execute", "begin", "commit", "rollback",
+			"create", "drop", "alter", "declare", "use", "truncate", "if", "waitfor", "{"
+		};
+		const auto text = trim(sql);
+		size_t end = 0;
+		while (end < text.size() && (isalpha(static_cast<unsigned char>(text[end])) || text[end] == '{')) ++end;
+		const auto word = lower(text.substr(0, max<size_t>(end, 1)));
+		for (const auto* w : no_rows)
+		{
+			if (word == w) return false;
+		}
+		return true;
+	}
+
+	static size_t param_bytes(const Param& p, const SQLLEN ind)
+	{
+		if (ind == SQL_NULL_DATA) return 0;
+		const auto fixed = fixed_size(p.c_type);
+		if (fixed) return static_cast<size_t>(fixed);
+		if (ind == SQL_NTS)
+		{
+			if (!p.value) return 0;
+			if (p.c_type == SQL_C_WCHAR)
+			{
+				const auto* w = static_cast<const SQLWCHAR*>(p.value);
+				size_t n = 0;
+				while (w[n]) ++n;
+				return n * sizeof(SQLWCHAR);
+			}
+			return strlen(static_cast<const char*>(p.value));
+		}
+		return ind > 0 ? static_cast<size_t>(ind) : 0;
+	}
+
+	SQLRETURN Stmt::execute()
+	{
+		close_cursor();
+		row_count = -1;
+		data_at_exec.clear();
+		for (size_t i = 0; i < params.size(); ++i)
+		{
+			const auto& p = params[i];
+			if (p.ind && (*p.ind == SQL_DATA_AT_EXEC || *p.ind <= SQL_LEN_DATA_AT_EXEC_OFFSET))
+			{
+				data_at_exec.push_back(i);
+			}
+		}
+		wire.clear();
+		if (!data_at_exec.empty())
+		{
+			need_data = 0;
+			executing_dae = true;
+			return SQL_NEED_DATA;
+		}
+		return complete_execute();
+	}
+
+	SQLRETURN Stmt::complete_execute()
+	{
+		executing_dae = false;
+		cancelled = false;
+
+		// copy every bound parameter row out as a driver building the request would.
+		for (SQLULEN row = 0; row < paramset_size; ++row)
+		{
+			for (const auto& p : params)
+			{
+				if (p.io == SQL_PARAM_OUTPUT || !p.value) continue;
+				const auto stride = fixed_size(p.c_type) ? fixed_size(p.c_type) : p.buffer_length;
+				const auto ind = p.ind ? p.ind[row] : SQL_NTS;
+				if (ind == SQL_DATA_AT_EXEC || ind <= SQL_LEN_DATA_AT_EXEC_OFFSET) continue;
+				const auto n = param_bytes(p, ind);
+				const auto* src = static_cast<const char*>(p.value) + row * stride;
+				wire.insert(wire.end(), src, src + n);
+			}
+		}
+		if (params_processed) *params_processed = paramset_size;
+
+		spec = dbc->defaults;
+		auto rows = true;
+		const auto text = trim(sql);
+		if (text.size() >= 5 && lower(text.substr(0, 5)) == "mock:")
+		{
+			string problem;
+			if (!parse_settings(text.substr(5), spec, problem)) return post("42000", problem, SQL_ERROR, 102);
+		}
+		else
+		{
+			rows = returns_rows(text);
+		}
+
+		if (spec.delay_ms)
+		{
+			const auto start = chrono::steady_clock::now();
+			const auto until = start + chrono::milliseconds(spec.delay_ms);
+			const auto timeout = query_timeout ? start + chrono::seconds(query_timeout) : chrono::steady_clock::time_point::max();
+			while (chrono::steady_clock::now() < until)
+			{
+				if (cancelled) return post("HY008", "Operation canceled");
+				if (chrono::steady_clock::now() >= timeout) return post("HYT00", "Query timeout expired");
+				this_thread::sleep_for(chrono::milliseconds(1));
+			}
+		}
+		if (!spec.error.empty()) return post("42000", spec.error, SQL_ERROR, 50000);
+
+		if (!rows || spec.columns.empty())
+		{
+			row_count = static_cast<SQLLEN>(paramset_size);
+			return SQL_SUCCESS;
+		}
+		has_result = true;
+		offsets.assign(spec.columns.size(), -1);
+		return SQL_SUCCESS;
+	}
+}
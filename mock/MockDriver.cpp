@@ -0,0 +1,591 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: MockDriver.cpp
+// Contents: ODBC entry points of the mock driver, loaded by unixODBC as any other driver
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#include "MockDriver.h"
+#include <algorithm>
+#include <cstring>
+
+// the driver manager has already checked the handle types, so each entry point
+// only casts. every call clears the diagnostics of the handle it is given.
+
+namespace mock
+{
+	string narrow(const SQLWCHAR* text, const SQLINTEGER length)
+	{
+		string res;
+		if (!text) return res;
+		if (length == SQL_NTS)
+		{
+			for (auto* p = text; *p; ++p) res.push_back(static_cast<char>(*p < 0x80 ? *p : '?'));
+			return res;
+		}
+		res.reserve(static_cast<size_t>(length));
+		for (SQLINTEGER i = 0; i < length; ++i) res.push_back(static_cast<char>(text[i] < 0x80 ? text[i] : '?'));
+		return res;
+	}
+
+	SQLSMALLINT write_wide(const string& text, SQLWCHAR* target, const SQLSMALLINT buffer_chars)
+	{
+		if (target && buffer_chars > 0)
+		{
+			const auto n = min<size_t>(text.size(), static_cast<size_t>(buffer_chars - 1));
+			for (size_t i = 0; i < n; ++i) target[i] = static_cast<SQLWCHAR>(static_cast<unsigned char>(text[i]));
+			target[n] = 0;
+		}
+		return static_cast<SQLSMALLINT>(text.size());
+	}
+
+	static Handle* handle_of(const SQLSMALLINT type, SQLHANDLE h)
+	{
+		switch (type)
+		{
+		case SQL_HANDLE_ENV: return static_cast<Env*>(h);
+		case SQL_HANDLE_DBC: return static_cast<Dbc*>(h);
+		case SQL_HANDLE_STMT: return static_cast<Stmt*>(h);
+		case SQL_HANDLE_DESC: return static_cast<Desc*>(h);
+		default: return nullptr;
+		}
+	}
+
+	static SQLRETURN write_string(const string& value, SQLPOINTER target, const SQLINTEGER buffer_bytes, SQLSMALLINT* length_bytes)
+	{
+		const auto chars = write_wide(value, static_cast<SQLWCHAR*>(target), static_cast<SQLSMALLINT>(buffer_bytes / static_cast<SQLINTEGER>(sizeof(SQLWCHAR))));
+		if (length_bytes) *length_bytes = static_cast<SQLSMALLINT>(chars * sizeof(SQLWCHAR));
+		return static_cast<SQLINTEGER>((value.size() + 1) * sizeof(SQLWCHAR)) > buffer_bytes ? SQL_SUCCESS_WITH_INFO : SQL_SUCCESS;
+	}
+
+	static SQLLEN display_size(const Column& c)
+	{
+		switch (c.kind)
+		{
+		case Kind::Bit: return 1;
+		case Kind::Int: return 11;
+		case Kind::BigInt: return 20;
+		case Kind::Double: return 24;
+		case Kind::Decimal: return static_cast<SQLLEN>(c.column_size) + 2;
+		case Kind::Timestamp: return 27;
+		case Kind::Date: return 10;
+		case Kind::Binary: return c.column_size ? static_cast<SQLLEN>(c.column_size * 2) : 0;
+		default: return static_cast<SQLLEN>(c.column_size);
+		}
+	}
+}
+
+using namespace mock;
+
+extern "C" {
+
+SQLRETURN SQL_API SQLAllocHandle(const SQLSMALLINT HandleType, SQLHANDLE InputHandle, SQLHANDLE* OutputHandle)
+{
+	if (!OutputHandle) return SQL_ERROR;
+	switch (HandleType)
+	{
+	case SQL_HANDLE_ENV:
+		*OutputHandle = new Env();
+		return SQL_SUCCESS;
+	case SQL_HANDLE_DBC:
+		*OutputHandle = new Dbc();
+		return SQL_SUCCESS;
+	case SQL_HANDLE_STMT:
+		*OutputHandle = new Stmt(static_cast<Dbc*>(InputHandle));
+		return SQL_SUCCESS;
+	default:
+		*OutputHandle = SQL_NULL_HANDLE;
+		return SQL_ERROR;
+	}
+}
+
+SQLRETURN SQL_API SQLFreeHandle(const SQLSMALLINT HandleType, SQLHANDLE Handle)
+{
+	switch (HandleType)
+	{
+	case SQL_HANDLE_ENV: delete static_cast<Env*>(Handle); return SQL_SUCCESS;
+	case SQL_HANDLE_DBC: delete static_cast<Dbc*>(Handle); return SQL_SUCCESS;
+	case SQL_HANDLE_STMT: delete static_cast<Stmt*>(Handle); return SQL_SUCCESS;
+	default: return SQL_ERROR;
+	}
+}
+
+SQLRETURN SQL_API SQLSetEnvAttr(SQLHENV EnvironmentHandle, const SQLINTEGER Attribute, SQLPOINTER Value, SQLINTEGER)
+{
+	auto* const env = static_cast<Env*>(EnvironmentHandle);
+	if (!env) return SQL_SUCCESS;
+	env->clear();
+	if (Attribute == SQL_ATTR_ODBC_VERSION) env->odbc_version = static_cast<SQLINTEGER>(reinterpret_cast<SQLLEN>(Value));
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLGetEnvAttr(SQLHENV EnvironmentHandle, const SQLINTEGER Attribute, SQLPOINTER Value, SQLINTEGER, SQLINTEGER*)
+{
+	auto* const env = static_cast<Env*>(EnvironmentHandle);
+	env->clear();
+	if (Attribute == SQL_ATTR_ODBC_VERSION && Value) *static_cast<SQLINTEGER*>(Value) = env->odbc_version;
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLDriverConnectW(SQLHDBC ConnectionHandle, SQLHWND, SQLWCHAR* InConnectionString, const SQLSMALLINT StringLength1,
+	SQLWCHAR* OutConnectionString, const SQLSMALLINT BufferLength, SQLSMALLINT* StringLength2Ptr, SQLUSMALLINT)
+{
+	auto* const dbc = static_cast<Dbc*>(ConnectionHandle);
+	dbc->clear();
+	dbc->connection_string = narrow(InConnectionString, StringLength1);
+	Spec spec;
+	string problem;
+	if (!parse_settings(dbc->connection_string, spec, problem)) return dbc->post("HY000", problem);
+	if (spec.columns.empty())
+	{
+		spec.parse_columns("int", problem);
+	}
+	dbc->defaults = std::move(spec);
+	dbc->connected = true;
+	const auto n = write_wide(dbc->connection_string, OutConnectionString, BufferLength);
+	if (StringLength2Ptr) *StringLength2Ptr = n;
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLDisconnect(SQLHDBC ConnectionHandle)
+{
+	auto* const dbc = static_cast<Dbc*>(ConnectionHandle);
+	dbc->clear();
+	dbc->connected = false;
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLSetConnectAttrW(SQLHDBC ConnectionHandle, const SQLINTEGER Attribute, SQLPOINTER Value, SQLINTEGER)
+{
+	auto* const dbc = static_cast<Dbc*>(ConnectionHandle);
+	dbc->clear();
+	if (Attribute == SQL_ATTR_AUTOCOMMIT) dbc->autocommit = reinterpret_cast<SQLULEN>(Value);
+	// timeouts, bcp, mars and the rest are accepted and have no effect.
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLGetConnectAttrW(SQLHDBC ConnectionHandle, const SQLINTEGER Attribute, SQLPOINTER Value, SQLINTEGER, SQLINTEGER* StringLength)
+{
+	auto* const dbc = static_cast<Dbc*>(ConnectionHandle);
+	dbc->clear();
+	if (StringLength) *StringLength = sizeof(SQLUINTEGER);
+	if (!Value) return SQL_SUCCESS;
+	switch (Attribute)
+	{
+	case SQL_ATTR_CONNECTION_DEAD:
+		*static_cast<SQLUINTEGER*>(Value) = dbc->connected ? SQL_CD_FALSE : SQL_CD_TRUE;
+		break;
+	case SQL_ATTR_AUTOCOMMIT:
+		*static_cast<SQLUINTEGER*>(Value) = static_cast<SQLUINTEGER>(dbc->autocommit);
+		break;
+	default:
+		*static_cast<SQLUINTEGER*>(Value) = 0;
+		break;
+	}
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLGetInfoW(SQLHDBC ConnectionHandle, const SQLUSMALLINT InfoType, SQLPOINTER InfoValue, const SQLSMALLINT BufferLength, SQLSMALLINT* StringLength)
+{
+	auto* const dbc = static_cast<Dbc*>(ConnectionHandle);
+	dbc->clear();
+	switch (InfoType)
+	{
+	case SQL_DRIVER_ODBC_VER: return write_string("03.80", InfoValue, BufferLength, StringLength);
+	case SQL_DRIVER_NAME: return write_string("libmsnodesqlv8mock.so", InfoValue, BufferLength, StringLength);
+	case SQL_DRIVER_VER: return write_string("01.00.0000", InfoValue, BufferLength, StringLength);
+	case SQL_DBMS_NAME: return write_string("msnodesqlv8 mock", InfoValue, BufferLength, StringLength);
+	case SQL_DBMS_VER: return write_string("16.00.0000", InfoValue, BufferLength, StringLength);
+	case SQL_SERVER_NAME:
+	case SQL_DATA_SOURCE_NAME: return write_string("mock", InfoValue, BufferLength, StringLength);
+	case SQL_DATABASE_NAME: return write_string("mock", InfoValue, BufferLength, StringLength);
+	case SQL_USER_NAME: return write_string("mock", InfoValue, BufferLength, StringLength);
+	case SQL_CURSOR_COMMIT_BEHAVIOR:
+	case SQL_CURSOR_ROLLBACK_BEHAVIOR:
+		if (InfoValue) *static_cast<SQLUSMALLINT*>(InfoValue) = SQL_CB_PRESERVE;
+		if (StringLength) *StringLength = sizeof(SQLUSMALLINT);
+		return SQL_SUCCESS;
+	case SQL_TXN_CAPABLE:
+		if (InfoValue) *static_cast<SQLUSMALLINT*>(InfoValue) = SQL_TC_ALL;
+		if (StringLength) *StringLength = sizeof(SQLUSMALLINT);
+		return SQL_SUCCESS;
+	case SQL_MAX_CONCURRENT_ACTIVITIES:
+		if (InfoValue) *static_cast<SQLUSMALLINT*>(InfoValue) = 0;
+		if (StringLength) *StringLength = sizeof(SQLUSMALLINT);
+		return SQL_SUCCESS;
+	case SQL_GETDATA_EXTENSIONS:
+		if (InfoValue) *static_cast<SQLUINTEGER*>(InfoValue) = SQL_GD_ANY_COLUMN | SQL_GD_ANY_ORDER | SQL_GD_BOUND;
+		if (StringLength) *StringLength = sizeof(SQLUINTEGER);
+		return SQL_SUCCESS;
+	default:
+		if (InfoValue && BufferLength >= static_cast<SQLSMALLINT>(sizeof(SQLUINTEGER))) *static_cast<SQLUINTEGER*>(InfoValue) = 0;
+		else if (InfoValue) *static_cast<SQLUSMALLINT*>(InfoValue) = 0;
+		if (StringLength) *StringLength = 0;
+		return SQL_SUCCESS;
+	}
+}
+
+SQLRETURN SQL_API SQLEndTran(const SQLSMALLINT HandleType, SQLHANDLE Handle, SQLSMALLINT)
+{
+	if (auto* const h = handle_of(HandleType, Handle)) h->clear();
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLPrepareW(SQLHSTMT StatementHandle, SQLWCHAR* StatementText, const SQLINTEGER TextLength)
+{
+	auto* const stmt = static_cast<Stmt*>(StatementHandle);
+	stmt->clear();
+	stmt->close_cursor();
+	stmt->sql = narrow(StatementText, TextLength);
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLExecute(SQLHSTMT StatementHandle)
+{
+	auto* const stmt = static_cast<Stmt*>(StatementHandle);
+	stmt->clear();
+	return stmt->execute();
+}
+
+SQLRETURN SQL_API SQLExecDirectW(SQLHSTMT StatementHandle, SQLWCHAR* StatementText, const SQLINTEGER TextLength)
+{
+	auto* const stmt = static_cast<Stmt*>(StatementHandle);
+	stmt->clear();
+	stmt->sql = narrow(StatementText, TextLength);
+	return stmt->execute();
+}
+
+SQLRETURN SQL_API SQLNumParams(SQLHSTMT StatementHandle, SQLSMALLINT* ParameterCountPtr)
+{
+	auto* const stmt = static_cast<Stmt*>(StatementHandle);
+	stmt->clear();
+	if (ParameterCountPtr)
+	{
+		*ParameterCountPtr = static_cast<SQLSMALLINT>(count(stmt->sql.begin(), stmt->sql.end(), '?'));
+	}
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLBindParameter(SQLHSTMT StatementHandle, const SQLUSMALLINT ParameterNumber, const SQLSMALLINT InputOutputType,
+	const SQLSMALLINT ValueType, const SQLSMALLINT ParameterType, const SQLULEN ColumnSize, SQLSMALLINT,
+	SQLPOINTER ParameterValuePtr, const SQLLEN BufferLength, SQLLEN* StrLen_or_IndPtr)
+{
+	auto* const stmt = static_cast<Stmt*>(StatementHandle);
+	stmt->clear();
+	if (ParameterNumber == 0) return stmt->post("07009", "Invalid descriptor index");
+	if (stmt->params.size() < ParameterNumber) stmt->params.resize(ParameterNumber);
+	auto& p = stmt->params[ParameterNumber - 1];
+	p.io = InputOutputType;
+	p.c_type = ValueType;
+	p.sql_type = ParameterType;
+	p.size = ColumnSize;
+	p.value = ParameterValuePtr;
+	p.buffer_length = BufferLength;
+	p.ind = StrLen_or_IndPtr;
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLParamData(SQLHSTMT StatementHandle, SQLPOINTER* ValuePtrPtr)
+{
+	auto* const stmt = static_cast<Stmt*>(StatementHandle);
+	stmt->clear();
+	if (!stmt->executing_dae) return stmt->post("HY010", "Function sequence error");
+	if (stmt->need_data < stmt->data_at_exec.size())
+	{
+		const auto& p = stmt->params[stmt->data_at_exec[stmt->need_data++]];
+		if (ValuePtrPtr) *ValuePtrPtr = p.value;
+		return SQL_NEED_DATA;
+	}
+	return stmt->complete_execute();
+}
+
+SQLRETURN SQL_API SQLPutData(SQLHSTMT StatementHandle, SQLPOINTER DataPtr, const SQLLEN StrLen_or_Ind)
+{
+	auto* const stmt = static_cast<Stmt*>(StatementHandle);
+	stmt->clear();
+	if (!stmt->executing_dae || stmt->need_data == 0) return stmt->post("HY010", "Function sequence error");
+	if (DataPtr && StrLen_or_Ind > 0)
+	{
+		const auto* src = static_cast<const char*>(DataPtr);
+		stmt->wire.insert(stmt->wire.end(), src, src + StrLen_or_Ind);
+	}
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLNumResultCols(SQLHSTMT StatementHandle, SQLSMALLINT* ColumnCountPtr)
+{
+	auto* const stmt = static_cast<Stmt*>(StatementHandle);
+	stmt->clear();
+	if (ColumnCountPtr) *ColumnCountPtr = stmt->has_result ? static_cast<SQLSMALLINT>(stmt->spec.columns.size()) : 0;
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLDescribeColW(SQLHSTMT StatementHandle, const SQLUSMALLINT ColumnNumber, SQLWCHAR* ColumnName, const SQLSMALLINT BufferLength,
+	SQLSMALLINT* NameLengthPtr, SQLSMALLINT* DataTypePtr, SQLULEN* ColumnSizePtr, SQLSMALLINT* DecimalDigitsPtr, SQLSMALLINT* NullablePtr)
+{
+	auto* const stmt = static_cast<Stmt*>(StatementHandle);
+	stmt->clear();
+	if (!stmt->has_result || ColumnNumber == 0 || ColumnNumber > stmt->spec.columns.size()) return stmt->post("07009", "Invalid descriptor index");
+	const auto& c = stmt->spec.columns[ColumnNumber - 1];
+	const auto n = write_wide(c.name, ColumnName, BufferLength);
+	if (NameLengthPtr) *NameLengthPtr = n;
+	if (DataTypePtr) *DataTypePtr = c.sql_type;
+	if (ColumnSizePtr) *ColumnSizePtr = c.column_size;
+	if (DecimalDigitsPtr) *DecimalDigitsPtr = c.scale;
+	if (NullablePtr) *NullablePtr = SQL_NULLABLE;
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLColAttributeW(SQLHSTMT StatementHandle, const SQLUSMALLINT ColumnNumber, const SQLUSMALLINT FieldIdentifier,
+	SQLPOINTER CharacterAttributePtr, const SQLSMALLINT BufferLength, SQLSMALLINT* StringLengthPtr, SQLLEN* NumericAttributePtr)
+{
+	auto* const stmt = static_cast<Stmt*>(StatementHandle);
+	stmt->clear();
+	if (!stmt->has_result || ColumnNumber == 0 || ColumnNumber > stmt->spec.columns.size()) return stmt->post("07009", "Invalid descriptor index");
+	const auto& c = stmt->spec.columns[ColumnNumber - 1];
+	SQLLEN numeric = 0;
+	switch (FieldIdentifier)
+	{
+	case SQL_DESC_TYPE_NAME:
+		return write_string(c.type_name, CharacterAttributePtr, BufferLength, StringLengthPtr);
+	case SQL_DESC_NAME:
+	case SQL_DESC_LABEL:
+	case SQL_COLUMN_NAME:
+		return write_string(c.name, CharacterAttributePtr, BufferLength, StringLengthPtr);
+	case SQL_DESC_DISPLAY_SIZE:
+		numeric = display_size(c);
+		break;
+	case SQL_DESC_TYPE:
+	case SQL_DESC_CONCISE_TYPE:
+		numeric = c.sql_type;
+		break;
+	case SQL_COLUMN_PRECISION:
+	case SQL_DESC_PRECISION:
+	case SQL_DESC_LENGTH:
+	case SQL_COLUMN_LENGTH:
+		numeric = static_cast<SQLLEN>(c.column_size);
+		break;
+	case SQL_DESC_OCTET_LENGTH:
+		numeric = static_cast<SQLLEN>(c.kind == Kind::WChar ? c.column_size * 2 : c.column_size);
+		break;
+	case SQL_COLUMN_SCALE:
+	case SQL_DESC_SCALE:
+		numeric = c.scale;
+		break;
+	case SQL_DESC_NULLABLE:
+		numeric = SQL_NULLABLE;
+		break;
+	default:
+		// driver specific (variant type, udt name, ...) - not produced by the mock.
+		if (CharacterAttributePtr && BufferLength >= static_cast<SQLSMALLINT>(sizeof(SQLWCHAR))) *static_cast<SQLWCHAR*>(CharacterAttributePtr) = 0;
+		if (StringLengthPtr) *StringLengthPtr = 0;
+		break;
+	}
+	if (NumericAttributePtr) *NumericAttributePtr = numeric;
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLBindCol(SQLHSTMT StatementHandle, const SQLUSMALLINT ColumnNumber, const SQLSMALLINT TargetType,
+	SQLPOINTER TargetValuePtr, const SQLLEN BufferLength, SQLLEN* StrLen_or_IndPtr)
+{
+	auto* const stmt = static_cast<Stmt*>(StatementHandle);
+	stmt->clear();
+	if (ColumnNumber == 0) return stmt->post("07009", "Invalid descriptor index");
+	if (stmt->bindings.size() < ColumnNumber) stmt->bindings.resize(ColumnNumber);
+	stmt->bindings[ColumnNumber - 1] = { TargetType, TargetValuePtr, BufferLength, StrLen_or_IndPtr };
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLFetch(SQLHSTMT StatementHandle)
+{
+	auto* const stmt = static_cast<Stmt*>(StatementHandle);
+	stmt->clear();
+	return stmt->fetch();
+}
+
+SQLRETURN SQL_API SQLFetchScroll(SQLHSTMT StatementHandle, const SQLSMALLINT FetchOrientation, SQLLEN)
+{
+	auto* const stmt = static_cast<Stmt*>(StatementHandle);
+	stmt->clear();
+	if (FetchOrientation != SQL_FETCH_NEXT) return stmt->post("HYC00", "Optional feature not implemented");
+	return stmt->fetch();
+}
+
+SQLRETURN SQL_API SQLGetData(SQLHSTMT StatementHandle, const SQLUSMALLINT Col_or_Param_Num, const SQLSMALLINT TargetType,
+	SQLPOINTER TargetValuePtr, const SQLLEN BufferLength, SQLLEN* StrLen_or_IndPtr)
+{
+	auto* const stmt = static_cast<Stmt*>(StatementHandle);
+	stmt->clear();
+	return stmt->get_data(Col_or_Param_Num, TargetType, TargetValuePtr, BufferLength, StrLen_or_IndPtr);
+}
+
+SQLRETURN SQL_API SQLMoreResults(SQLHSTMT StatementHandle)
+{
+	auto* const stmt = static_cast<Stmt*>(StatementHandle);
+	stmt->clear();
+	if (!stmt->has_result || stmt->result + 1 >= stmt->spec.results)
+	{
+		stmt->close_cursor();
+		return SQL_NO_DATA;
+	}
+	++stmt->result;
+	stmt->cursor = 0;
+	stmt->positioned = false;
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLRowCount(SQLHSTMT StatementHandle, SQLLEN* RowCountPtr)
+{
+	auto* const stmt = static_cast<Stmt*>(StatementHandle);
+	stmt->clear();
+	if (RowCountPtr) *RowCountPtr = stmt->row_count;
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLFreeStmt(SQLHSTMT StatementHandle, const SQLUSMALLINT Option)
+{
+	auto* const stmt = static_cast<Stmt*>(StatementHandle);
+	stmt->clear();
+	switch (Option)
+	{
+	case SQL_CLOSE: stmt->close_cursor(); break;
+	case SQL_UNBIND: stmt->bindings.clear(); break;
+	case SQL_RESET_PARAMS: stmt->params.clear(); break;
+	default: break;
+	}
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLCloseCursor(SQLHSTMT StatementHandle)
+{
+	auto* const stmt = static_cast<Stmt*>(StatementHandle);
+	stmt->clear();
+	stmt->close_cursor();
+	return SQL_SUCCESS;
+}
+
+// may arrive on another thread while the statement executes - only the flag is touched.
+SQLRETURN SQL_API SQLCancel(SQLHSTMT StatementHandle)
+{
+	static_cast<Stmt*>(StatementHandle)->cancelled = true;
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLCancelHandle(const SQLSMALLINT HandleType, SQLHANDLE InputHandle)
+{
+	if (HandleType == SQL_HANDLE_STMT) static_cast<Stmt*>(InputHandle)->cancelled = true;
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLSetStmtAttrW(SQLHSTMT StatementHandle, const SQLINTEGER Attribute, SQLPOINTER Value, SQLINTEGER)
+{
+	auto* const stmt = static_cast<Stmt*>(StatementHandle);
+	stmt->clear();
+	const auto v = reinterpret_cast<SQLULEN>(Value);
+	switch (Attribute)
+	{
+	case SQL_ATTR_ROW_ARRAY_SIZE: stmt->row_array_size = v ? v : 1; break;
+	case SQL_ATTR_ROW_BIND_TYPE: stmt->row_bind_type = v; break;
+	case SQL_ATTR_ROWS_FETCHED_PTR: stmt->rows_fetched = static_cast<SQLULEN*>(Value); break;
+	case SQL_ATTR_ROW_STATUS_PTR: stmt->row_status = static_cast<SQLUSMALLINT*>(Value); break;
+	case SQL_ATTR_PARAMSET_SIZE: stmt->paramset_size = v ? v : 1; break;
+	case SQL_ATTR_PARAMS_PROCESSED_PTR: stmt->params_processed = static_cast<SQLULEN*>(Value); break;
+	case SQL_ATTR_QUERY_TIMEOUT: stmt->query_timeout = v; break;
+	case SQL_ATTR_ASYNC_ENABLE: stmt->async_enable = v; break;
+	default: break;
+	}
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLGetStmtAttrW(SQLHSTMT StatementHandle, const SQLINTEGER Attribute, SQLPOINTER Value, SQLINTEGER, SQLINTEGER* StringLength)
+{
+	auto* const stmt = static_cast<Stmt*>(StatementHandle);
+	stmt->clear();
+	if (!Value) return SQL_SUCCESS;
+	if (StringLength) *StringLength = sizeof(SQLULEN);
+	switch (Attribute)
+	{
+	case SQL_ATTR_APP_PARAM_DESC: *static_cast<SQLHDESC*>(Value) = &stmt->app_param_desc; break;
+	case SQL_ATTR_IMP_PARAM_DESC: *static_cast<SQLHDESC*>(Value) = &stmt->imp_param_desc; break;
+	case SQL_ATTR_APP_ROW_DESC: *static_cast<SQLHDESC*>(Value) = &stmt->app_row_desc; break;
+	case SQL_ATTR_IMP_ROW_DESC: *static_cast<SQLHDESC*>(Value) = &stmt->imp_row_desc; break;
+	case SQL_ATTR_ROW_ARRAY_SIZE: *static_cast<SQLULEN*>(Value) = stmt->row_array_size; break;
+	case SQL_ATTR_PARAMSET_SIZE: *static_cast<SQLULEN*>(Value) = stmt->paramset_size; break;
+	case SQL_ATTR_QUERY_TIMEOUT: *static_cast<SQLULEN*>(Value) = stmt->query_timeout; break;
+	case SQL_ATTR_ASYNC_ENABLE: *static_cast<SQLULEN*>(Value) = stmt->async_enable; break;
+	default: *static_cast<SQLULEN*>(Value) = 0; break;
+	}
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLSetDescFieldW(SQLHDESC DescriptorHandle, SQLSMALLINT, SQLSMALLINT, SQLPOINTER, SQLINTEGER)
+{
+	static_cast<Desc*>(DescriptorHandle)->clear();
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLGetDescFieldW(SQLHDESC DescriptorHandle, SQLSMALLINT, SQLSMALLINT, SQLPOINTER Value, const SQLINTEGER BufferLength, SQLINTEGER* StringLength)
+{
+	static_cast<Desc*>(DescriptorHandle)->clear();
+	if (Value && BufferLength > 0) memset(Value, 0, static_cast<size_t>(BufferLength));
+	if (StringLength) *StringLength = 0;
+	return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLGetDiagRecW(const SQLSMALLINT HandleType, SQLHANDLE Handle, const SQLSMALLINT RecNumber, SQLWCHAR* Sqlstate,
+	SQLINTEGER* NativeErrorPtr, SQLWCHAR* MessageText, const SQLSMALLINT BufferLength, SQLSMALLINT* TextLengthPtr)
+{
+	const auto* const h = handle_of(HandleType, Handle);
+	if (!h) return SQL_INVALID_HANDLE;
+	if (RecNumber < 1 || static_cast<size_t>(RecNumber) > h->diags.size()) return SQL_NO_DATA;
+	const auto& d = h->diags[RecNumber - 1];
+	write_wide(d.state, Sqlstate, 6);
+	if (NativeErrorPtr) *NativeErrorPtr = d.native;
+	const auto n = write_wide(d.message, MessageText, BufferLength);
+	if (TextLengthPtr) *TextLengthPtr = n;
+	return n >= BufferLength ? SQL_SUCCESS_WITH_INFO : SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API SQLGetDiagFieldW(const SQLSMALLINT HandleType, SQLHANDLE Handle, const SQLSMALLINT RecNumber, const SQLSMALLINT DiagIdentifier,
+	SQLPOINTER DiagInfoPtr, const SQLSMALLINT BufferLength, SQLSMALLINT* StringLengthPtr)
+{
+	const auto* const h = handle_of(HandleType, Handle);
+	if (!h) return SQL_INVALID_HANDLE;
+	if (DiagIdentifier == SQL_DIAG_NUMBER)
+	{
+		if (DiagInfoPtr) *static_cast<SQLINTEGER*>(DiagInfoPtr) = static_cast<SQLINTEGER>(h->diags.size());
+		return SQL_SUCCESS;
+	}
+	if (RecNumber < 1 || static_cast<size_t>(RecNumber) > h->diags.size()) return SQL_NO_DATA;
+	const auto& d = h->diags[RecNumber - 1];
+	switch (DiagIdentifier)
+	{
+	case SQL_DIAG_SQLSTATE: return write_string(d.state, DiagInfoPtr, BufferLength, StringLengthPtr);
+	case SQL_DIAG_MESSAGE_TEXT: return write_string(d.message, DiagInfoPtr, BufferLength, StringLengthPtr);
+	case SQL_DIAG_SS_SRVNAME: return write_string("mock", DiagInfoPtr, BufferLength, StringLengthPtr);
+	case SQL_DIAG_SS_PROCNAME: return write_string("", DiagInfoPtr, BufferLength, StringLengthPtr);
+	case SQL_DIAG_NATIVE:
+		if (DiagInfoPtr) *static_cast<SQLINTEGER*>(DiagInfoPtr) = d.native;
+		return SQL_SUCCESS;
+	case SQL_DIAG_SS_SEVERITY:
+		if (DiagInfoPtr) *static_cast<SQLINTEGER*>(DiagInfoPtr) = d.state[0] == '0' && d.state[1] == '1' ? 0 : 16;
+		return SQL_SUCCESS;
+	default:
+		if (DiagInfoPtr) *static_cast<SQLINTEGER*>(DiagInfoPtr) = 0;
+		return SQL_SUCCESS;
+	}
+}
+
+}
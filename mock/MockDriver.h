@@ -0,0 +1,217 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: MockDriver.h
+// Contents: in memory ODBC driver serving synthetic result sets, for benchmarking the addon without a server
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <sql.h>
+#include <sqlext.h>
+#include <sqlucode.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// driver specific diagnostic fields the addon reads - normally from msodbcsql.h
+#ifndef SQL_DIAG_SS_SEVERITY
+#define SQL_DIAG_SS_MSGSTATE (-1150)
+#define SQL_DIAG_SS_SEVERITY (-1151)
+#define SQL_DIAG_SS_SRVNAME (-1152)
+#define SQL_DIAG_SS_PROCNAME (-1153)
+#define SQL_DIAG_SS_LINE (-1154)
+#endif
+
+namespace mock
+{
+	using namespace std;
+
+	enum class Kind
+	{
+		Bit,
+		Int,
+		BigInt,
+		Double,
+		Decimal,
+		WChar,
+		Char,
+		Binary,
+		Timestamp,
+		Date
+	};
+
+	struct Column
+	{
+		string name;
+		string type_name;
+		Kind kind = Kind::Int;
+		SQLSMALLINT sql_type = SQL_INTEGER;
+		SQLULEN column_size = 10;	// 0 for (max)
+		SQLSMALLINT scale = 0;
+		size_t length = 0;			// characters or bytes in each generated value
+		string pattern;				// values are windows onto this, length + 64 long
+	};
+
+	// what a statement returns. set from the connection string and overridden per
+	// statement by sql text of the form  mock:rows=10;columns=int,nvarchar(20)
+	struct Spec
+	{
+		uint64_t rows = 1;
+		vector<Column> columns;
+		double null_ratio = 0;
+		uint64_t seed = 1;
+		uint32_t results = 1;
+		uint32_t delay_ms = 0;
+		size_t lob_length = 4096;
+		string error;
+
+		bool apply(const string& key, const string& value, string& problem);
+		bool parse_columns(const string& value, string& problem);
+	};
+
+	// one generated value. bytes is only set for the string and binary kinds.
+	struct Cell
+	{
+		bool null = false;
+		int64_t i = 0;
+		double d = 0;
+		const char* bytes = nullptr;
+		size_t len = 0;
+		SQL_TIMESTAMP_STRUCT ts{};
+	};
+
+	Cell make_cell(const Spec& spec, size_t column, uint64_t row);
+
+	struct Diag
+	{
+		string state;
+		string message;
+		SQLINTEGER native;
+	};
+
+	enum class HandleTag : uint32_t
+	{
+		Env = 0x454e5631,
+		Dbc = 0x44424331,
+		Stmt = 0x53544d31,
+		Desc = 0x44455331
+	};
+
+	struct Handle
+	{
+		explicit Handle(HandleTag t) : tag(t) {}
+		HandleTag tag;
+		vector<Diag> diags;
+
+		void clear() { if (!diags.empty()) diags.clear(); }
+		SQLRETURN post(const char* state, const string& message, SQLRETURN ret = SQL_ERROR, SQLINTEGER native = 0)
+		{
+			diags.push_back({ state, "[msnodesqlv8][Mock] " + message, native });
+			return ret;
+		}
+	};
+
+	struct Env : Handle
+	{
+		Env() : Handle(HandleTag::Env) {}
+		SQLINTEGER odbc_version = SQL_OV_ODBC3;
+	};
+
+	struct Dbc : Handle
+	{
+		Dbc() : Handle(HandleTag::Dbc) {}
+		Spec defaults;
+		string connection_string;
+		bool connected = false;
+		SQLULEN autocommit = SQL_AUTOCOMMIT_ON;
+	};
+
+	// descriptor fields are accepted and dropped - the mock binds only through
+	// SQLBindParameter and SQLBindCol.
+	struct Desc : Handle
+	{
+		Desc() : Handle(HandleTag::Desc) {}
+	};
+
+	struct Binding
+	{
+		SQLSMALLINT c_type = 0;
+		SQLPOINTER target = nullptr;
+		SQLLEN buffer_length = 0;
+		SQLLEN* ind = nullptr;
+	};
+
+	struct Param
+	{
+		SQLSMALLINT io = SQL_PARAM_INPUT;
+		SQLSMALLINT c_type = 0;
+		SQLSMALLINT sql_type = 0;
+		SQLULEN size = 0;
+		SQLPOINTER value = nullptr;
+		SQLLEN buffer_length = 0;
+		SQLLEN* ind = nullptr;
+	};
+
+	struct Stmt : Handle
+	{
+		explicit Stmt(Dbc* d) : Handle(HandleTag::Stmt), dbc(d) {}
+		Dbc* dbc;
+		Desc app_param_desc;
+		Desc imp_param_desc;
+		Desc app_row_desc;
+		Desc imp_row_desc;
+
+		string sql;
+		Spec spec;
+		bool has_result = false;
+		uint32_t result = 0;
+		uint64_t cursor = 0;		// rows handed out so far in this result
+		uint64_t current = 0;		// the row SQLGetData reads
+		bool positioned = false;
+		SQLLEN row_count = -1;
+		vector<int64_t> offsets;	// SQLGetData progress per column, -1 untouched
+
+		vector<Binding> bindings;
+		vector<Param> params;
+		vector<size_t> data_at_exec;
+		size_t need_data = 0;
+		bool executing_dae = false;
+		vector<char> wire;			// parameter bytes are copied here as a send would
+
+		SQLULEN row_array_size = 1;
+		SQLULEN row_bind_type = SQL_BIND_BY_COLUMN;
+		SQLULEN* rows_fetched = nullptr;
+		SQLUSMALLINT* row_status = nullptr;
+		SQLULEN paramset_size = 1;
+		SQLULEN* params_processed = nullptr;
+		SQLULEN query_timeout = 0;
+		SQLULEN async_enable = SQL_ASYNC_ENABLE_OFF;
+		atomic<bool> cancelled{ false };
+
+		SQLRETURN execute();
+		SQLRETURN complete_execute();
+		SQLRETURN fetch();
+		void close_cursor();
+		SQLRETURN get_data(SQLUSMALLINT column, SQLSMALLINT c_type, SQLPOINTER target, SQLLEN buffer_length, SQLLEN* ind);
+		SQLRETURN put(size_t column, uint64_t row, SQLSMALLINT c_type, SQLPOINTER target, SQLLEN buffer_length, SQLLEN* ind, int64_t* offset);
+	};
+
+	bool parse_settings(const string& text, Spec& spec, string& problem);
+	string narrow(const SQLWCHAR* text, SQLINTEGER length);
+	SQLSMALLINT write_wide(const string& text, SQLWCHAR* target, SQLSMALLINT buffer_chars);
+}
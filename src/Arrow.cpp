@@ -0,0 +1,644 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: Arrow.cpp
+// Contents: encode a fetched batch as Apache Arrow IPC stream messages
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include <Arrow.h>
+#include <ResultSet.h>
+#include <Column.h>
+#include <TimestampColumn.h>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace mssql
+{
+	namespace arrow
+	{
+		// the parts of the Arrow flatbuffer schema (format/Schema.fbs, Message.fbs) written here.
+		namespace fb
+		{
+			const uint8_t header_schema = 1;
+			const uint8_t header_record_batch = 3;
+			const uint8_t type_int = 2;
+			const uint8_t type_floating_point = 3;
+			const uint8_t type_binary = 4;
+			const uint8_t type_utf8 = 5;
+			const uint8_t type_bool = 6;
+			const uint8_t type_timestamp = 10;
+			const int16_t metadata_v5 = 4;
+			const int16_t precision_double = 2;
+			const int16_t unit_microsecond = 2;
+			const uint32_t continuation = 0xffffffff;
+		}
+
+		// a flatbuffer object to be written - a table of scalars and child offsets, a string,
+		// a vector of structs held as raw bytes or a vector of offsets to other objects.
+		struct node;
+		typedef shared_ptr<node> node_ptr;
+
+		struct node
+		{
+			enum class shape { table, text, structs, offsets };
+
+			struct field
+			{
+				uint16_t id;
+				uint8_t width; // 0 for an offset to child
+				uint64_t scalar;
+				node_ptr child;
+			};
+
+			shape form;
+			vector<field> fields;
+			string chars;
+			vector<uint8_t> raw;
+			size_t count = 0;
+			vector<node_ptr> items;
+
+			explicit node(const shape s) : form(s) {}
+
+			node* scalar(const uint16_t id, const uint8_t width, const uint64_t v)
+			{
+				fields.push_back({ id, width, v, nullptr });
+				return this;
+			}
+
+			node* child(const uint16_t id, const node_ptr& c)
+			{
+				fields.push_back({ id, 0, 0, c });
+				return this;
+			}
+		};
+
+		static node_ptr table()
+		{
+			return make_shared<node>(node::shape::table);
+		}
+
+		static node_ptr text(const string& s)
+		{
+			auto n = make_shared<node>(node::shape::text);
+			n->chars = s;
+			return n;
+		}
+
+		static node_ptr structs(const vector<uint8_t>& raw, const size_t count)
+		{
+			auto n = make_shared<node>(node::shape::structs);
+			n->raw = raw;
+			n->count = count;
+			return n;
+		}
+
+		static node_ptr offsets(const vector<node_ptr>& items)
+		{
+			auto n = make_shared<node>(node::shape::offsets);
+			n->items = items;
+			return n;
+		}
+
+		// objects are laid out front to back, a parent before its children, so every
+		// uoffset points forward and is patched once the child has been placed.
+		class writer
+		{
+		public:
+			vector<uint8_t> buf;
+
+			vector<uint8_t> finish(const node_ptr& root)
+			{
+				buf.assign(sizeof(uint32_t), 0);
+				const auto at = write(*root);
+				put<uint32_t>(0, static_cast<uint32_t>(at));
+				align(8);
+				return std::move(buf);
+			}
+
+		private:
+			void align(const size_t a)
+			{
+				while (buf.size() % a) buf.push_back(0);
+			}
+
+			template<typename T> void put(const size_t at, const T v)
+			{
+				memcpy(buf.data() + at, &v, sizeof(T));
+			}
+
+			template<typename T> size_t append(const T v)
+			{
+				const auto at = buf.size();
+				buf.resize(at + sizeof(T));
+				put<T>(at, v);
+				return at;
+			}
+
+			void patch(const size_t slot, const size_t target)
+			{
+				put<uint32_t>(slot, static_cast<uint32_t>(target - slot));
+			}
+
+			size_t write(const node& n)
+			{
+				switch (n.form)
+				{
+				case node::shape::text:
+				{
+					align(4);
+					const auto at = append<uint32_t>(static_cast<uint32_t>(n.chars.size()));
+					buf.insert(buf.end(), n.chars.begin(), n.chars.end());
+					buf.push_back(0);
+					return at;
+				}
+				case node::shape::structs:
+				{
+					// the elements, not the length, carry the 8 byte alignment of the structs
+					while ((buf.size() + sizeof(uint32_t)) % 8) buf.push_back(0);
+					const auto at = append<uint32_t>(static_cast<uint32_t>(n.count));
+					buf.insert(buf.end(), n.raw.begin(), n.raw.end());
+					return at;
+				}
+				case node::shape::offsets:
+				{
+					align(4);
+					const auto at = append<uint32_t>(static_cast<uint32_t>(n.items.size()));
+					vector<size_t> slots;
+					for (size_t i = 0; i < n.items.size(); ++i)
+					{
+						slots.push_back(append<uint32_t>(0));
+					}
+					for (size_t i = 0; i < n.items.size(); ++i)
+					{
+						patch(slots[i], write(*n.items[i]));
+					}
+					return at;
+				}
+				default:
+					return write_table(n);
+				}
+			}
+
+			// the inline part holds the vtable soffset then the fields widest first, each
+			// aligned to its width, so the table itself only needs 8 byte alignment.
+			size_t write_table(const node& n)
+			{
+				const auto count = n.fields.size();
+				vector<size_t> order(count);
+				iota(order.begin(), order.end(), 0);
+				const auto width = [&](const size_t i) { return n.fields[i].width ? n.fields[i].width : sizeof(uint32_t); };
+				stable_sort(order.begin(), order.end(), [&](const size_t a, const size_t b) { return width(a) > width(b); });
+
+				vector<size_t> at(count);
+				size_t inline_size = sizeof(int32_t);
+				uint16_t slots = 0;
+				for (const auto i : order)
+				{
+					const auto w = width(i);
+					inline_size = (inline_size + w - 1) / w * w;
+					at[i] = inline_size;
+					inline_size += w;
+					slots = max(slots, static_cast<uint16_t>(n.fields[i].id + 1));
+				}
+				inline_size = (inline_size + 3) & ~static_cast<size_t>(3);
+
+				align(2);
+				const auto vtable = append<uint16_t>(static_cast<uint16_t>(2 * sizeof(uint16_t) + slots * sizeof(uint16_t)));
+				append<uint16_t>(static_cast<uint16_t>(inline_size));
+				for (uint16_t s = 0; s < slots; ++s)
+				{
+					append<uint16_t>(0);
+				}
+				for (size_t i = 0; i < count; ++i)
+				{
+					put<uint16_t>(vtable + 2 * sizeof(uint16_t) + n.fields[i].id * sizeof(uint16_t), static_cast<uint16_t>(at[i]));
+				}
+
+				align(8);
+				const auto start = buf.size();
+				buf.resize(start + inline_size, 0);
+				put<int32_t>(start, static_cast<int32_t>(start - vtable));
+				for (size_t i = 0; i < count; ++i)
+				{
+					const auto& f = n.fields[i];
+					if (f.width)
+					{
+						memcpy(buf.data() + start + at[i], &f.scalar, f.width);
+					}
+				}
+				for (size_t i = 0; i < count; ++i)
+				{
+					const auto& f = n.fields[i];
+					if (!f.width)
+					{
+						patch(start + at[i], write(*f.child));
+					}
+				}
+				return start;
+			}
+		};
+
+		enum class category { boolean, int32, int64, float64, decimal, timestamp, binary, utf8 };
+
+		static category category_of(const SQLSMALLINT t)
+		{
+			switch (t)
+			{
+			case SQL_BIT:
+				return category::boolean;
+			case SQL_TINYINT:
+			case SQL_SMALLINT:
+			case SQL_INTEGER:
+				return category::int32;
+			case SQL_BIGINT:
+				return category::int64;
+			case SQL_REAL:
+			case SQL_FLOAT:
+			case SQL_DOUBLE:
+				return category::float64;
+			case SQL_DECIMAL:
+			case SQL_NUMERIC:
+				return category::decimal;
+			case SQL_TYPE_DATE:
+			case SQL_TYPE_TIME:
+			case SQL_SS_TIME2:
+			case SQL_TIMESTAMP:
+			case SQL_DATETIME:
+			case SQL_TYPE_TIMESTAMP:
+			case SQL_SS_TIMESTAMPOFFSET:
+				return category::timestamp;
+			case SQL_BINARY:
+			case SQL_VARBINARY:
+			case SQL_LONGVARBINARY:
+			case SQL_SS_UDT:
+				return category::binary;
+			default:
+				return category::utf8;
+			}
+		}
+
+		static bool accepts(const category c, const Column::Kind k)
+		{
+			switch (c)
+			{
+			case category::boolean:
+			case category::int32:
+			case category::int64:
+			case category::float64:
+				return k == Column::Kind::Number || k == Column::Kind::Boolean;
+			case category::decimal:
+				return k == Column::Kind::Number || k == Column::Kind::Utf16 || k == Column::Kind::Utf8;
+			case category::timestamp:
+				return k == Column::Kind::Date;
+			case category::binary:
+				return k == Column::Kind::Binary;
+			default:
+				return k == Column::Kind::Utf16 || k == Column::Kind::Utf8;
+			}
+		}
+
+		static void append_utf8(vector<uint8_t>& out, const uint8_t* src, const size_t bytes)
+		{
+			const auto units = bytes / sizeof(uint16_t);
+			const auto unit = [&](const size_t i)
+			{
+				uint16_t u;
+				memcpy(&u, src + i * sizeof(uint16_t), sizeof(uint16_t));
+				return u;
+			};
+			for (size_t i = 0; i < units; ++i)
+			{
+				uint32_t c = unit(i);
+				if (c >= 0xd800 && c <= 0xdbff && i + 1 < units && unit(i + 1) >= 0xdc00 && unit(i + 1) <= 0xdfff)
+				{
+					c = 0x10000 + ((c - 0xd800) << 10) + (unit(++i) - 0xdc00);
+				}
+				else if (c >= 0xd800 && c <= 0xdfff)
+				{
+					c = 0xfffd;
+				}
+				if (c < 0x80)
+				{
+					out.push_back(static_cast<uint8_t>(c));
+				}
+				else if (c < 0x800)
+				{
+					out.push_back(static_cast<uint8_t>(0xc0 | (c >> 6)));
+					out.push_back(static_cast<uint8_t>(0x80 | (c & 0x3f)));
+				}
+				else if (c < 0x10000)
+				{
+					out.push_back(static_cast<uint8_t>(0xe0 | (c >> 12)));
+					out.push_back(static_cast<uint8_t>(0x80 | ((c >> 6) & 0x3f)));
+					out.push_back(static_cast<uint8_t>(0x80 | (c & 0x3f)));
+				}
+				else
+				{
+					out.push_back(static_cast<uint8_t>(0xf0 | (c >> 18)));
+					out.push_back(static_cast<uint8_t>(0x80 | ((c >> 12) & 0x3f)));
+					out.push_back(static_cast<uint8_t>(0x80 | ((c >> 6) & 0x3f)));
+					out.push_back(static_cast<uint8_t>(0x80 | (c & 0x3f)));
+				}
+			}
+		}
+
+		static void copy_text(vector<uint8_t>& out, const Column& column, const Column::Kind kind)
+		{
+			size_t n;
+			const auto* const src = column.bytes(n);
+			if (kind == Column::Kind::Utf16)
+			{
+				append_utf8(out, src, n);
+			}
+			else if (n > 0)
+			{
+				out.insert(out.end(), src, src + n);
+			}
+		}
+
+		// a decimal only arrives as a number when it was not read as text, e.g. by a prepared
+		// statement - a whole value is written exactly, anything else as the double it was read as.
+		static void append_number(vector<uint8_t>& out, const Column& column)
+		{
+			const auto d = column.as_double();
+			char text[32];
+			const auto whole = trunc(d) == d && fabs(d) < 9.2e18;
+			const auto n = whole
+				? snprintf(text, sizeof(text), "%lld", static_cast<long long>(column.as_int64()))
+				: snprintf(text, sizeof(text), "%.17g", d);
+			if (n > 0) out.insert(out.end(), text, text + n);
+		}
+
+		static node_ptr field_type(const category c, uint8_t& type_id)
+		{
+			switch (c)
+			{
+			case category::boolean:
+				type_id = fb::type_bool;
+				return table();
+			case category::int32:
+			case category::int64:
+			{
+				type_id = fb::type_int;
+				auto t = table();
+				t->scalar(0, 4, c == category::int32 ? 32 : 64)->scalar(1, 1, 1);
+				return t;
+			}
+			case category::float64:
+			{
+				type_id = fb::type_floating_point;
+				auto t = table();
+				t->scalar(0, 2, fb::precision_double);
+				return t;
+			}
+			case category::timestamp:
+			{
+				type_id = fb::type_timestamp;
+				auto t = table();
+				t->scalar(0, 2, fb::unit_microsecond)->child(1, text("UTC"));
+				return t;
+			}
+			case category::binary:
+				type_id = fb::type_binary;
+				return table();
+			default:
+				type_id = fb::type_utf8;
+				return table();
+			}
+		}
+
+		static void append_message(vector<uint8_t>& out, const uint8_t header_type, const node_ptr& header, const vector<uint8_t>& body)
+		{
+			auto message = table();
+			message->scalar(0, 2, static_cast<uint16_t>(fb::metadata_v5))
+				->scalar(1, 1, header_type)
+				->child(2, header)
+				->scalar(3, 8, body.size());
+			writer w;
+			const auto metadata = w.finish(message);
+			const auto at = out.size();
+			out.resize(at + 2 * sizeof(uint32_t));
+			const auto size = static_cast<int32_t>(metadata.size());
+			memcpy(out.data() + at, &fb::continuation, sizeof(uint32_t));
+			memcpy(out.data() + at + sizeof(uint32_t), &size, sizeof(int32_t));
+			out.insert(out.end(), metadata.begin(), metadata.end());
+			out.insert(out.end(), body.begin(), body.end());
+		}
+
+		static node_ptr schema(const ResultSet& result_set)
+		{
+			vector<node_ptr> fields;
+			for (size_t c = 0; c < result_set.get_column_count(); ++c)
+			{
+				const auto& definition = result_set.get_meta_data(static_cast<int>(c));
+				string name;
+				auto units = definition.name.size();
+				while (units > 0 && definition.name[units - 1] == 0) --units;
+				vector<uint16_t> wide(definition.name.begin(), definition.name.begin() + units);
+				vector<uint8_t> utf8;
+				append_utf8(utf8, reinterpret_cast<const uint8_t*>(wide.data()), wide.size() * sizeof(uint16_t));
+				name.assign(utf8.begin(), utf8.end());
+				uint8_t type_id = 0;
+				const auto type = field_type(category_of(definition.dataType), type_id);
+				auto field = table();
+				field->child(0, text(name))
+					->scalar(1, 1, 1)
+					->scalar(2, 1, type_id)
+					->child(3, type)
+					->child(5, offsets({}));
+				fields.push_back(field);
+			}
+			auto s = table();
+			s->scalar(0, 2, 0)->child(1, offsets(fields));
+			return s;
+		}
+
+		// buffers in the body start 8 byte aligned, their recorded length is unpadded.
+		class body_writer
+		{
+		public:
+			vector<uint8_t> body;
+			vector<int64_t> buffers;
+
+			size_t reserve(const size_t n)
+			{
+				const auto at = begin();
+				body.resize(at + n, 0);
+				end(at);
+				return at;
+			}
+
+			size_t begin()
+			{
+				while (body.size() % 8) body.push_back(0);
+				return body.size();
+			}
+
+			void end(const size_t at)
+			{
+				buffers.push_back(static_cast<int64_t>(at));
+				buffers.push_back(static_cast<int64_t>(body.size() - at));
+			}
+
+			template<typename T> void put(const size_t at, const size_t row, const T v)
+			{
+				memcpy(body.data() + at + row * sizeof(T), &v, sizeof(T));
+			}
+
+			void set_bit(const size_t at, const size_t row)
+			{
+				body[at + row / 8] |= static_cast<uint8_t>(1 << (row % 8));
+			}
+		};
+
+		bool encode(const ResultSet& result_set, const bool with_schema, const bool end_of_stream, vector<uint8_t>& out, string& error)
+		{
+			const auto rows = result_set.get_result_count();
+			const auto columns = result_set.get_column_count();
+			out.clear();
+
+			if (with_schema)
+			{
+				append_message(out, fb::header_schema, schema(result_set), {});
+			}
+
+			if (rows > 0 || with_schema)
+			{
+				body_writer w;
+				vector<int64_t> nodes;
+				const auto bitmap = (rows + 7) / 8;
+				for (size_t c = 0; c < columns; ++c)
+				{
+					const auto cat = category_of(result_set.get_meta_data(static_cast<int>(c)).dataType);
+					const auto validity = w.reserve(bitmap);
+					int64_t nulls = 0;
+					size_t data = 0;
+					size_t offsets_at = 0;
+					switch (cat)
+					{
+					case category::boolean:
+						data = w.reserve(bitmap);
+						break;
+					case category::int32:
+						data = w.reserve(rows * sizeof(int32_t));
+						break;
+					case category::decimal:
+					case category::binary:
+					case category::utf8:
+						offsets_at = w.reserve((rows + 1) * sizeof(int32_t));
+						break;
+					default:
+						data = w.reserve(rows * sizeof(int64_t));
+						break;
+					}
+					const auto variable = cat == category::decimal || cat == category::binary || cat == category::utf8;
+					const auto arena = variable ? w.begin() : 0;
+					for (size_t r = 0; r < rows; ++r)
+					{
+						if (variable)
+						{
+							const auto length = w.body.size() - arena;
+							if (length > static_cast<size_t>(numeric_limits<int32_t>::max()))
+							{
+								error = "arrow batch column exceeds 2GB, fetch fewer rows per batch";
+								return false;
+							}
+							w.put<int32_t>(offsets_at, r, static_cast<int32_t>(length));
+						}
+						const auto column = result_set.get_column(r, c);
+						const auto kind = column ? column->kind() : Column::Kind::Null;
+						if (kind == Column::Kind::Null)
+						{
+							++nulls;
+							continue;
+						}
+						if (!accepts(cat, kind))
+						{
+							error = "arrow encoding found a value that does not match the declared type of column " + to_string(c);
+							return false;
+						}
+						w.set_bit(validity, r);
+						switch (cat)
+						{
+						case category::boolean:
+							if (column->as_double() != 0) w.set_bit(data, r);
+							break;
+						case category::int32:
+							w.put<int32_t>(data, r, static_cast<int32_t>(column->as_int64()));
+							break;
+						case category::int64:
+							w.put<int64_t>(data, r, column->as_int64());
+							break;
+						case category::timestamp:
+							w.put<int64_t>(data, r, static_cast<const TimestampColumn&>(*column).as_microseconds());
+							break;
+						case category::decimal:
+							if (kind == Column::Kind::Number)
+							{
+								append_number(w.body, *column);
+							}
+							else
+							{
+								copy_text(w.body, *column, kind);
+							}
+							break;
+						case category::float64:
+							w.put<double>(data, r, column->as_double());
+							break;
+						default:
+							copy_text(w.body, *column, kind);
+							break;
+						}
+					}
+					if (variable)
+					{
+						const auto length = w.body.size() - arena;
+						if (length > static_cast<size_t>(numeric_limits<int32_t>::max()))
+						{
+							error = "arrow batch column exceeds 2GB, fetch fewer rows per batch";
+							return false;
+						}
+						w.put<int32_t>(offsets_at, rows, static_cast<int32_t>(length));
+						w.end(arena);
+					}
+					nodes.push_back(static_cast<int64_t>(rows));
+					nodes.push_back(nulls);
+				}
+				w.begin();
+
+				vector<uint8_t> node_bytes(nodes.size() * sizeof(int64_t));
+				if (!nodes.empty()) memcpy(node_bytes.data(), nodes.data(), node_bytes.size());
+				vector<uint8_t> buffer_bytes(w.buffers.size() * sizeof(int64_t));
+				if (!w.buffers.empty()) memcpy(buffer_bytes.data(), w.buffers.data(), buffer_bytes.size());
+				auto batch = table();
+				batch->scalar(0, 8, rows)
+					->child(1, structs(node_bytes, columns))
+					->child(2, structs(buffer_bytes, w.buffers.size() / 2));
+				append_message(out, fb::header_record_batch, batch, w.body);
+			}
+
+			if (end_of_stream)
+			{
+				const uint32_t eos[] = { fb::continuation, 0 };
+				const auto at = out.size();
+				out.resize(at + sizeof(eos));
+				memcpy(out.data() + at, eos, sizeof(eos));
+			}
+			return true;
+		}
+	}
+}
@@ -0,0 +1,55 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: Arrow.h
+// Contents: encode a fetched batch as Apache Arrow IPC stream messages
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace mssql
+{
+	using namespace std;
+
+	class ResultSet;
+
+	// each batch is appended as encapsulated IPC messages, all little endian:
+	//
+	//   u32 0xffffffff, i32 metadata size, Message flatbuffer padded to 8, body
+	//
+	// the first batch of a result set is preceded by its Schema message and the last is
+	// followed by the end of stream marker, so the buffers of one result set concatenated
+	// are a complete Arrow IPC stream. the schema comes from the column definitions:
+	//
+	//   bit                       Bool
+	//   tinyint smallint int      Int32
+	//   bigint                    Int64
+	//   real float                Float64
+	//   decimal numeric money     Utf8 (the text the driver gives, exact)
+	//   date time datetime*       Timestamp(us, UTC)
+	//   binary varbinary udt      Binary
+	//   anything else             Utf8 (nvarchar is transcoded from UTF-16)
+	//
+	// the cells are read from the fetched columns on the ODBC thread, nothing is built
+	// in JS other than the Buffer wrapping the bytes.
+	namespace arrow
+	{
+		bool encode(const ResultSet& result_set, bool with_schema, bool end_of_stream, vector<uint8_t>& out, string& error);
+	}
+}
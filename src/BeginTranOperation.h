@@ -34,6 +34,7 @@ namespace mssql
 		BeginTranOperation(const shared_ptr<OdbcConnection> &connection, const Local<Object> callback);
 		bool TryInvokeOdbc() override;
 		Local<Value> CreateCompletionArg() override;
+		OperationKind kind() const override { return OperationKind::BeginTran; }
 	};
 }
 
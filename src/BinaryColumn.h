@@ -17,6 +17,12 @@ namespace mssql
 		BinaryColumn(const int id, shared_ptr<DatumStorage> s, size_t l);
 		BinaryColumn(const int id, shared_ptr<DatumStorage> s, size_t offset, size_t l);
 		Local<Value> ToNative() override;
+		Kind kind() const override { return Kind::Binary; }
+		const uint8_t* bytes(size_t& n) const override
+		{
+			n = len;
+			return reinterpret_cast<const uint8_t*>(storage->data() + offset);
+		}
     Local<Value> ToString() override;
 
     private:
@@ -24,6 +24,9 @@ namespace mssql
 		   return AsString<bool>(value);
 	   }
 
+		Kind kind() const override { return Kind::Boolean; }
+		double as_double() const override { return value ? 1 : 0; }
+
 		inline Local<Value> ToNative() override
 		{
 			return Nan::New<Boolean>(value);
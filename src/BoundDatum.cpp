@@ -506,6 +506,15 @@ namespace mssql
 		param_size = rows; // max no of rows.
 		_indvec[0] = rows; // no of rows.
 		digits = 0;
+		if (MutateJS::as_boolean(get_as_bool(p, "tvp_stream")))
+		{
+			// rows are pushed from SQLParamData, row_count is then the chunk capacity.
+			is_tvp_stream = true;
+			tvp_stream_end = MutateJS::as_boolean(get_as_bool(p, "tvp_stream_end"));
+			const auto as_obj = Nan::To<Object>(p).ToLocalChecked();
+			tvp_stream_rows = MutateJS::getint32(as_obj, "tvp_stream_rows");
+			_indvec[0] = SQL_DATA_AT_EXEC;
+		}
 	}
 
 	void BoundDatum::bind_binary(Local<Value>& p)
@@ -2252,6 +2261,367 @@ namespace mssql
 		return true;
 	}
 
+	// a column handed over as the buffers of an arrow array - { type, unit, length, validity,
+	// offsets, data } - rather than as an array of js values. fixed width values are copied
+	// as one block into the storage the typed binders use, the validity bitmap decides the
+	// null indicators and strings or binary are cut from the data buffer by the offsets.
+
+	struct arrow_buffer
+	{
+		const char* data;
+		size_t len;
+	};
+
+	static arrow_buffer arrow_buffer_of(const Local<Object>& column, const char* key)
+	{
+		const auto v = get(key, column);
+		if (v->IsNullOrUndefined() || !node::Buffer::HasInstance(v)) return { nullptr, 0 };
+		const auto o = Nan::To<Object>(v).ToLocalChecked();
+		return { node::Buffer::Data(o), node::Buffer::Length(o) };
+	}
+
+	static bool arrow_valid(const arrow_buffer& validity, const size_t i)
+	{
+		if (validity.data == nullptr) return true;
+		return (static_cast<uint8_t>(validity.data[i >> 3]) >> (i & 7)) & 1;
+	}
+
+	static void arrow_indicators(vector<SQLLEN>& ind, const arrow_buffer& validity, const size_t len, const SQLLEN width)
+	{
+		for (size_t i = 0; i < len; ++i)
+		{
+			ind[i] = arrow_valid(validity, i) ? width : SQL_NULL_DATA;
+		}
+	}
+
+	template <typename T> static bool arrow_copy(vector<T>& vec, const arrow_buffer& data, const size_t len)
+	{
+		if (len == 0) return true;
+		if (data.data == nullptr || data.len < len * sizeof(T)) return false;
+		memcpy(vec.data(), data.data, len * sizeof(T));
+		return true;
+	}
+
+	template <typename T, typename S> static bool arrow_widen(vector<T>& vec, const arrow_buffer& data, const size_t len)
+	{
+		if (len == 0) return true;
+		if (data.data == nullptr || data.len < len * sizeof(S)) return false;
+		for (size_t i = 0; i < len; ++i)
+		{
+			S v;
+			memcpy(&v, data.data + i * sizeof(S), sizeof(S));
+			vec[i] = static_cast<T>(v);
+		}
+		return true;
+	}
+
+	static int32_t arrow_offset(const arrow_buffer& offsets, const size_t i)
+	{
+		int32_t v;
+		memcpy(&v, offsets.data + i * sizeof(int32_t), sizeof(int32_t));
+		return v;
+	}
+
+	// utf8 bytes to utf16 units, returns the count written - never more units than bytes.
+	static size_t utf8_to_utf16(const uint8_t* s, const size_t len, uint16_t* out)
+	{
+		size_t n = 0;
+		size_t i = 0;
+		while (i < len)
+		{
+			uint32_t c = s[i];
+			size_t extra = 0;
+			if (c >= 0xF0) { c &= 0x07; extra = 3; }
+			else if (c >= 0xE0) { c &= 0x0F; extra = 2; }
+			else if (c >= 0xC0) { c &= 0x1F; extra = 1; }
+			++i;
+			for (size_t k = 0; k < extra && i < len; ++k, ++i)
+			{
+				c = (c << 6) | (s[i] & 0x3F);
+			}
+			if (c >= 0x10000)
+			{
+				c -= 0x10000;
+				out[n++] = static_cast<uint16_t>(0xD800 + (c >> 10));
+				out[n++] = static_cast<uint16_t>(0xDC00 + (c & 0x3FF));
+			}
+			else
+			{
+				out[n++] = static_cast<uint16_t>(c);
+			}
+		}
+		return n;
+	}
+
+	// arrow time units as a divisor to milliseconds, seconds are a multiplier.
+	static void arrow_ms(const int64_t v, const string& unit, double& ms, uint32_t& sub_ns)
+	{
+		sub_ns = 0;
+		if (unit == "s")
+		{
+			ms = static_cast<double>(v) * 1000;
+			return;
+		}
+		int64_t per_ms = 1;
+		if (unit == "us") per_ms = 1000;
+		else if (unit == "ns") per_ms = 1000000;
+		auto whole = v / per_ms;
+		auto rem = v % per_ms;
+		if (rem < 0)
+		{
+			--whole;
+			rem += per_ms;
+		}
+		ms = static_cast<double>(whole);
+		sub_ns = static_cast<uint32_t>(rem * (1000000 / per_ms));
+	}
+
+	bool BoundDatum::bind_arrow_strings(const arrow_buffer& validity, const arrow_buffer& offsets, const arrow_buffer& data, const size_t len)
+	{
+		if (len > 0 && (offsets.data == nullptr || offsets.len < (len + 1) * sizeof(int32_t))) return false;
+		size_t max_bytes = 0;
+		for (size_t i = 0; i < len; ++i)
+		{
+			const auto start = arrow_offset(offsets, i);
+			const auto end = arrow_offset(offsets, i + 1);
+			if (start < 0 || end < start || static_cast<size_t>(end) > data.len) return false;
+			max_bytes = max(max_bytes, static_cast<size_t>(end - start));
+		}
+		const auto* const bytes = reinterpret_cast<const uint8_t*>(data.data);
+		constexpr auto size = sizeof(uint16_t);
+		if (is_bcp)
+		{
+			_storage->ReserveUint16Vec(len);
+			_indvec.resize(len);
+			sql_type = SQLNCHAR;
+			param_size = SQL_VARLEN_DATA;
+			buffer_len = static_cast<SQLLEN>(max_bytes) + 1;
+			bcp_terminator = reinterpret_cast<LPCBYTE>(L"");
+			bcp_terminator_len = sizeof(WCHAR);
+			auto& vec = *_storage->uint16_vec_vec_ptr;
+			for (size_t i = 0; i < len; ++i)
+			{
+				_indvec[i] = SQL_NULL_DATA;
+				if (!arrow_valid(validity, i)) continue;
+				const auto start = arrow_offset(offsets, i);
+				const auto width = static_cast<size_t>(arrow_offset(offsets, i + 1) - start);
+				const auto store = make_shared<DatumStorage::uint16_t_vec_t>(width + 1);
+				const auto units = utf8_to_utf16(bytes + start, width, store->data());
+				store->resize(units);
+				store->push_back(0);
+				vec[i] = store;
+				_indvec[i] = static_cast<SQLLEN>(units * size);
+			}
+			return true;
+		}
+		const auto max_str_len = max(static_cast<size_t>(1), max_bytes);
+		reserve_w_var_char_array(max_str_len, len);
+		auto* const base = _storage->uint16vec_ptr->data();
+		for (size_t i = 0; i < len; ++i)
+		{
+			_indvec[i] = SQL_NULL_DATA;
+			if (!arrow_valid(validity, i)) continue;
+			const auto start = arrow_offset(offsets, i);
+			const auto width = static_cast<size_t>(arrow_offset(offsets, i + 1) - start);
+			const auto units = utf8_to_utf16(bytes + start, width, base + max_str_len * i);
+			_indvec[i] = static_cast<SQLLEN>(units * size);
+		}
+		return true;
+	}
+
+	bool BoundDatum::bind_arrow_binary(const arrow_buffer& validity, const arrow_buffer& offsets, const arrow_buffer& data, const size_t len)
+	{
+		if (len > 0 && (offsets.data == nullptr || offsets.len < (len + 1) * sizeof(int32_t))) return false;
+		size_t max_obj_len = 0;
+		for (size_t i = 0; i < len; ++i)
+		{
+			const auto start = arrow_offset(offsets, i);
+			const auto end = arrow_offset(offsets, i + 1);
+			if (start < 0 || end < start || static_cast<size_t>(end) > data.len) return false;
+			max_obj_len = max(max_obj_len, static_cast<size_t>(end - start));
+		}
+		if (is_bcp)
+		{
+			_storage->ReserveCharVec(len);
+			_indvec.resize(len);
+			sql_type = SQLVARBINARY;
+			param_size = SQL_VARLEN_DATA;
+			buffer_len = static_cast<SQLLEN>(max_obj_len);
+			auto& vec = *_storage->char_vec_vec_ptr;
+			for (size_t i = 0; i < len; ++i)
+			{
+				_indvec[i] = SQL_NULL_DATA;
+				if (!arrow_valid(validity, i)) continue;
+				const auto start = arrow_offset(offsets, i);
+				const auto width = static_cast<size_t>(arrow_offset(offsets, i + 1) - start);
+				vec[i] = make_shared<DatumStorage::char_vec_t>(data.data + start, data.data + start + width);
+				_indvec[i] = static_cast<SQLLEN>(width);
+			}
+			return true;
+		}
+		reserve_var_binary_array(max_obj_len, len);
+		auto* const base = _storage->charvec_ptr->data();
+		for (size_t i = 0; i < len; ++i)
+		{
+			_indvec[i] = SQL_NULL_DATA;
+			if (!arrow_valid(validity, i)) continue;
+			const auto start = arrow_offset(offsets, i);
+			const auto width = static_cast<size_t>(arrow_offset(offsets, i + 1) - start);
+			if (width > 0) memcpy(base + max_obj_len * i, data.data + start, width);
+			_indvec[i] = static_cast<SQLLEN>(width);
+		}
+		return true;
+	}
+
+	bool BoundDatum::bind_arrow(Local<Object>& po, const Local<Value>& v)
+	{
+		if (!v->IsObject())
+		{
+			err = const_cast<char*>("Invalid arrow column");
+			return false;
+		}
+		param_type = SQL_PARAM_INPUT;
+		assign_precision(po);
+		const auto column = Nan::To<Object>(v).ToLocalChecked();
+		const Nan::Utf8String type_str(get("type", column));
+		const string type = *type_str ? *type_str : "";
+		const auto unit_val = get("unit", column);
+		const string unit = unit_val->IsString() ? string(*Nan::Utf8String(unit_val)) : "ms";
+		const auto len = static_cast<size_t>(max(0, MutateJS::getint32(column, "length")));
+		const auto validity = arrow_buffer_of(column, "validity");
+		const auto offsets = arrow_buffer_of(column, "offsets");
+		const auto data = arrow_buffer_of(column, "data");
+		if (validity.data != nullptr && validity.len < (len + 7) / 8)
+		{
+			err = const_cast<char*>("Invalid arrow column - validity bitmap too short");
+			return false;
+		}
+
+		auto res = true;
+		if (type == "null")
+		{
+			reserve_null(static_cast<SQLLEN>(len));
+			for (size_t i = 0; i < len; ++i) _indvec[i] = SQL_NULL_DATA;
+		}
+		else if (type == "bool")
+		{
+			reserve_boolean(static_cast<SQLLEN>(len));
+			res = len == 0 || (data.data != nullptr && data.len >= (len + 7) / 8);
+			if (res)
+			{
+				auto& vec = *_storage->charvec_ptr;
+				for (size_t i = 0; i < len; ++i)
+				{
+					vec[i] = static_cast<char>((static_cast<uint8_t>(data.data[i >> 3]) >> (i & 7)) & 1);
+				}
+				arrow_indicators(_indvec, validity, len, is_bcp ? sizeof(int8_t) : 0);
+			}
+		}
+		else if (type == "int8")
+		{
+			reserve_int16(static_cast<SQLLEN>(len));
+			res = arrow_widen<int16_t, int8_t>(*_storage->int16vec_ptr, data, len);
+			arrow_indicators(_indvec, validity, len, is_bcp ? sizeof(int16_t) : 0);
+		}
+		else if (type == "int16")
+		{
+			reserve_int16(static_cast<SQLLEN>(len));
+			res = arrow_copy(*_storage->int16vec_ptr, data, len);
+			arrow_indicators(_indvec, validity, len, is_bcp ? sizeof(int16_t) : 0);
+		}
+		else if (type == "int32")
+		{
+			reserve_int32(static_cast<SQLLEN>(len));
+			res = arrow_copy(*_storage->int32vec_ptr, data, len);
+			arrow_indicators(_indvec, validity, len, is_bcp ? sizeof(int32_t) : 0);
+		}
+		else if (type == "int64")
+		{
+			reserve_integer(static_cast<SQLLEN>(len));
+			res = arrow_copy(*_storage->int64vec_ptr, data, len);
+			arrow_indicators(_indvec, validity, len, is_bcp ? sizeof(int64_t) : 0);
+		}
+		else if (type == "float32")
+		{
+			reserve_double(static_cast<SQLLEN>(len));
+			res = arrow_widen<double, float>(*_storage->doublevec_ptr, data, len);
+			arrow_indicators(_indvec, validity, len, is_bcp ? sizeof(double) : 0);
+		}
+		else if (type == "float64")
+		{
+			reserve_double(static_cast<SQLLEN>(len));
+			res = arrow_copy(*_storage->doublevec_ptr, data, len);
+			arrow_indicators(_indvec, validity, len, is_bcp ? sizeof(double) : 0);
+		}
+		else if (type == "date32" || type == "date64")
+		{
+			const auto width = type == "date32" ? sizeof(int32_t) : sizeof(int64_t);
+			reserve_date(static_cast<SQLLEN>(len));
+			res = len == 0 || (data.data != nullptr && data.len >= len * width);
+			auto& vec = *_storage->datevec_ptr;
+			for (size_t i = 0; res && i < len; ++i)
+			{
+				_indvec[i] = SQL_NULL_DATA;
+				if (!arrow_valid(validity, i)) continue;
+				double ms;
+				if (width == sizeof(int32_t))
+				{
+					int32_t days;
+					memcpy(&days, data.data + i * width, width);
+					ms = static_cast<double>(days) * 86400000;
+				}
+				else
+				{
+					int64_t v64;
+					memcpy(&v64, data.data + i * width, width);
+					ms = static_cast<double>(v64);
+				}
+				const TimestampColumn sql_date(-1, ms);
+				sql_date.ToDateStruct(vec[i]);
+				_indvec[i] = sizeof(SQL_DATE_STRUCT);
+			}
+		}
+		else if (type == "timestamp")
+		{
+			reserve_time_stamp(static_cast<SQLLEN>(len));
+			res = len == 0 || (data.data != nullptr && data.len >= len * sizeof(int64_t));
+			auto& vec = *_storage->timestampvec_ptr;
+			for (size_t i = 0; res && i < len; ++i)
+			{
+				_indvec[i] = SQL_NULL_DATA;
+				if (!arrow_valid(validity, i)) continue;
+				int64_t v64;
+				memcpy(&v64, data.data + i * sizeof(int64_t), sizeof(int64_t));
+				double ms;
+				uint32_t sub_ns;
+				arrow_ms(v64, unit, ms, sub_ns);
+				const TimestampColumn sql_date(-1, ms - offset * 60000);
+				sql_date.to_timestamp_struct(vec[i]);
+				vec[i].fraction += sub_ns;
+				_indvec[i] = sizeof(SQL_TIMESTAMP_STRUCT);
+			}
+		}
+		else if (type == "utf8")
+		{
+			res = bind_arrow_strings(validity, offsets, data, len);
+		}
+		else if (type == "binary")
+		{
+			res = bind_arrow_binary(validity, offsets, data, len);
+		}
+		else
+		{
+			err = const_cast<char*>("Unsupported arrow column type");
+			return false;
+		}
+
+		if (!res)
+		{
+			err = const_cast<char*>("Invalid arrow column - buffer shorter than its length");
+		}
+		return res;
+	}
+
 	bool BoundDatum::bind_object(Local<Value>& p)
 	{
 		// fprintf(stderr, "bind obj\n");
@@ -2270,6 +2640,12 @@ namespace mssql
 			return proc_bind(p, v);
 		}
 
+		v = get("arrow", po);
+		if (!v->IsUndefined())
+		{
+			return bind_arrow(po, v);
+		}
+
 		v = get("sql_type", po);
 		if (!v->IsUndefined())
 		{
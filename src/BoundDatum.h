@@ -8,6 +8,7 @@ namespace mssql
 {
 	using namespace std;
 	class QueryOperationParams;
+	struct arrow_buffer;
 
 	class BoundDatum {
 	public:
@@ -48,6 +49,11 @@ namespace mssql
 			is_tvp(false),
 			is_money(false),
 			tvp_no_cols(0),
+			is_tvp_stream(false),
+			tvp_stream_end(false),
+			tvp_stream_rows(0),
+			stream_width(0),
+			stream_max(false),
 			definedPrecision(false),
 			definedScale(false),
 			err(nullptr)
@@ -94,6 +100,14 @@ namespace mssql
 		bool is_tvp;
 		bool is_money;
 		int tvp_no_cols;
+		// a streamed tvp is bound data at execution, rows arrive in chunks of at most
+		// param_size - tvp_stream_rows is how many this chunk holds, end marks the last.
+		bool is_tvp_stream;
+		bool tvp_stream_end;
+		SQLLEN tvp_stream_rows;
+		// on a streamed tvp column, the bytes reserved per row and whether the declared type is max.
+		SQLLEN stream_width;
+		bool stream_max;
 		wstring name;
 
 
@@ -196,6 +210,10 @@ namespace mssql
 		void bind_var_binary_array_bcp(const Local<Value> & p);
 		void reserve_var_binary_array(size_t max_obj_len, size_t  array_len);
 
+		bool bind_arrow(Local<Object> &po, const Local<Value> &v);
+		bool bind_arrow_strings(const arrow_buffer& validity, const arrow_buffer& offsets, const arrow_buffer& data, size_t len);
+		bool bind_arrow_binary(const arrow_buffer& validity, const arrow_buffer& offsets, const arrow_buffer& data, size_t len);
+
 		bool bind_datum_type(Local<Value>& p);
 		bool bind(Local<Object> o, const char* if_str, uint16_t type);
 		bool bind_object(Local<Value> &p);
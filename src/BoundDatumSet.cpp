@@ -3,6 +3,7 @@
 #include <BoundDatumSet.h>
 #include <QueryOperationParams.h>
 #include <ResultSet.h>
+#include <MutateJS.h>
 
 namespace mssql
 {
@@ -44,9 +45,81 @@ namespace mssql
 		return val;
 	}
 
+	// { bind_rows: true, rows, columns: [{ key, param }] } stands for one parameter per column.
+	static bool is_bind_rows(const Local<Value>& v)
+	{
+		if (v.IsEmpty() || !v->IsObject() || v->IsArray()) return false;
+		return MutateJS::getbool(Nan::To<Object>(v).ToLocalChecked(), "bind_rows");
+	}
+
+	static bool get_bind_rows(const Local<Value>& v, Local<Array>& rows, Local<Array>& cols)
+	{
+		const auto set = Nan::To<Object>(v).ToLocalChecked();
+		const auto rows_val = get(set, "rows");
+		const auto cols_val = get(set, "columns");
+		if (!rows_val->IsArray() || !cols_val->IsArray()) return false;
+		rows = rows_val.As<Array>();
+		cols = cols_val.As<Array>();
+		return true;
+	}
+
+	// a shallow copy of the caller's param carrying the column as its value, so the same
+	// param object can be handed in again for the next set of rows.
+	static Local<Value> param_with_value(const Local<Object>& param, const Local<Value>& value)
+	{
+		const auto copy = Nan::New<Object>();
+		const auto names = Nan::GetOwnPropertyNames(param).ToLocalChecked();
+		for (uint32_t i = 0; i < names->Length(); ++i)
+		{
+			const auto name = Nan::Get(names, i).ToLocalChecked();
+			Nan::Set(copy, name, Nan::Get(param, name).ToLocalChecked());
+		}
+		Nan::Set(copy, Nan::New("value").ToLocalChecked(), value);
+		return copy;
+	}
+
+	// one column of the rows, each cell read through a key made once, into the array the
+	// typed binders take - an object row is read by key, an array row by column position. a
+	// column with a param (sql type, precision ...) is bound through a copy of the param, one
+	// without from the array alone. the caller binds each column before the next is built,
+	// so only one column is ever held a second time outside its DatumStorage.
+	static bool expand_column(const Local<Array>& rows, const Local<Array>& cols, const uint32_t c, Local<Value>& column)
+	{
+		const auto spec = Nan::Get(cols, c).ToLocalChecked();
+		if (!spec->IsObject()) return false;
+		const auto spec_obj = Nan::To<Object>(spec).ToLocalChecked();
+		const auto key = get(spec_obj, "key");
+		const auto row_count = rows->Length();
+		const auto arr = Nan::New<Array>(row_count);
+		const auto null_val = Nan::Null();
+		for (uint32_t r = 0; r < row_count; ++r)
+		{
+			const auto row = Nan::Get(rows, r).ToLocalChecked();
+			if (!row->IsObject())
+			{
+				Nan::Set(arr, r, null_val);
+				continue;
+			}
+			const auto row_obj = Nan::To<Object>(row).ToLocalChecked();
+			const auto cell = (row->IsArray() ? Nan::Get(row_obj, c) : Nan::Get(row_obj, key)).ToLocalChecked();
+			Nan::Set(arr, r, cell->IsUndefined() ? Local<Value>(null_val) : cell);
+		}
+
+		const auto param = get(spec_obj, "param");
+		column = param->IsObject()
+			? param_with_value(Nan::To<Object>(param).ToLocalChecked(), arr)
+			: Local<Value>(arr);
+		return true;
+	}
+
 	int get_tvp_col_count(const Local<Value>& v)
 	{
 		const auto tvp_columns = Nan::Get(Nan::To<Object>(v).ToLocalChecked(), Nan::New("table_value_param").ToLocalChecked()).ToLocalChecked();
+		if (is_bind_rows(tvp_columns))
+		{
+			const auto cols = get(Nan::To<Object>(tvp_columns).ToLocalChecked(), "columns");
+			return cols->IsArray() ? cols.As<Array>()->Length() : 0;
+		}
 		const auto cols = tvp_columns.As<Array>();
 		const auto count = cols->Length();
 		return count;
@@ -56,16 +129,39 @@ namespace mssql
 	{
 		const auto tvp_columns = Nan::Get(Nan::To<Object>(v).ToLocalChecked(), Nan::New("table_value_param").ToLocalChecked()).ToLocalChecked();
 		if (tvp_columns->IsNull()) return false;
-		if (!tvp_columns->IsArray()) return false;
-
-		const auto cols = tvp_columns.As<Array>();
-		const auto count = cols->Length();
+		const auto as_rows = is_bind_rows(tvp_columns);
+		Local<Array> rows;
+		Local<Array> cols;
+		if (as_rows)
+		{
+			if (!get_bind_rows(tvp_columns, rows, cols)) return false;
+		}
+		else
+		{
+			if (!tvp_columns->IsArray()) return false;
+			cols = tvp_columns.As<Array>();
+		}
 
-		for (uint32_t i = 0; i < count; ++i) {
+		for (uint32_t i = 0; i < cols->Length(); ++i) {
+			Nan::HandleScope scope;
+			Local<Value> p;
+			if (as_rows)
+			{
+				if (!expand_column(rows, cols, i, p)) return false;
+			}
+			else
+			{
+				p = Nan::Get(cols, i).ToLocalChecked();
+			}
 			const auto binding = make_shared<BoundDatum>();
-			auto p = Nan::Get(Nan::To<Object>(tvp_columns).ToLocalChecked(), i).ToLocalChecked();
 			const auto res = binding->bind(p);
 			if (!res) break;
+			if (p->IsObject())
+			{
+				const auto as_obj = Nan::To<Object>(p).ToLocalChecked();
+				binding->stream_width = MutateJS::getint32(as_obj, "stream_width");
+				binding->stream_max = MutateJS::getbool(as_obj, "stream_max");
+			}
 			_bindings->push_back(binding);
 		}
 		return true;
@@ -77,39 +173,80 @@ namespace mssql
 		auto res = true;
 		_output_param_count = 0;
 		if (count > 0) {
-			for (uint32_t i = 0; i < count; ++i) {
-				const auto binding = make_shared<BoundDatum>();
+			for (uint32_t i = 0; i < count && res; ++i) {
 				auto v = Nan::Get(node_params, i).ToLocalChecked();
-				res = binding->bind(v);
-
-				switch (binding->param_type)
+				if (is_bind_rows(v))
 				{
-				case SQL_PARAM_OUTPUT:
-				case SQL_PARAM_INPUT_OUTPUT:
-					_output_param_count++;
-					break;
-
-				default:
-					break;
+					res = bind_rows(v, i);
 				}
-
-				if (!res) {
-					err = binding->getErr();
-					first_error = i;
-					break;
+				else
+				{
+					res = bind_one(v, i);
 				}
+			}
+		}
 
-				_bindings->push_back(binding);
+		return res;
+	}
 
-				if (binding->is_tvp)
-				{
-					const auto col_count = get_tvp_col_count(v);
-					binding->tvp_no_cols = col_count;
-					res = tvp(v);
-				}
+	// a failure is reported against the parameter the failing column binds as, not the
+	// position of the BindRows in the params given.
+	bool BoundDatumSet::bind_rows(const Local<Value>& v, const uint32_t i)
+	{
+		Local<Array> rows;
+		Local<Array> cols;
+		if (!get_bind_rows(v, rows, cols))
+		{
+			err = const_cast<char*>("Invalid bind rows - expected rows and columns arrays");
+			first_error = i;
+			return false;
+		}
+		for (uint32_t c = 0; c < cols->Length(); ++c)
+		{
+			Nan::HandleScope scope;
+			const auto param_index = static_cast<uint32_t>(_bindings->size());
+			Local<Value> column;
+			if (!expand_column(rows, cols, c, column))
+			{
+				err = const_cast<char*>("Invalid bind rows - each column must be an object");
+				first_error = param_index;
+				return false;
 			}
+			if (!bind_one(column, param_index)) return false;
 		}
+		return true;
+	}
+
+	bool BoundDatumSet::bind_one(Local<Value>& v, const uint32_t i)
+	{
+		const auto binding = make_shared<BoundDatum>();
+		auto res = binding->bind(v);
 
+		switch (binding->param_type)
+		{
+		case SQL_PARAM_OUTPUT:
+		case SQL_PARAM_INPUT_OUTPUT:
+			_output_param_count++;
+			break;
+
+		default:
+			break;
+		}
+
+		if (!res) {
+			err = binding->getErr();
+			first_error = i;
+			return false;
+		}
+
+		_bindings->push_back(binding);
+
+		if (binding->is_tvp)
+		{
+			const auto col_count = get_tvp_col_count(v);
+			binding->tvp_no_cols = col_count;
+			res = tvp(v);
+		}
 		return res;
 	}
 
@@ -19,6 +19,7 @@ namespace mssql
 		Local<Array> unbind() const;	
 		void clear() { _bindings->clear(); }
 		size_t size() { return _bindings->size(); }
+		void push_back(const shared_ptr<BoundDatum> &datum) { _bindings->push_back(datum); }
 		shared_ptr<BoundDatum> & atIndex(int i) { return (*_bindings)[i]; }
 		param_bindings::iterator begin() { return _bindings->begin(); }
 		param_bindings::iterator end() { return _bindings->end(); }
@@ -28,6 +29,8 @@ namespace mssql
 
 	private:
 		bool tvp(Local<Value> &v) const;
+		bool bind_rows(const Local<Value> &v, uint32_t i);
+		bool bind_one(Local<Value> &v, uint32_t i);
 		int _output_param_count;
 		shared_ptr<param_bindings> _bindings;
 		shared_ptr<QueryOperationParams> _params;
@@ -50,10 +50,17 @@ namespace mssql
 		  	return ToValue();
 	   }
 
+	   Kind kind() const override { return Kind::Utf8; }
+	   const uint8_t* bytes(size_t& n) const override
+	   {
+		   n = size;
+		   return reinterpret_cast<const uint8_t*>(storage->data() + offset);
+	   }
+
 	   inline Local<Value> ToNative() override
 	   {
 		   	auto sptr = storage->data();
-		  	auto s = Nan::Encode(sptr + offset, size, Nan::UTF8);
+		  	auto s = utf8_to_value(sptr + offset, size);
 		  	return s;
 	   }
 
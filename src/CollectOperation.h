@@ -34,6 +34,7 @@ namespace mssql
 		CollectOperation(const shared_ptr<OdbcConnection> &connection);
 		bool TryInvokeOdbc() override;
 		Local<Value> CreateCompletionArg() override;
+		OperationKind kind() const override { return OperationKind::Collect; }
 		// override to not call a callback
 	};
 }
@@ -42,6 +42,15 @@ namespace mssql
 		
 		virtual Local<Value> ToString() = 0;
 
+		// how the cell is laid out when a batch is encoded into a columnar buffer
+		// off the isolate thread - see Columnar.h.
+		enum class Kind : uint8_t { Null = 0, Number = 1, Boolean = 2, Date = 3, Utf16 = 4, Utf8 = 5, Binary = 6 };
+		virtual Kind kind() const { return Kind::Null; }
+		virtual double as_double() const { return 0; }
+		// exact for the integer columns, where a double would round past 2^53.
+		virtual int64_t as_int64() const { return static_cast<int64_t>(as_double()); }
+		virtual const uint8_t* bytes(size_t& n) const { n = 0; return nullptr; }
+
 		int Id() const { return _id; }
 		void AsString() {
 			_asNative = false;
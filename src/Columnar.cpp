@@ -0,0 +1,162 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: Columnar.cpp
+// Contents: encode a fetched batch into a flat column major buffer
+//
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include <Columnar.h>
+#include <ResultSet.h>
+#include <Column.h>
+#include <cstring>
+#include <limits>
+
+namespace mssql
+{
+	namespace columnar
+	{
+		static size_t align8(const size_t v)
+		{
+			return (v + 7) & ~static_cast<size_t>(7);
+		}
+
+		template<typename T> static void put(vector<uint8_t>& out, const size_t at, const T v)
+		{
+			memcpy(out.data() + at, &v, sizeof(T));
+		}
+
+		static bool is_variable(const Column::Kind k)
+		{
+			return k == Column::Kind::Utf16 || k == Column::Kind::Utf8 || k == Column::Kind::Binary;
+		}
+
+		struct column_plan
+		{
+			Column::Kind kind = Column::Kind::Null;
+			size_t nulls = 0;
+			size_t data = 0;
+			size_t arena = 0;
+			size_t arena_bytes = 0;
+		};
+
+		bool encode(const ResultSet& result_set, vector<uint8_t>& out, string& error)
+		{
+			const auto rows = result_set.get_result_count();
+			const auto columns = result_set.get_column_count();
+			vector<column_plan> plan(columns);
+
+			// first pass settles each column's kind and how much arena it needs, so the
+			// buffer is sized once and cells are copied straight into place.
+			for (size_t c = 0; c < columns; ++c)
+			{
+				auto& p = plan[c];
+				for (size_t r = 0; r < rows; ++r)
+				{
+					const auto column = result_set.get_column(r, c);
+					const auto kind = column ? column->kind() : Column::Kind::Null;
+					if (kind == Column::Kind::Null) continue;
+					if (p.kind == Column::Kind::Null)
+					{
+						p.kind = kind;
+					}
+					else if (p.kind != kind)
+					{
+						error = "columnar encoding cannot mix value kinds in column " + to_string(c);
+						return false;
+					}
+					if (is_variable(kind))
+					{
+						size_t n;
+						column->bytes(n);
+						p.arena_bytes += n;
+					}
+				}
+			}
+
+			auto size = align8(header_size + columns * descriptor_size);
+			for (auto& p : plan)
+			{
+				p.nulls = size;
+				size = align8(size + rows);
+				if (p.kind == Column::Kind::Null) continue;
+				p.data = size;
+				if (is_variable(p.kind))
+				{
+					size = align8(size + (rows + 1) * sizeof(uint32_t));
+					p.arena = size;
+					size = align8(size + p.arena_bytes);
+				}
+				else
+				{
+					size += rows * sizeof(double);
+				}
+			}
+			if (size > numeric_limits<uint32_t>::max())
+			{
+				error = "columnar batch exceeds 4GB, fetch fewer rows per batch";
+				return false;
+			}
+
+			out.assign(size, 0);
+			put<uint32_t>(out, 0, magic);
+			put<uint32_t>(out, 4, version);
+			put<uint32_t>(out, 8, static_cast<uint32_t>(rows));
+			put<uint32_t>(out, 12, static_cast<uint32_t>(columns));
+
+			for (size_t c = 0; c < columns; ++c)
+			{
+				const auto& p = plan[c];
+				const auto descriptor = header_size + c * descriptor_size;
+				out[descriptor] = static_cast<uint8_t>(p.kind);
+				put<uint32_t>(out, descriptor + 4, static_cast<uint32_t>(p.nulls));
+				put<uint32_t>(out, descriptor + 8, static_cast<uint32_t>(p.data));
+				put<uint32_t>(out, descriptor + 12, static_cast<uint32_t>(p.arena));
+
+				const auto variable = is_variable(p.kind);
+				uint32_t cursor = 0;
+				for (size_t r = 0; r < rows; ++r)
+				{
+					const auto column = result_set.get_column(r, c);
+					const auto is_null = !column || column->kind() == Column::Kind::Null;
+					out[p.nulls + r] = is_null ? 1 : 0;
+					if (p.kind == Column::Kind::Null) continue;
+					if (variable)
+					{
+						put<uint32_t>(out, p.data + r * sizeof(uint32_t), cursor);
+						if (is_null) continue;
+						size_t n;
+						const auto* const src = column->bytes(n);
+						if (n > 0)
+						{
+							memcpy(out.data() + p.arena + cursor, src, n);
+						}
+						cursor += static_cast<uint32_t>(n);
+					}
+					else
+					{
+						put<double>(out, p.data + r * sizeof(double), is_null ? 0.0 : column->as_double());
+					}
+				}
+				if (variable)
+				{
+					put<uint32_t>(out, p.data + rows * sizeof(uint32_t), cursor);
+				}
+			}
+			return true;
+		}
+	}
+}
@@ -0,0 +1,52 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: Columnar.h
+// Contents: encode a fetched batch into a flat column major buffer
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace mssql
+{
+	using namespace std;
+
+	class ResultSet;
+
+	// layout, all little endian and every section aligned to 8 bytes:
+	//
+	//   header       u32 magic, u32 version, u32 rows, u32 columns
+	//   descriptors  per column: u8 kind, u8[3] pad, u32 nulls, u32 data, u32 arena
+	//   nulls        one byte per row, 1 where the cell is null
+	//   data         Number, Boolean, Date - one f64 per row (dates as ms since epoch)
+	//                Utf16, Utf8, Binary - rows + 1 u32 byte offsets into the arena
+	//   arena        the variable length cells back to back
+	//
+	// lib/columnar.js is the reader. the buffer is built on the ODBC thread so the
+	// isolate only has to wrap it, and a worker can be handed it without a copy.
+	namespace columnar
+	{
+		const uint32_t magic = 0x4c43534d; // "MSCL"
+		const uint32_t version = 1;
+		const size_t header_size = 16;
+		const size_t descriptor_size = 16;
+
+		bool encode(const ResultSet& result_set, vector<uint8_t>& out, string& error);
+	}
+}
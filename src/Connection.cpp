@@ -20,14 +20,13 @@
 #include "stdafx.h"
 #include <Connection.h>
 #include <OdbcConnection.h>
+#include <ConnectionPool.h>
 #include <MutateJS.h>
 
 namespace mssql
 {
 	using namespace v8;
 
-	Nan::Persistent<v8::Function> Connection::constructor;
-
 	Connection::Connection()
 		: connectionBridge(make_unique<OdbcConnectionBridge>())
 	{
@@ -37,10 +36,16 @@ namespace mssql
 	{
 		 Nan::SetPrototypeMethod(tpl, "close", close);
 		 Nan::SetPrototypeMethod(tpl, "open", open);
+		 Nan::SetPrototypeMethod(tpl, "adopt", adopt);
 		 Nan::SetPrototypeMethod(tpl, "query", query);
 		 Nan::SetPrototypeMethod(tpl, "bindQuery", bind_query);
+		 Nan::SetPrototypeMethod(tpl, "sendTvpRows", send_tvp_rows);
 		 Nan::SetPrototypeMethod(tpl, "prepare", prepare);
 		 Nan::SetPrototypeMethod(tpl, "readColumn", read_column);
+		 Nan::SetPrototypeMethod(tpl, "readColumnar", read_columnar);
+		 Nan::SetPrototypeMethod(tpl, "readArrow", read_arrow);
+		 Nan::SetPrototypeMethod(tpl, "queryBatch", query_batch);
+		 Nan::SetPrototypeMethod(tpl, "pausePrefetch", pause_prefetch);
 		 Nan::SetPrototypeMethod(tpl, "beginTransaction", begin_transaction);
 		 Nan::SetPrototypeMethod(tpl, "commit", commit);
 		 Nan::SetPrototypeMethod(tpl, "rollback", rollback);
@@ -50,6 +55,7 @@ namespace mssql
 		 Nan::SetPrototypeMethod(tpl, "freeStatement", free_statement);
 		 Nan::SetPrototypeMethod(tpl, "cancelQuery", cancel_statement);
 		 Nan::SetPrototypeMethod(tpl, "pollingMode", polling_mode);
+		 Nan::SetPrototypeMethod(tpl, "getStats", get_stats);
 	}
 
 	void Connection::Init(Local<Object> exports) {
@@ -64,16 +70,28 @@ namespace mssql
 		}
 
 		// Prepare constructor template
-		auto tpl = Nan::New<FunctionTemplate>(New);
+		auto* const data = new AddonData();
+		auto tpl = Nan::New<FunctionTemplate>(New, Nan::New<External>(data));
 		tpl->SetClassName(name);
 		tpl->InstanceTemplate()->SetInternalFieldCount(1);
 
 		api(tpl);
 
-  		constructor.Reset(Nan::GetFunction(tpl).ToLocalChecked());
-		Nan::Set(exports, name, Nan::GetFunction(tpl).ToLocalChecked());
+		const auto cons = Nan::GetFunction(tpl).ToLocalChecked();
+  		data->constructor.Reset(cons);
+		Nan::Set(exports, name, cons);
+		node::AddEnvironmentCleanupHook(Isolate::GetCurrent(), cleanup, data);
  	}
 
+	// runs on the owning thread as its node environment (main or worker) shuts down.
+	void Connection::cleanup(void* arg)
+	{
+		auto* const data = static_cast<AddonData*>(arg);
+		data->constructor.Reset();
+		delete data;
+		OdbcConnection::ReleaseEnvironment();
+	}
+
 	Connection::~Connection()
 	{
 		// close the connection now since the object is being collected
@@ -123,7 +141,8 @@ namespace mssql
     		// Invoked as plain function `MyObject(...)`, turn into construct call.
     		constexpr auto argc = 1;
     		Local<Value> argv[argc] = {info[0]};
-            const auto cons = Nan::New<Function>(constructor);
+            const auto* const data = static_cast<AddonData*>(info.Data().As<External>()->Value());
+            const auto cons = Nan::New<Function>(data->constructor);
     		info.GetReturnValue().Set(
         	cons->NewInstance(context, argc, argv).ToLocalChecked());
   		}
@@ -163,6 +182,17 @@ namespace mssql
 		info.GetReturnValue().Set(ret);
 	}
 
+	void Connection::send_tvp_rows(NanCb info)
+	{
+		const auto query_id = info[0].As<Number>();
+		const auto params = info[1].As<Array>();
+		const auto callback = info[2].As<Object>();
+
+		const auto* const connection = Unwrap<Connection>(info.This());
+		const auto ret = connection->connectionBridge->send_tvp_rows(query_id, params, callback);
+		info.GetReturnValue().Set(ret);
+	}
+
 	void Connection::call_procedure(NanCb info)
 	{
 		// need to ensure the signature is changed (in js ?) to form (?) = call sproc (?, ? ... );
@@ -204,6 +234,70 @@ namespace mssql
 		info.GetReturnValue().Set(ret);
 	}
 
+	void Connection::read_columnar(NanCb info)
+	{
+		const auto query_id = info[0].As<Number>();
+		const auto number_rows = info[1].As<Number>();
+		const auto shared = info[2].As<Boolean>();
+		const auto cb = info[3].As<Object>();
+		const auto* const connection = Unwrap<Connection>(info.This());
+		const auto ret = connection->connectionBridge->read_columnar(query_id, number_rows, shared, cb);
+		info.GetReturnValue().Set(ret);
+	}
+
+	void Connection::read_arrow(NanCb info)
+	{
+		const auto query_id = info[0].As<Number>();
+		const auto number_rows = info[1].As<Number>();
+		const auto with_schema = info[2].As<Boolean>();
+		const auto cb = info[3].As<Object>();
+		const auto* const connection = Unwrap<Connection>(info.This());
+		const auto ret = connection->connectionBridge->read_arrow(query_id, number_rows, with_schema, cb);
+		info.GetReturnValue().Set(ret);
+	}
+
+	void Connection::query_batch(NanCb info)
+	{
+		const auto query_id = info[0].As<Number>();
+		const auto entries = info[1].As<Array>();
+		const auto cb = info[2].As<Object>();
+		const auto* const connection = Unwrap<Connection>(info.This());
+		const auto ret = connection->connectionBridge->query_batch(query_id, entries, cb);
+		info.GetReturnValue().Set(ret);
+	}
+
+	// take over a connection the native pool has already opened, in place of open().
+	void Connection::adopt(NanCb info)
+	{
+		const auto pool_object = info[0].As<Object>();
+		const auto slot = MutateJS::getint32(info[1].As<Number>());
+		const auto* const pool = Unwrap<ConnectionPool>(pool_object);
+		const auto* const connection = Unwrap<Connection>(info.This());
+		const auto odbc = pool->get(slot);
+		if (odbc)
+		{
+			connection->connectionBridge->adopt(odbc);
+		}
+		info.GetReturnValue().Set(Nan::New(odbc != nullptr));
+	}
+
+	// synchronous - a snapshot of the counters and histograms, nothing is queued.
+	void Connection::get_stats(NanCb info)
+	{
+		const auto* const connection = Unwrap<Connection>(info.This());
+		info.GetReturnValue().Set(connection->connectionBridge->get_stats());
+	}
+
+	// synchronous - only raises a flag on the statement, so it takes effect before the
+	// batch already being prefetched completes rather than queueing behind it.
+	void Connection::pause_prefetch(NanCb info)
+	{
+		const auto query_id = info[0].As<Number>();
+		const auto* const connection = Unwrap<Connection>(info.This());
+		connection->connectionBridge->pause_prefetch(query_id);
+		info.GetReturnValue().Set(Nan::Null());
+	}
+
 	void Connection::read_next_result(NanCb info)
 	{
 		const auto query_id = info[0].As<Number>();
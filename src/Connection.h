@@ -42,19 +42,31 @@ namespace mssql
 		static NAN_METHOD(commit);
 		static NAN_METHOD(rollback);
 		static NAN_METHOD(open);
+		static NAN_METHOD(adopt);
 		static NAN_METHOD(query);
 		static NAN_METHOD(prepare);
 		static NAN_METHOD(bind_query);
+		static NAN_METHOD(send_tvp_rows);
 		static NAN_METHOD(call_procedure);
 		static NAN_METHOD(unbind);
 		static NAN_METHOD(free_statement);
 		static NAN_METHOD(read_row);
 		static NAN_METHOD(cancel_statement);
 		static NAN_METHOD(read_column);
+		static NAN_METHOD(read_columnar);
+		static NAN_METHOD(read_arrow);
+		static NAN_METHOD(query_batch);
+		static NAN_METHOD(pause_prefetch);
 		static NAN_METHOD(read_next_result);
 		static NAN_METHOD(polling_mode);
+		static NAN_METHOD(get_stats);
 		
-		static Nan::Persistent<v8::Function> constructor;
+		// one per addon instance, so each worker thread isolate has its own constructor.
+		struct AddonData
+		{
+			Nan::Persistent<v8::Function> constructor;
+		};
+		static void cleanup(void* arg);
 		static void api(Local<FunctionTemplate>& tpl);
 		unique_ptr<OdbcConnectionBridge> connectionBridge;
 		Persistent<Object> This;
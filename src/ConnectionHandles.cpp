@@ -17,6 +17,7 @@ namespace mssql {
 	void ConnectionHandles::clear()
 	{
 		// cerr << "OdbcStatementCache - size = " << statements.size() << endl;
+		lock_guard<mutex> lock(_handles_mutex);
 		vector<long> ids;
 		// fprintf(stderr, "destruct OdbcStatementCache\n");
 
@@ -56,6 +57,7 @@ namespace mssql {
 			//fprintf(stderr, "dont fetch id %ld\n", statementId);
 			return nullptr;
 		}
+		lock_guard<mutex> lock(_handles_mutex);
 		auto statement = find(statement_id);
 		if (statement) return statement;
 		const auto handle = make_shared<OdbcStatementHandle>(statement_id);
@@ -66,6 +68,7 @@ namespace mssql {
 
     void ConnectionHandles::checkin(long statementId) { 
 		// std::cerr << " checkin " << statementId << " p = " << this <<  endl;
+		lock_guard<mutex> lock(_handles_mutex);
 		const auto handle = find(statementId);
         if (handle == nullptr) return;
 		 _statementHandles.erase(statementId);
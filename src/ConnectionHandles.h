@@ -22,6 +22,7 @@
 #include "stdafx.h"
 #include <vector>
 #include <map>
+#include <mutex>
 
 namespace mssql
 {
@@ -45,6 +46,8 @@ namespace mssql
         shared_ptr<OdbcStatementHandle> store(shared_ptr<OdbcStatementHandle> handle);
         shared_ptr<OdbcStatementHandle> find(const long statement_id); 
         map<long, shared_ptr<OdbcStatementHandle>> _statementHandles;
+        // with pipelining a statement is freed on a worker while others are allocated.
+        mutex _handles_mutex;
         shared_ptr<OdbcConnectionHandle> _connectionHandle;
     };
 }
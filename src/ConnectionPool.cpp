@@ -0,0 +1,354 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: ConnectionPool.cpp
+// Contents: native side of the JS Pool - parallel warm up and the idle connection queue
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include <ConnectionPool.h>
+#include <OdbcConnection.h>
+#include <MutateJS.h>
+#include <thread>
+
+namespace mssql
+{
+	using namespace v8;
+
+	// one call to open(). each slot connects on its own thread and posts its result to
+	// the ready queue; the loop thread drains it from the async callback and calls back
+	// once per slot, so the pool can put a connection to work before the rest arrive.
+	class OpenBatch
+	{
+	public:
+		struct result
+		{
+			int32_t slot = -1;
+			shared_ptr<OdbcConnection> connection;
+			bool ok = false;
+		};
+
+		OpenBatch(ConnectionPool* pool, Local<Object> pool_object, Local<Function> callback, size_t count)
+			: _pool(pool),
+			_pool_object(pool_object),
+			_callback(callback),
+			_resource("msnodesqlv8:ConnectionPool.open"),
+			_ready(count),
+			_expected(count)
+		{
+			_async.data = this;
+			uv_async_init(Nan::GetCurrentEventLoop(), &_async, on_ready);
+		}
+
+		~OpenBatch()
+		{
+			_pool_object.Reset();
+		}
+
+		void start(const vector<int32_t>& slots, const shared_ptr<vector<uint16_t>>& connection_string, const int timeout)
+		{
+			for (const auto slot : slots)
+			{
+				_threads.emplace_back([this, slot, connection_string, timeout]()
+				{
+					result r;
+					r.slot = slot;
+					r.connection = make_shared<OdbcConnection>();
+					r.ok = r.connection->try_open(connection_string, timeout);
+					_ready.push(std::move(r));
+					uv_async_send(&_async);
+				});
+			}
+		}
+
+	private:
+		static void on_ready(uv_async_t* handle)
+		{
+			static_cast<OpenBatch*>(handle->data)->drain();
+		}
+
+		static void on_closed(uv_handle_t* handle)
+		{
+			delete static_cast<OpenBatch*>(handle->data);
+		}
+
+		void drain()
+		{
+			Nan::HandleScope scope;
+			result r;
+			while (_ready.pop(r))
+			{
+				++_delivered;
+				Local<Value> err = Nan::Null();
+				if (r.ok)
+				{
+					_pool->retire(r.slot);
+					_pool->_slots[r.slot] = r.connection;
+				}
+				else
+				{
+					err = errors(r.connection);
+				}
+				Local<Value> argv[2] = { err, Nan::New(r.slot) };
+				_callback.Call(2, argv, &_resource);
+			}
+			if (_delivered < _expected) return;
+			// every thread has pushed, at most it is returning from uv_async_send.
+			for (auto& t : _threads)
+			{
+				t.join();
+			}
+			uv_close(reinterpret_cast<uv_handle_t*>(&_async), on_closed);
+		}
+
+		static Local<Value> errors(const shared_ptr<OdbcConnection>& connection)
+		{
+			const nodeTypeFactory fact;
+			const auto failures = connection->errors();
+			const auto count = failures ? static_cast<int>(failures->size()) : 0;
+			const auto arr = fact.new_array(count);
+			for (auto i = 0; i < count; ++i)
+			{
+				const auto& failure = (*failures)[i];
+				const auto err = fact.error(failure->Message());
+				Nan::Set(err, Nan::New("sqlstate").ToLocalChecked(), Nan::New(failure->SqlState()).ToLocalChecked());
+				Nan::Set(err, Nan::New("code").ToLocalChecked(), Nan::New(static_cast<int>(failure->Code())));
+				Nan::Set(arr, i, err);
+			}
+			return arr;
+		}
+
+		ConnectionPool* _pool;
+		// holds the pool object so it cannot be collected while a batch is in flight.
+		Nan::Persistent<Object> _pool_object;
+		Nan::Callback _callback;
+		Nan::AsyncResource _resource;
+		MpmcQueue<result> _ready;
+		vector<thread> _threads;
+		uv_async_t _async;
+		size_t _expected;
+		size_t _delivered = 0;
+	};
+
+	// liveness for a batch of idle slots in a single libuv task. the slots stay out of
+	// the idle queue until the callback, so nothing else touches their handles meanwhile.
+	class ProbeWorker : public Nan::AsyncWorker
+	{
+	public:
+		ProbeWorker(Local<Function> callback, vector<shared_ptr<OdbcConnection>> connections, shared_ptr<vector<uint16_t>> probe_sql)
+			: Nan::AsyncWorker(new Nan::Callback(callback), "msnodesqlv8:ConnectionPool.probe"),
+			_connections(std::move(connections)),
+			_probe_sql(std::move(probe_sql)),
+			_alive(_connections.size(), false)
+		{
+		}
+
+		void Execute() override
+		{
+			for (size_t i = 0; i < _connections.size(); ++i)
+			{
+				const auto& connection = _connections[i];
+				_alive[i] = connection && connection->is_alive(_probe_sql);
+			}
+		}
+
+		void HandleOKCallback() override
+		{
+			Nan::HandleScope scope;
+			const nodeTypeFactory fact;
+			const auto res = fact.new_array(static_cast<int>(_alive.size()));
+			for (size_t i = 0; i < _alive.size(); ++i)
+			{
+				Nan::Set(res, static_cast<uint32_t>(i), Nan::New<Boolean>(_alive[i]));
+			}
+			Local<Value> argv[2] = { Nan::Null(), res };
+			callback->Call(2, argv, async_resource);
+		}
+
+	private:
+		vector<shared_ptr<OdbcConnection>> _connections;
+		shared_ptr<vector<uint16_t>> _probe_sql;
+		vector<bool> _alive;
+	};
+
+	ConnectionPool::ConnectionPool(const size_t capacity)
+		: _capacity(capacity),
+		_slots(capacity)
+	{
+	}
+
+	ConnectionPool::~ConnectionPool()
+	{
+	}
+
+	shared_ptr<OdbcConnection> ConnectionPool::get(const int32_t slot) const
+	{
+		if (slot < 0 || static_cast<size_t>(slot) >= _capacity) return nullptr;
+		return _slots[slot];
+	}
+
+	// keep the history of a connection that is leaving its slot.
+	void ConnectionPool::retire(const int32_t slot)
+	{
+		const auto& existing = _slots[slot];
+		if (existing)
+		{
+			existing->stats()->merge_into(_retired);
+		}
+		_slots[slot] = nullptr;
+	}
+
+	void ConnectionPool::Init(Local<Object> exports)
+	{
+		Nan::HandleScope scope;
+		const auto name = Nan::New("ConnectionPool").ToLocalChecked();
+		auto tpl = Nan::New<FunctionTemplate>(New);
+		tpl->SetClassName(name);
+		tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+		Nan::SetPrototypeMethod(tpl, "open", open);
+		Nan::SetPrototypeMethod(tpl, "checkout", checkout);
+		Nan::SetPrototypeMethod(tpl, "checkin", checkin);
+		Nan::SetPrototypeMethod(tpl, "release", release);
+		Nan::SetPrototypeMethod(tpl, "idle", idle);
+		Nan::SetPrototypeMethod(tpl, "probe", probe);
+		Nan::SetPrototypeMethod(tpl, "getStats", get_stats);
+
+		Nan::Set(exports, name, Nan::GetFunction(tpl).ToLocalChecked());
+	}
+
+	void ConnectionPool::New(NanCb info)
+	{
+		if (!info.IsConstructCall())
+		{
+			const nodeTypeFactory fact;
+			fact.throwError("ConnectionPool must be constructed with new");
+			return;
+		}
+		const auto capacity = MutateJS::getint32(info[0].As<Number>());
+		auto* obj = new ConnectionPool(static_cast<size_t>(capacity > 0 ? capacity : 1));
+		obj->Wrap(info.This());
+		info.GetReturnValue().Set(info.This());
+	}
+
+	// open(connection_object, slots, cb) - cb(err, slot) is called once for each slot.
+	void ConnectionPool::open(NanCb info)
+	{
+		const auto connection_object = info[0].As<Object>();
+		const auto slots_array = info[1].As<Array>();
+		const auto callback = info[2].As<Function>();
+		auto* const pool = Unwrap<ConnectionPool>(info.This());
+
+		vector<int32_t> slots;
+		for (uint32_t i = 0; i < slots_array->Length(); ++i)
+		{
+			const auto slot = MutateJS::getint32(Nan::Get(slots_array, i).ToLocalChecked().As<Number>());
+			if (slot >= 0 && static_cast<size_t>(slot) < pool->_capacity)
+			{
+				slots.push_back(slot);
+			}
+		}
+		if (slots.empty())
+		{
+			info.GetReturnValue().Set(Nan::New(0));
+			return;
+		}
+		const auto cs = MutateJS::get_property_as_value(connection_object, "conn_str");
+		const auto connection_string = js2u16(Nan::To<String>(cs).ToLocalChecked());
+		const auto to = MutateJS::get_property_as_value(connection_object, "conn_timeout");
+		const auto timeout = to->IsNumber() ? MutateJS::getint32(to.As<Number>()) : 0;
+
+		auto* const batch = new OpenBatch(pool, info.This(), callback, slots.size());
+		batch->start(slots, connection_string, timeout);
+		info.GetReturnValue().Set(Nan::New(static_cast<int32_t>(slots.size())));
+	}
+
+	// returns an idle slot or -1 when none is free; never waits.
+	void ConnectionPool::checkout(NanCb info)
+	{
+		auto* const pool = Unwrap<ConnectionPool>(info.This());
+		auto slot = -1;
+		if (!pool->_idle.empty())
+		{
+			slot = pool->_idle.front();
+			pool->_idle.pop_front();
+		}
+		info.GetReturnValue().Set(Nan::New(slot));
+	}
+
+	void ConnectionPool::checkin(NanCb info)
+	{
+		auto* const pool = Unwrap<ConnectionPool>(info.This());
+		const auto slot = MutateJS::getint32(info[0].As<Number>());
+		const auto ok = pool->get(slot) != nullptr && pool->_idle.size() < pool->_capacity;
+		if (ok)
+		{
+			pool->_idle.push_back(slot);
+		}
+		info.GetReturnValue().Set(Nan::New(ok));
+	}
+
+	// the pool no longer owns the connection in this slot, e.g. once it is parked and closed.
+	void ConnectionPool::release(NanCb info)
+	{
+		auto* const pool = Unwrap<ConnectionPool>(info.This());
+		const auto slot = MutateJS::getint32(info[0].As<Number>());
+		if (slot >= 0 && static_cast<size_t>(slot) < pool->_capacity)
+		{
+			pool->retire(slot);
+		}
+	}
+
+	// probe(slots, probe_sql, cb) - cb(err, alive) with one flag per slot in order. probe_sql
+	// null checks SQL_ATTR_CONNECTION_DEAD alone, which never reaches the server.
+	void ConnectionPool::probe(NanCb info)
+	{
+		const auto slots_array = info[0].As<Array>();
+		const auto sql = info[1];
+		const auto callback = info[2].As<Function>();
+		const auto* const pool = Unwrap<ConnectionPool>(info.This());
+
+		vector<shared_ptr<OdbcConnection>> connections;
+		for (uint32_t i = 0; i < slots_array->Length(); ++i)
+		{
+			const auto slot = MutateJS::getint32(Nan::Get(slots_array, i).ToLocalChecked().As<Number>());
+			connections.push_back(pool->get(slot));
+		}
+		shared_ptr<vector<uint16_t>> probe_sql;
+		if (sql->IsString())
+		{
+			probe_sql = js2u16(sql.As<String>());
+		}
+		Nan::AsyncQueueWorker(new ProbeWorker(callback, std::move(connections), probe_sql));
+	}
+
+	void ConnectionPool::idle(NanCb info)
+	{
+		const auto* const pool = Unwrap<ConnectionPool>(info.This());
+		info.GetReturnValue().Set(Nan::New(static_cast<uint32_t>(pool->_idle.size())));
+	}
+
+	void ConnectionPool::get_stats(NanCb info)
+	{
+		auto* const pool = Unwrap<ConnectionPool>(info.This());
+		DriverStats total;
+		pool->_retired.merge_into(total);
+		for (const auto& connection : pool->_slots)
+		{
+			if (connection) connection->stats()->merge_into(total);
+		}
+		info.GetReturnValue().Set(total.to_value());
+	}
+}
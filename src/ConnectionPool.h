@@ -0,0 +1,71 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: ConnectionPool.h
+// Contents: native side of the JS Pool - parallel warm up and the idle connection queue
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <nan.h>
+#include <deque>
+#include <vector>
+#include <MpmcQueue.h>
+#include <Stats.h>
+
+namespace mssql
+{
+	using namespace std;
+	using namespace v8;
+
+	class OdbcConnection;
+
+	// a fixed set of slots, one per connection up to the pool ceiling. open() connects
+	// any number of slots at once, each on its own thread rather than the libuv pool so
+	// warm up neither waits on nor starves query work, and reports each slot as soon as
+	// it is ready. lib/connection.js adopts the opened ODBC connection into a normal
+	// Connection object; checkout/checkin then move slot numbers through the idle queue.
+	// only the loop thread touches that queue, so it is a plain deque rather than the
+	// MpmcQueue the open threads report through, and waiters are woken from lib/pool.js,
+	// where each checkin is followed by a dispatch of the oldest queued work.
+	// probe() replaces SQL heartbeats with one worker task checking every idle slot.
+	// getStats() sums the live slots with everything the pool has closed or replaced.
+	class ConnectionPool : public Nan::ObjectWrap
+	{
+	public:
+		static NAN_MODULE_INIT(Init);
+		shared_ptr<OdbcConnection> get(int32_t slot) const;
+		virtual ~ConnectionPool();
+
+	private:
+		typedef Nan::NAN_METHOD_ARGS_TYPE NanCb;
+		explicit ConnectionPool(size_t capacity);
+		static NAN_METHOD(New);
+		static NAN_METHOD(open);
+		static NAN_METHOD(checkout);
+		static NAN_METHOD(checkin);
+		static NAN_METHOD(release);
+		static NAN_METHOD(idle);
+		static NAN_METHOD(probe);
+		static NAN_METHOD(get_stats);
+		void retire(int32_t slot);
+
+		friend class OpenBatch;
+		size_t _capacity;
+		vector<shared_ptr<OdbcConnection>> _slots;
+		deque<int32_t> _idle;
+		DriverStats _retired;
+	};
+}
@@ -36,6 +36,7 @@ namespace mssql
 		EndTranOperation(const shared_ptr<OdbcConnection> &connection, SQLSMALLINT completion_type, Local<Object> callback);
 		bool TryInvokeOdbc() override;
 		Local<Value> CreateCompletionArg() override;
+		OperationKind kind() const override { return OperationKind::EndTran; }
 	};
 }
 
@@ -24,6 +24,10 @@ namespace mssql
 		   return AsString<int64_t>(value);
 	   }
 
+	   Kind kind() const override { return Kind::Number; }
+	   double as_double() const override { return static_cast<double>(value); }
+	   int64_t as_int64() const override { return value; }
+
 	   inline Local<Value> ToNative() override
 	   {
 		 	return Nan::New(static_cast<int32_t>(value));
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <v8.h>
+#include "Column.h"
+#include "Utility.h"
+#include "BoundDatumHelper.h"
+
+namespace mssql
+{
+    using namespace std;
+
+    // FOR JSON output reassembled from its row fragments on the ODBC thread. when parse is
+    // requested the document goes through JSON::Parse in one call; V8 objects can only be
+    // built on the isolate thread, so this is as far off the event loop as the parse can go.
+    class JsonColumn : public Column
+    {
+    public:
+	   virtual ~JsonColumn()
+	   {
+	   }
+
+	   JsonColumn(int id, shared_ptr<DatumStorage::uint16_t_vec_t> s, bool parse) 
+	   : 
+	   Column(id), 
+	   storage(s),
+	   parse(parse)
+	   {
+	   }
+
+	   inline Local<Value> ToString() override
+	   {
+		  	return ucs2_to_value(storage->data(), storage->size());
+	   }
+
+	   Kind kind() const override { return Kind::Utf16; }
+	   const uint8_t* bytes(size_t& n) const override
+	   {
+		   n = storage->size() * sizeof(uint16_t);
+		   return reinterpret_cast<const uint8_t*>(storage->data());
+	   }
+
+	   inline Local<Value> ToNative() override
+	   {
+		   	const auto s = ToString();
+		   	if (!parse)
+		   	{
+				return s;
+		   	}
+		   	Nan::TryCatch try_catch;
+		   	auto parsed = JSON::Parse(Nan::GetCurrentContext(), s.As<String>());
+		   	if (parsed.IsEmpty())
+		   	{
+				// hand back the text so the caller sees what the server sent.
+				return s;
+		   	}
+		   	return parsed.ToLocalChecked();
+	   }
+
+    private:
+		shared_ptr<DatumStorage::uint16_t_vec_t> storage;
+		bool parse;
+    };
+}
@@ -0,0 +1,139 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: MpmcQueue.h
+// Contents: bounded lock free multi producer multi consumer queue
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+namespace mssql
+{
+	using namespace std;
+
+	// the classic bounded ring where each cell carries a sequence number (Vyukov). a
+	// producer claims a cell with one CAS on the enqueue position and publishes it by
+	// advancing that cell's sequence, so push and pop never take a lock and a stalled
+	// thread cannot block the others beyond the cell it holds.
+	template<typename T> class MpmcQueue
+	{
+	public:
+		explicit MpmcQueue(const size_t capacity)
+			: _mask(round_up(capacity) - 1),
+			_cells(new cell[_mask + 1]),
+			_enqueue_pos(0),
+			_dequeue_pos(0)
+		{
+			for (size_t i = 0; i <= _mask; ++i)
+			{
+				_cells[i].sequence.store(i, memory_order_relaxed);
+			}
+		}
+
+		MpmcQueue(const MpmcQueue&) = delete;
+		MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+		bool push(T value)
+		{
+			cell* c;
+			auto pos = _enqueue_pos.load(memory_order_relaxed);
+			for (;;)
+			{
+				c = &_cells[pos & _mask];
+				const auto seq = c->sequence.load(memory_order_acquire);
+				const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+				if (diff == 0)
+				{
+					if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) break;
+				}
+				else if (diff < 0)
+				{
+					return false; // full
+				}
+				else
+				{
+					pos = _enqueue_pos.load(memory_order_relaxed);
+				}
+			}
+			c->data = std::move(value);
+			c->sequence.store(pos + 1, memory_order_release);
+			return true;
+		}
+
+		bool pop(T& value)
+		{
+			cell* c;
+			auto pos = _dequeue_pos.load(memory_order_relaxed);
+			for (;;)
+			{
+				c = &_cells[pos & _mask];
+				const auto seq = c->sequence.load(memory_order_acquire);
+				const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+				if (diff == 0)
+				{
+					if (_dequeue_pos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) break;
+				}
+				else if (diff < 0)
+				{
+					return false; // empty
+				}
+				else
+				{
+					pos = _dequeue_pos.load(memory_order_relaxed);
+				}
+			}
+			value = std::move(c->data);
+			c->sequence.store(pos + _mask + 1, memory_order_release);
+			return true;
+		}
+
+		// only exact when no other thread is pushing or popping.
+		size_t size() const
+		{
+			const auto e = _enqueue_pos.load(memory_order_acquire);
+			const auto d = _dequeue_pos.load(memory_order_acquire);
+			return e > d ? e - d : 0;
+		}
+
+		size_t capacity() const
+		{
+			return _mask + 1;
+		}
+
+	private:
+		static size_t round_up(size_t v)
+		{
+			size_t p = 2;
+			while (p < v) p <<= 1;
+			return p;
+		}
+
+		struct cell
+		{
+			atomic<size_t> sequence;
+			T data;
+		};
+
+		const size_t _mask;
+		unique_ptr<cell[]> _cells;
+		// kept on separate cache lines so producers and consumers do not false share.
+		alignas(64) atomic<size_t> _enqueue_pos;
+		alignas(64) atomic<size_t> _dequeue_pos;
+	};
+}
@@ -9,4 +9,5 @@
 #include <BinaryColumn.h>
 #include <StringColumn.h>
 #include <CharColumn.h>
+#include <JsonColumn.h>
 #include <BigIntColumn.h>
@@ -26,6 +26,9 @@ namespace mssql
 		   return AsString<double>(value);
 	   }
 
+	   Kind kind() const override { return Kind::Number; }
+	   double as_double() const override { return value; }
+
 	   inline Local<Value> ToNative() override
 	   {
 		  return Nan::New(value);
@@ -28,9 +28,32 @@
 namespace mssql
 {
 	OdbcEnvironmentHandle OdbcConnection::environment;
+	std::mutex OdbcConnection::environment_mutex;
+	int OdbcConnection::environment_refs = 0;
 
-#ifdef WINDOWS_BUILD
 	bool OdbcConnection::InitializeEnvironment()
+	{
+		lock_guard<mutex> lock(environment_mutex);
+		if (environment_refs == 0 && !allocate_environment())
+		{
+			environment.free();
+			return false;
+		}
+		++environment_refs;
+		return true;
+	}
+
+	void OdbcConnection::ReleaseEnvironment()
+	{
+		lock_guard<mutex> lock(environment_mutex);
+		if (environment_refs > 0 && --environment_refs == 0)
+		{
+			environment.free();
+		}
+	}
+
+#ifdef WINDOWS_BUILD
+	bool OdbcConnection::allocate_environment()
 	{
 		// fprintf(stderr, ">> InitializeEnvironment\n\n");
 
@@ -52,7 +75,7 @@ namespace mssql
 	}
 #endif
 #ifdef LINUX_BUILD
-	bool OdbcConnection::InitializeEnvironment()
+	bool OdbcConnection::allocate_environment()
 	{
 		if (!environment.alloc()) { return false; }
 		auto ret = SQLSetEnvAttr(environment, SQL_ATTR_CONNECTION_POOLING, reinterpret_cast<SQLPOINTER>(SQL_CP_ONE_PER_HENV), 0);
@@ -71,6 +94,7 @@ namespace mssql
 
 	OdbcConnection::OdbcConnection() :
 		_statements(nullptr),
+		_stats(make_shared<DriverStats>()),
 		connectionState(Closed)
 	{
 		_errors = make_shared<vector<shared_ptr<OdbcError>>>();
@@ -103,6 +127,27 @@ namespace mssql
 		return true;
 	}
 
+	bool OdbcConnection::is_alive(const shared_ptr<vector<uint16_t>>& probe_sql)
+	{
+		ScopedCriticalSectionLock crit_sec_lock(closeCriticalSection);
+		if (connectionState != Open) return false;
+		const auto ch = _connectionHandles->connectionHandle();
+		if (!ch) return false;
+		const auto& connection = *ch;
+		SQLUINTEGER dead = SQL_CD_TRUE;
+		auto ret = SQLGetConnectAttr(connection, SQL_ATTR_CONNECTION_DEAD, &dead, SQL_IS_UINTEGER, nullptr);
+		if (!SQL_SUCCEEDED(ret) || dead == SQL_CD_TRUE) return false;
+		if (!probe_sql) return true;
+
+		OdbcStatementHandle probe(-1);
+		if (!probe.alloc(connection)) return false;
+		ret = SQLExecDirect(probe, reinterpret_cast<SQLWCHAR*>(probe_sql->data()), static_cast<SQLINTEGER>(probe_sql->size()));
+		const auto alive = SQL_SUCCEEDED(ret);
+		SQLFreeStmt(probe, SQL_CLOSE);
+		probe.free();
+		return alive;
+	}
+
 	bool OdbcConnection::ReturnOdbcError()
 	{
 		_errors->clear();
@@ -150,12 +195,11 @@ namespace mssql
 		{
 			_errors->clear();
 			environment.read_errors(_errors);
-			//fprintf(stderr, "RETURN_ODBC_ERROR - free environment handle\n\n");
-			environment.free();
+			// environment is shared with other threads, it is freed by ReleaseEnvironment
 			return false;
 		}
 		const auto &handle = *connection;
-		_statements = make_shared<OdbcStatementCache>(_connectionHandles);
+		_statements = make_shared<OdbcStatementCache>(_connectionHandles, _stats);
 		auto ret = open_timeout(timeout);
 		if (!CheckOdbcError(ret)) return false;
 		ret = SQLSetConnectAttr(handle, SQL_COPT_SS_BCP, reinterpret_cast<SQLPOINTER>(SQL_BCP_ON), SQL_IS_INTEGER);  
@@ -21,6 +21,7 @@
 
 #include "stdafx.h"
 #include <CriticalSection.h>
+#include <Stats.h>
 #include <map>
 
 namespace mssql
@@ -38,23 +39,35 @@ namespace mssql
 	public:
 		OdbcConnection();
 		~OdbcConnection();
+		// each addon instance (main thread or worker) takes a reference on the one
+		// process wide environment handle; the last to unload frees it.
 		static bool InitializeEnvironment();
+		static void ReleaseEnvironment();
 		bool try_begin_tran();
 		bool send(OdbcOperation* op) const;
 		bool try_end_tran(SQLSMALLINT completion_type);
 		bool try_open(shared_ptr<vector<uint16_t>> connection_string, int timeout);
 		shared_ptr<vector<shared_ptr<OdbcError>>> errors(void) const { return _errors; }
 		bool TryClose();
+		// asks the driver whether the link has dropped - no round trip. only when
+		// probe_sql is given is it also sent to the server on a scratch statement.
+		bool is_alive(const shared_ptr<vector<uint16_t>>& probe_sql);
 		shared_ptr<OdbcStatementCache> getStatamentCache() { return _statements; }
+		// shared with each statement so the fetch loops count without a back pointer.
+		shared_ptr<DriverStats> stats() const { return _stats; }
 		
 	private:
 		shared_ptr<OdbcStatementCache> _statements;
 		bool ReturnOdbcError();
 		bool CheckOdbcError(SQLRETURN ret);
 		
+		static bool allocate_environment();
 		static OdbcEnvironmentHandle environment;
+		static std::mutex environment_mutex;
+		static int environment_refs;
 		SQLRETURN open_timeout(int timeout);		
 		shared_ptr<ConnectionHandles> _connectionHandles;
+		shared_ptr<DriverStats> _stats;
 		std::mutex closeCriticalSection;
 
 		// any error that occurs when a Try* function returns false is stored here
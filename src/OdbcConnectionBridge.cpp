@@ -20,6 +20,7 @@
 #include <OdbcConnectionBridge.h>
 #include <QueryOperation.h>
 #include <QueryOperationParams.h>
+#include <QueryBatchOperation.h>
 #include <EndTranOperation.h>
 #include <CollectOperation.h>
 #include <BeginTranOperation.h>
@@ -27,14 +28,18 @@
 #include <OpenOperation.h>
 #include <ReadNextResultOperation.h>
 #include <ReadColumnOperation.h>
+#include <ReadColumnarOperation.h>
+#include <ReadArrowOperation.h>
 #include <CloseOperation.h>
 #include <CancelOperation.h>
 #include <PrepareOperation.h>
 #include <FreeStatementOperation.h>
 #include <QueryPreparedOperation.h>
+#include <TvpRowsOperation.h>
 #include <OperationManager.h>
 #include <UnbindOperation.h>
 #include <OdbcStatementCache.h>
+#include <OdbcStatement.h>
 #include <PollingModeOperation.h>
 #include <MutateJS.h>
 #include <iostream>
@@ -49,6 +54,16 @@ namespace mssql
 		connection = make_shared<OdbcConnection>();
 	}
 
+	void OdbcConnectionBridge::adopt(const shared_ptr<OdbcConnection>& opened)
+	{
+		connection = opened;
+	}
+
+	Local<Value> OdbcConnectionBridge::get_stats() const
+	{
+		return connection->stats()->to_value();
+	}
+
 	OdbcConnectionBridge::~OdbcConnectionBridge()
 	{
 		// fprintf(stderr, "destruct OdbcConnectionBridge\n");
@@ -146,6 +161,18 @@ namespace mssql
 		return Nan::Null();
 	}
 
+	Local<Value> OdbcConnectionBridge::send_tvp_rows(const Local<Number> query_id, Local<Array> params, const Local<Object> callback) const
+	{
+		const auto id = getint32(query_id);
+		auto *operation = new TvpRowsOperation(connection, id, callback);
+		if (operation->bind_parameters(params)) {
+			connection->send(operation);
+		} else {
+			delete operation;
+		}
+		return Nan::Null();
+	}
+
 	Local<Value> OdbcConnectionBridge::prepare(Local<Number> query_id, Local<Object> query_object, const Local<Object> callback) const
 	{
 		const auto q = make_shared<QueryOperationParams>(query_id, query_object);
@@ -217,6 +244,39 @@ namespace mssql
 		return Nan::Null();
 	}
 
+	Local<Value> OdbcConnectionBridge::read_columnar(const Local<Number> query_id, const Local<Number> number_rows, const Local<Boolean> shared, Local<Object> callback) const
+	{
+		const auto id = getint32(query_id);
+		auto* const op = new ReadColumnarOperation(connection, id, getint32(number_rows), Nan::To<bool>(shared).FromMaybe(false), callback);
+		connection->send(op);
+		return Nan::Null();
+	}
+
+	Local<Value> OdbcConnectionBridge::read_arrow(const Local<Number> query_id, const Local<Number> number_rows, const Local<Boolean> with_schema, Local<Object> callback) const
+	{
+		const auto id = getint32(query_id);
+		auto* const op = new ReadArrowOperation(connection, id, getint32(number_rows), Nan::To<bool>(with_schema).FromMaybe(false), callback);
+		connection->send(op);
+		return Nan::Null();
+	}
+
+	Local<Value> OdbcConnectionBridge::query_batch(const Local<Number> query_id, const Local<Array> entries, const Local<Object> callback) const
+	{
+		auto* const op = new QueryBatchOperation(connection, getint32(query_id), callback);
+		op->add_entries(query_id, entries);
+		connection->send(op);
+		return Nan::Null();
+	}
+
+	void OdbcConnectionBridge::pause_prefetch(const Local<Number> query_id) const
+	{
+		const auto statement = connection->getStatamentCache()->find(getint32(query_id));
+		if (statement)
+		{
+			statement->pause_prefetch();
+		}
+	}
+
 	Local<Value> OdbcConnectionBridge::open(const Local<Object> connection_object, const Local<Object> callback, const Local<Object> backpointer) const
 	{
 		nodeTypeFactory fact;
@@ -40,7 +40,9 @@ namespace mssql
 		Local<Value> commit(Local<Object> callback) const;
 		Local<Value> rollback(Local<Object> callback) const;
 		Local<Value> query(Local<Number> query_id, Local<Object> query_object, Local<Array> params, Local<Object> callback) const;
+		Local<Value> query_batch(Local<Number> query_id, Local<Array> entries, Local<Object> callback) const;
 		Local<Value> query_prepared(Local<Number> query_id, Local<Array> params, Local<Object> callback) const;
+		Local<Value> send_tvp_rows(Local<Number> query_id, Local<Array> params, Local<Object> callback) const;
 		Local<Value> prepare(Local<Number> query_id, Local<Object> query_object, Local<Object> callback) const;
 		Local<Value> call_procedure(Local<Number> query_id, Local<Object> query_object, Local<Array> params, Local<Object> callback) const;
 		Local<Value> unbind_parameters(Local<Number> query_id, Local<Object> callback) const;
@@ -49,8 +51,13 @@ namespace mssql
 		Local<Value> read_row(Local<Number> query_id, Local<Object> callback) const;
 		Local<Value> read_next_result(Local<Number> query_id, Local<Object> callback) const;
 		Local<Value> read_column(Local<Number> query_id, Local<Number> number_rows, Local<Object> callback) const;
+		Local<Value> read_columnar(Local<Number> query_id, Local<Number> number_rows, Local<Boolean> shared, Local<Object> callback) const;
+		Local<Value> read_arrow(Local<Number> query_id, Local<Number> number_rows, Local<Boolean> with_schema, Local<Object> callback) const;
 		Local<Value> open(Local<Object> connection_object, Local<Object> callback, Local<Object> backpointer) const;
 		Local<Value> free_statement(Local<Number> query_id, Local<Object> callback) const;
+		void adopt(const shared_ptr<OdbcConnection>& opened);
+		Local<Value> get_stats() const;
+		void pause_prefetch(Local<Number> query_id) const;
 
 	private:
 		shared_ptr<OdbcConnection> connection;
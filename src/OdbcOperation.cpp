@@ -34,7 +34,8 @@ namespace mssql
 		_cb(cb),
 		_can_lock(true),
 		_failed(false),
-		_failures(nullptr)	
+		_failures(nullptr),
+		_created(DriverStats::clock::now())
 	{
 		_statementId = static_cast<long>(query_id);
 		const nodeTypeFactory fact;
@@ -50,14 +51,19 @@ namespace mssql
 	}
 
 	void OdbcOperation::Execute () {
+		const auto started = DriverStats::clock::now();
 		if (_statement && _can_lock) {
 		 	const std::lock_guard<std::mutex> lock(_statement->_statement_mutex);
-		// std::cout << " invoke_background .... " << timer.get_counter() << endl;
 			_failed = !TryInvokeOdbc();
 		} else {
 			_failed = !TryInvokeOdbc();
 		}
-		// std::cout << " .... invoke_background " << timer.get_counter() << endl;
+		_executed = DriverStats::clock::now();
+		if (_connection) {
+			auto& stats = _connection->stats()->operation(kind());
+			stats.queue_wait.record(DriverStats::micros(_created, started));
+			stats.execute.record(DriverStats::micros(started, _executed));
+		}
 		if (_failed) {
 			getFailure();
 		}
@@ -67,9 +73,12 @@ namespace mssql
 		if (_callback.IsEmpty()) return;
 		Local<Value> args[4];
 		const auto argc = _failed ? error(args) : success(args);
-		// std::cout << " complete_foreground " << timer.get_counter() << endl;
-		//args[argc] = fact.new_number(timer.get_counter());
+		// time to marshal the result and run the js callback, including the wait for the
+		// isolate thread to pick up the completion.
 		Nan::Call(Nan::New(_callback), Nan::GetCurrentContext()->Global(), argc, args);
+		if (_connection) {
+			_connection->stats()->operation(kind()).complete.record(DriverStats::micros(_executed, DriverStats::clock::now()));
+		}
 	}
 
 	OdbcOperation::~OdbcOperation()
@@ -107,14 +116,14 @@ namespace mssql
 		}
 	}
 
-	int OdbcOperation::error(Local<Value> args[])
+	Local<Array> OdbcOperation::errors_to_value(const vector<shared_ptr<OdbcError>> &failures)
 	{
 		const nodeTypeFactory fact;
-		const unsigned int error_count = _failures ? static_cast<int>(_failures->size()) : 0;
+		const auto error_count = static_cast<unsigned int>(failures.size());
 		const auto errors = fact.new_array(error_count);
 		for (unsigned int i = 0; i < error_count; ++i)
 		{
-			const auto failure = (*_failures)[i];
+			const auto &failure = failures[i];
 			const auto err = fact.error(failure->Message());
 			Nan::Set(err, Nan::New("sqlstate").ToLocalChecked(), Nan::New(failure->SqlState()).ToLocalChecked());
 			Nan::Set(err, Nan::New("code").ToLocalChecked(), Nan::New(static_cast<int>(failure->Code())));
@@ -124,7 +133,13 @@ namespace mssql
 			Nan::Set(err, Nan::New("lineNumber").ToLocalChecked(), Nan::New(failure->LineNumber()));
 			Nan::Set(errors, i, err);
 		}
-		
+		return errors;
+	}
+
+	int OdbcOperation::error(Local<Value> args[])
+	{
+		const nodeTypeFactory fact;
+		const auto errors = _failures ? errors_to_value(*_failures) : fact.new_array(0);
 		auto more = false;
 		if (_statement)
 		{
@@ -20,6 +20,7 @@
 #pragma once
 
 #include <Operation.h>
+#include <Stats.h>
 #include <nan.h>
 
 namespace mssql
@@ -41,6 +42,7 @@ namespace mssql
 		virtual ~OdbcOperation();
 		virtual bool TryInvokeOdbc() = 0;
 		virtual Local<Value> CreateCompletionArg() = 0;
+		virtual OperationKind kind() const { return OperationKind::Other; }
 		void getFailure();
 
 	protected:
@@ -56,12 +58,16 @@ namespace mssql
 		bool _can_lock;
 		bool fetch_statement();
 		long _statementId;
+		// each error as a JS Error carrying the sqlstate, code and where the server raised it.
+		static Local<Array> errors_to_value(const vector<shared_ptr<OdbcError>>& failures);
 
 	private:
 
 		bool _failed;
 		shared_ptr<vector<shared_ptr<OdbcError>>> _failures;
-		//clock_capture timer;
+		// queue wait is measured from construction, the operation is queued straight after.
+		DriverStats::clock::time_point _created;
+		DriverStats::clock::time_point _executed;
 		int error(Local<Value> args[]);
 		int success(Local<Value> args[]);
 	};
@@ -27,6 +27,8 @@
 #include <NodeColumns.h>
 #include <OdbcHelper.h>
 #include <QueryOperationParams.h>
+#include <TvpStream.h>
+#include <Watchdog.h>
 #include <ConnectionHandles.h>
 #include <iostream>
 #include <algorithm>
@@ -54,6 +56,17 @@ namespace mssql
 		return size;
 	}
 
+	// a failure that leaves no further results to move on to.
+	static bool unreadable(const vector<shared_ptr<OdbcError>> &errors)
+	{
+		for (const auto &e : errors)
+		{
+			const string state(e->SqlState());
+			if (state.compare(0, 2, "08") == 0 || state == "HY010" || state == "HY008" || state == "HYT00") return true;
+		}
+		return false;
+	}
+
 	OdbcStatement::~OdbcStatement()
 	{
 		// cerr << "~OdbcStatement() " << _statementId << " " << endl;
@@ -63,14 +76,29 @@ namespace mssql
 		}
 	}
 
-	OdbcStatement::OdbcStatement(const long statement_id, shared_ptr<ConnectionHandles> c)
+	OdbcStatement::OdbcStatement(const long statement_id, shared_ptr<ConnectionHandles> c, shared_ptr<DriverStats> stats)
 		: _connectionHandles(c),
+		  _stats(stats),
 		  _endOfResults(true),
 		  _statementId(static_cast<long>(statement_id)),
 		  _prepared(false),
 		  _cancelRequested(false),
 		  _pollingEnabled(false),
 		  _numericStringEnabled(false),
+		  _decimalStringEnabled(false),
+		  _utf8Enabled(false),
+		  _maxInternedStrings(0),
+		  _jsonReassemble(false),
+		  _jsonParse(false),
+		  _statementState(OdbcStatementState::STATEMENT_CREATED),
+		  _timedOut(false),
+		  _deadlineToken(0),
+		  _prefetchDepth(0),
+		  _prefetchRunning(false),
+		  _prefetchEnded(false),
+		  _prefetchHeld(false),
+		  _prefetchGeneration(0),
+		  _prefetchPaused(false),
 		  _resultset(nullptr),
 		  _boundParamsSet(nullptr)
 	{
@@ -86,28 +114,73 @@ namespace mssql
 			return false;
 		// fprintf(stderr, "try_read_columns %d\n", number_rows);
 		bool res;
+		if (_prefetchDepth > 0)
+		{
+			lock_guard<mutex> lock(_prefetchMutex);
+			_prefetchHeld = true;
+		}
 		_resultset->start_results();
-		if (!_prepared)
+		if (take_prefetched(res))
+		{
+			++_stats->prefetch_hits;
+		}
+		else if (!_prepared)
 		{
 			res = fetch_read(number_rows);
+			if (_prefetchDepth > 0 && (!res || _resultset->_end_of_rows))
+			{
+				lock_guard<mutex> lock(_prefetchMutex);
+				_prefetchEnded = true;
+			}
 		}
 		else
 		{
 			res = prepared_read();
 		}
+		_stats->column_objects += _resultset->get_result_count() * (_resultset->_for_json ? 1 : _resultset->get_column_count());
 		return res;
 	}
 
+	SQLRETURN OdbcStatement::get_data(const SQLHSTMT statement, const SQLUSMALLINT column, const SQLSMALLINT c_type, const SQLPOINTER target, const SQLLEN buffer_length, SQLLEN* str_len_or_ind)
+	{
+		const auto ret = SQLGetData(statement, column, c_type, target, buffer_length, str_len_or_ind);
+		++_stats->get_data_calls;
+		if (SQL_SUCCEEDED(ret) && str_len_or_ind)
+		{
+			// a truncated chunk reports the full remaining length, only the buffer was written.
+			const auto ind = *str_len_or_ind;
+			if (ind == SQL_NO_TOTAL) _stats->bytes_fetched += buffer_length;
+			else if (ind > 0) _stats->bytes_fetched += buffer_length > 0 ? min(ind, buffer_length) : ind;
+		}
+		return ret;
+	}
+
 	bool OdbcStatement::fetch_read(const size_t number_rows)
 	{
 		// fprintf(stderr, "fetch_read %d\n", number_rows);
 		if (!_statement)
 			return false;
+		if (_resultset->_for_json)
+		{
+			return fetch_json();
+		}
 		const auto &statement = *_statement;
 		auto res = false;
+		// each result set, including one swapped in on cancel or no data, gets its own readers
+		// even when it has the same width as the last.
+		if (!_resultset->_readers_built)
+		{
+			build_readers();
+		}
+		const auto column_count = _readers.size();
 		for (size_t row_id = 0; row_id < number_rows; ++row_id)
 		{
+			if (_cancelRequested)
+			{
+				return cancelled();
+			}
 			const auto ret = SQLFetch(statement);
+			++_stats->fetch_calls;
 			if (ret == SQL_NO_DATA)
 			{
 				// fprintf(stderr, "fetch_read SQL_NO_DATA\n");
@@ -122,30 +195,118 @@ namespace mssql
 			_resultset->_end_of_rows = false;
 			res = true;
 
-			// fprintf(stderr, "column_count %d\n", _resultset->get_column_count());
-			const auto column_count = static_cast<int>(_resultset->get_column_count());
-			for (auto c = 0; c < column_count; ++c)
+			for (size_t c = 0; c < column_count; ++c)
 			{
-				const auto &definition = _resultset->get_meta_data(c);
-				res = dispatch(definition.dataType, row_id, c);
+				res = (this->*_readers[c])(row_id, c);
 				if (!res)
 				{
 					break;
 				}
 			}
+			if (!res)
+			{
+				// a failed (or cancelled) cell ends the batch, the next fetch would hide it.
+				return false;
+			}
 		}
 		return res;
 	}
 
+	// the server names the single FOR JSON column with this fixed guid.
+	bool OdbcStatement::is_for_json() const
+	{
+		static const string for_json_name = "JSON_F52E2B61-18A1-11d1-B105-00805F49916B";
+		if (_resultset->get_column_count() != 1)
+			return false;
+		const auto &name = _resultset->get_meta_data(0).name;
+		if (name.size() < for_json_name.size())
+			return false;
+		for (size_t i = 0; i < for_json_name.size(); ++i)
+		{
+			if (name[i] != static_cast<SQLWCHAR>(for_json_name[i]))
+				return false;
+		}
+		return true;
+	}
+
+	// FOR JSON output arrives as ~2k character rows; fetch every fragment here on the
+	// ODBC thread and return the document as one row rather than one row per fragment.
+	bool OdbcStatement::fetch_json()
+	{
+		const auto &statement = *_statement;
+		const auto json = make_shared<DatumStorage::uint16_t_vec_t>();
+		size_t fragments = 0;
+		while (true)
+		{
+			const auto ret = SQLFetch(statement);
+			++_stats->fetch_calls;
+			if (ret == SQL_NO_DATA)
+			{
+				break;
+			}
+			if (!check_odbc_error(ret))
+			{
+				return false;
+			}
+			if (!append_wchars(0, *json))
+			{
+				return false;
+			}
+			++fragments;
+		}
+		_resultset->_end_of_rows = true;
+		if (fragments > 0)
+		{
+			_resultset->add_column(0, make_shared<JsonColumn>(0, json, _jsonParse));
+		}
+		return true;
+	}
+
+	bool OdbcStatement::append_wchars(const size_t column, vector<uint16_t> &dest)
+	{
+		const auto &statement = *_statement;
+		constexpr SQLLEN chunk = 4 * 1024;
+		constexpr auto size = sizeof(uint16_t);
+		auto more = true;
+		while (more)
+		{
+			const auto start = dest.size();
+			dest.resize(start + chunk + 1); // increment for null terminator
+			SQLLEN value_len = 0;
+			const auto r = get_data(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_WCHAR, dest.data() + start, (chunk + 1) * size, &value_len);
+			if (r == SQL_NO_DATA || value_len == SQL_NULL_DATA)
+			{
+				dest.resize(start);
+				return true;
+			}
+			if (!check_odbc_error(r))
+				return false;
+			auto status = false;
+			more = check_more_read(r, status);
+			if (!status)
+			{
+				return false;
+			}
+			const auto read = more || value_len < 0 || value_len / static_cast<SQLLEN>(size) > chunk ? chunk : value_len / size;
+			dest.resize(start + read);
+		}
+		return true;
+	}
+
 	bool OdbcStatement::prepared_read()
 	{
 		if (!_statement)
 			return false;
 		// fprintf(stderr, "prepared_read");
+		if (_cancelRequested)
+		{
+			return cancelled();
+		}
 		const auto &statement = *_statement;
 		SQLSetStmtAttr(statement, SQL_ATTR_ROWS_FETCHED_PTR, &_resultset->_row_count, 0);
 
 		const auto ret = SQLFetchScroll(statement, SQL_FETCH_NEXT, 0);
+		++_stats->fetch_calls;
 		// cerr << " row_count " << row_count << endl;
 		if (ret == SQL_NO_DATA)
 		{
@@ -173,29 +334,63 @@ namespace mssql
 
 	Local<Value> OdbcStatement::get_column_values() const
 	{
-		const nodeTypeFactory fact;
 		const auto result = Nan::New<Object>();
 		if (_resultset->EndOfRows())
 		{
 			Nan::Set(result, Nan::New("end_rows").ToLocalChecked(), Nan::New(true));
 		}
 		// cerr << " get_column_values " << endl;
-		const auto number_rows = _resultset->get_result_count();
-		const auto column_count = static_cast<int>(_resultset->get_column_count());
+		Nan::Set(result, Nan::New("data").ToLocalChecked(), rows_to_value(*_resultset));
+		return result;
+	}
+
+	Local<Array> OdbcStatement::rows_to_value(const ResultSet &result_set)
+	{
+		const nodeTypeFactory fact;
+		const auto number_rows = result_set.get_result_count();
+		const auto column_count = static_cast<int>(result_set.get_column_count());
 		const auto results_array = fact.new_array(static_cast<int>(number_rows));
-		const auto data = Nan::New("data").ToLocalChecked();
-		Nan::Set(result, data, results_array);
+		// interned cells share a column object, so they can share one JS string as well.
+		const auto &interner = result_set._interner;
+		unordered_map<const Column *, Local<Value>> interned_values;
+		vector<bool> local_dates(column_count);
+		for (auto c = 0; c < column_count; ++c)
+		{
+			local_dates[c] = result_set.local_date(c);
+		}
 		for (size_t row_id = 0; row_id < number_rows; ++row_id)
 		{
 			const auto row_array = fact.new_array(column_count);
 			Nan::Set(results_array, static_cast<uint32_t>(row_id), row_array);
 			for (auto c = 0; c < column_count; ++c)
 			{
-				Nan::Set(row_array, c, _resultset->get_column(row_id, c)->ToValue());
+				const auto column = result_set.get_column(row_id, c);
+				if (local_dates[c] && column->kind() == Column::Kind::Date)
+				{
+					// shifted on a copy, the cell itself stays in UTC.
+					auto local = static_cast<const TimestampColumn &>(*column);
+					local.to_local();
+					Nan::Set(row_array, c, local.ToValue());
+					continue;
+				}
+				if (!interner || !interner->active(c))
+				{
+					Nan::Set(row_array, c, column->ToValue());
+					continue;
+				}
+				const auto itr = interned_values.find(column.get());
+				if (itr != interned_values.end())
+				{
+					Nan::Set(row_array, c, itr->second);
+					continue;
+				}
+				const auto value = column->ToValue();
+				interned_values.emplace(column.get(), value);
+				Nan::Set(row_array, c, value);
 			}
 		}
 
-		return result;
+		return results_array;
 	}
 
 	bool OdbcStatement::apply_precision(const shared_ptr<BoundDatum> &datum, const int current_param)
@@ -231,69 +426,294 @@ namespace mssql
         return true;
 	}
 
-	// this will show on a different thread to the current executing query.
+	// this will show on a different thread to the current executing query, in any state. the
+	// request is raised before the state is read and the executing thread sets its state before
+	// reading the request, so one always sees the other - either the execute is never sent or
+	// the driver is told to stop. an execute, fetch or lob read in the driver fails with HY008,
+	// a read between driver calls finds the request before its next row or chunk. the executing
+	// thread owns the result set and errors, nothing here touches them. a statement that is
+	// idle - prepared and waiting, finished or closed - has nothing to stop, so no request is
+	// left behind for whatever runs on it next. a created statement is one whose execute has
+	// been dispatched but not yet reached the driver.
 	bool OdbcStatement::cancel()
 	{
+		switch (get_state())
 		{
-			lock_guard<recursive_mutex> lock(g_i_mutex);
-			const auto state = get_state();
-			if (!_pollingEnabled && state == OdbcStatementState::STATEMENT_SUBMITTED) {
-				set_state(OdbcStatementState::STATEMENT_CANCEL_HANDLE);
-				// cerr << " cancel STATEMENT_CANCEL_HANDLE " << endl;
-				cancel_handle();
-				_resultset = make_unique<ResultSet>(0);
-				_resultset->_end_of_rows = false;
-				_endOfResults = false;
-				return true;
-			}
+		case OdbcStatementState::STATEMENT_CREATED:
+		case OdbcStatementState::STATEMENT_BINDING:
+		case OdbcStatementState::STATEMENT_SUBMITTED:
+		case OdbcStatementState::STATEMENT_READING:
+		case OdbcStatementState::STATEMENT_POLLING:
+			break;
+		default:
+			return true;
 		}
+		_cancelRequested = true;
 		if (get_polling())
 		{
-			_cancelRequested = true;
+			// the poll loop sends the cancel itself.
 			return true;
 		}
-		SQLINTEGER native_error = -1;
-		const auto *c_state = "CANCEL";
-		const auto *c_msg = "Error: [msnodesql] cancel only supported for statements where polling is enabled.";
-		_errors->push_back(make_shared<OdbcError>(c_state, c_msg, native_error, 0, "", "", 0));
+		if (transition(OdbcStatementState::STATEMENT_SUBMITTED, OdbcStatementState::STATEMENT_CANCEL_HANDLE)
+			|| get_state() == OdbcStatementState::STATEMENT_READING)
+		{
+			// cerr << " cancel STATEMENT_CANCEL_HANDLE " << endl;
+			signal_cancel();
+		}
+		return true;
+	}
+
+	// from the watchdog thread once the deadline armed for token has passed - a statement that
+	// has finished or moved on to another execute has a different token and is left alone.
+	void OdbcStatement::expire(const uint64_t token)
+	{
+		lock_guard<recursive_mutex> lock(_cancel_mutex);
+		if (token == 0 || _deadlineToken != token)
+		{
+			return;
+		}
+		_timedOut = true;
+		cancel();
+	}
+
+	// called off the executing thread, so the result is ignored rather than read into the
+	// errors. landing between driver calls it has no effect, the request flag covers that.
+	void OdbcStatement::signal_cancel() const
+	{
+		lock_guard<recursive_mutex> lock(_cancel_mutex);
+		if (!_statement)
+			return;
+		SQLCancelHandle(_statement->HandleType, _statement->get());
+	}
+
+	// the executing thread's side of a cancel - the cursor is dropped so the server stops
+	// sending and the operation fails with the cancel error. the request is consumed here so a
+	// prepared statement can be run again - its result set carries the column metadata and the
+	// bound buffers from prepare, so only the rows are dropped.
+	bool OdbcStatement::cancelled()
+	{
+		if (_statement)
+		{
+			SQLFreeStmt(*_statement, SQL_CLOSE);
+		}
+		_cancelRequested = false;
+		if (_prepared && _resultset)
+		{
+			_resultset->start_results();
+		}
+		else
+		{
+			_resultset = make_unique<ResultSet>(0);
+		}
+		_resultset->_end_of_rows = true;
+		_endOfResults = true;
+		_errors->push_back(cancel_error());
+		set_state(OdbcStatementState::STATEMENT_ERROR);
 		return false;
 	}
 
+	shared_ptr<OdbcError> OdbcStatement::cancel_error() const
+	{
+		if (_timedOut)
+		{
+			return make_shared<OdbcError>("HYT00", "[msnodesql] Query timeout expired", 0, 0, "", "", 0);
+		}
+		return make_shared<OdbcError>("U00000", "[Microsoft] Operation canceled", 0, 0, "", "", 0);
+	}
+
+	// sequentially consistent - cancel() and the execute each write one of state and request
+	// and then read the other, which acquire / release alone would let both miss.
 	void OdbcStatement::set_state(const OdbcStatementState state) {
-		lock_guard<recursive_mutex> lock(g_i_mutex);
-		_statementState = state;
+		_statementState.store(state);
+	}
+
+	OdbcStatement::OdbcStatementState OdbcStatement::get_state() const {
+		return _statementState.load();
 	}
 
-	OdbcStatement::OdbcStatementState OdbcStatement::get_state() {
-		lock_guard<recursive_mutex> lock(g_i_mutex);
-		const auto state = _statementState; 
-		return state;
+	bool OdbcStatement::transition(OdbcStatementState from, const OdbcStatementState to) {
+		return _statementState.compare_exchange_strong(from, to);
 	}
 
 	bool OdbcStatement::set_polling(const bool mode)
 	{
-		lock_guard<recursive_mutex> lock(g_i_mutex);
-		if (_statementState == OdbcStatementState::STATEMENT_BINDING || _statementState == OdbcStatementState::STATEMENT_SUBMITTED) {
+		const auto state = get_state();
+		if (state == OdbcStatementState::STATEMENT_BINDING || state == OdbcStatementState::STATEMENT_SUBMITTED) {
 		  return true;	
 		}
-		_pollingEnabled = mode;
+		_pollingEnabled.store(mode, memory_order_release);
 		return true;
 	}
 
-	bool OdbcStatement::get_polling()
+	bool OdbcStatement::get_polling() const
 	{
-		lock_guard<recursive_mutex> lock(g_i_mutex);
-		const auto polling = _pollingEnabled;
-		return polling;
+		return _pollingEnabled.load(memory_order_acquire);
 	}
 
+	// the options below are set by the operation about to execute on this statement and
+	// only read by it, on the same thread, so they need no guard.
+
 	bool OdbcStatement::set_numeric_string(const bool mode)
 	{
-		lock_guard<recursive_mutex> lock(g_i_mutex);
 		_numericStringEnabled = mode;
 		return true;
 	}
 
+	bool OdbcStatement::set_decimal_string(const bool mode)
+	{
+		_decimalStringEnabled = mode;
+		return true;
+	}
+
+	bool OdbcStatement::set_utf8_data(const bool mode)
+	{
+		_utf8Enabled = mode;
+		return true;
+	}
+
+	bool OdbcStatement::set_max_interned_strings(const size_t cap)
+	{
+		_maxInternedStrings = cap;
+		return true;
+	}
+
+	bool OdbcStatement::set_prefetch_depth(const size_t depth)
+	{
+		_prefetchDepth = depth;
+		return true;
+	}
+
+	namespace
+	{
+		struct PrefetchWork
+		{
+			uv_work_t work;
+			shared_ptr<OdbcStatement> statement;
+			size_t number_rows;
+			uint64_t generation;
+			bool fetched;
+		};
+	}
+
+	// called by the read operations once the rows of the last read are converted, which
+	// frees the result set for the thread pool to fetch into again.
+	void OdbcStatement::prefetch(const size_t number_rows)
+	{
+		{
+			lock_guard<mutex> lock(_prefetchMutex);
+			_prefetchHeld = false;
+		}
+		schedule_prefetch(number_rows);
+	}
+
+	// nothing is started while a batch is still being fetched, the queue is full, the rows
+	// have run out or JS has paused the query - a paused stream holds at most depth batches.
+	void OdbcStatement::schedule_prefetch(const size_t number_rows)
+	{
+		if (_prefetchDepth == 0 || _prepared || _prefetchPaused)
+			return;
+		uint64_t generation;
+		{
+			lock_guard<mutex> lock(_prefetchMutex);
+			if (_prefetchRunning || _prefetchEnded || _prefetched.size() >= _prefetchDepth)
+				return;
+			_prefetchRunning = true;
+			generation = _prefetchGeneration;
+		}
+		auto* const work = new PrefetchWork{ uv_work_t(), shared_from_this(), number_rows, generation, false };
+		work->work.data = work;
+		uv_queue_work(Nan::GetCurrentEventLoop(), &work->work, prefetch_background, prefetch_foreground);
+	}
+
+	// the read that follows a resume clears this again.
+	void OdbcStatement::pause_prefetch()
+	{
+		_prefetchPaused = true;
+	}
+
+	void OdbcStatement::prefetch_background(uv_work_t* work)
+	{
+		auto* const w = static_cast<PrefetchWork*>(work->data);
+		w->fetched = w->statement->prefetch_batch(w->number_rows, w->generation);
+	}
+
+	void OdbcStatement::prefetch_foreground(uv_work_t* work, int)
+	{
+		auto* const w = static_cast<PrefetchWork*>(work->data);
+		const auto statement = w->statement;
+		const auto number_rows = w->number_rows;
+		const auto fetched = w->fetched;
+		delete w;
+		{
+			lock_guard<mutex> lock(statement->_prefetchMutex);
+			statement->_prefetchRunning = false;
+		}
+		// a batch that was skipped is picked up again by prefetch() once the read converts.
+		if (fetched)
+			statement->schedule_prefetch(number_rows);
+	}
+
+	// the batch is fetched into the result set exactly as a read would, then its rows are
+	// moved out to the queue. a read that has taken rows but not yet converted them on the
+	// loop thread still owns the result set, so nothing is fetched until it lets go.
+	bool OdbcStatement::prefetch_batch(const size_t number_rows, const uint64_t generation)
+	{
+		const lock_guard<mutex> statement_lock(_statement_mutex);
+		{
+			lock_guard<mutex> lock(_prefetchMutex);
+			if (generation != _prefetchGeneration || _prefetchEnded || _prefetchHeld)
+				return false;
+			if (!_statement || !_resultset)
+			{
+				_prefetchEnded = true;
+				return false;
+			}
+		}
+		_resultset->start_results();
+		const auto ok = fetch_read(number_rows);
+		PrefetchBatch batch{ move(_resultset->_rows), _resultset->_end_of_rows, ok };
+		_resultset->start_results();
+		++_stats->prefetched_batches;
+		lock_guard<mutex> lock(_prefetchMutex);
+		_prefetchEnded = !ok || batch.end_of_rows;
+		_prefetched.push_back(move(batch));
+		return true;
+	}
+
+	// called by the read with the statement held, so no batch is being fetched meanwhile.
+	bool OdbcStatement::take_prefetched(bool& res)
+	{
+		if (_prefetchDepth == 0)
+			return false;
+		_prefetchPaused = false;
+		lock_guard<mutex> lock(_prefetchMutex);
+		if (_prefetched.empty())
+			return false;
+		auto& batch = _prefetched.front();
+		_resultset->_rows = move(batch.rows);
+		_resultset->_end_of_rows = batch.end_of_rows;
+		res = batch.ok;
+		_prefetched.pop_front();
+		return true;
+	}
+
+	void OdbcStatement::reset_prefetch()
+	{
+		lock_guard<mutex> lock(_prefetchMutex);
+		++_prefetchGeneration;
+		_prefetched.clear();
+		_prefetchEnded = false;
+		_prefetchHeld = false;
+		_prefetchPaused = false;
+	}
+
+	bool OdbcStatement::set_json_mode(const bool reassemble, const bool parse)
+	{
+		_jsonReassemble = reassemble;
+		_jsonParse = parse;
+		return true;
+	}
+
 	bool OdbcStatement::bind_tvp(vector<tvp_t> &tvps)
 	{
 		if (!_statement)
@@ -428,6 +848,7 @@ namespace mssql
 			return false;
 		auto &ps = *params;
 		// fprintf(stderr, "bind_params\n");
+		_tvpStream = nullptr;
 		const auto size = get_size(ps);
 		if (size <= 0)
 			return true;
@@ -452,7 +873,12 @@ namespace mssql
 			}
 			if (datum->is_tvp)
 			{
+				const auto queued = tvps.size();
 				queue_tvp(current_param, itr, datum, tvps);
+				if (datum->is_tvp_stream && (tvps.size() == queued || !stream_tvp(datum, tvps.back().second)))
+				{
+					return false;
+				}
 			}
 			++current_param;
 		}
@@ -461,6 +887,29 @@ namespace mssql
 		return true;
 	}
 
+	// the columns are moved onto the stream buffers before bind_tvp binds them, so the
+	// addresses the driver is given stay valid for every chunk.
+	bool OdbcStatement::stream_tvp(const shared_ptr<BoundDatum> &datum, const shared_ptr<param_bindings> &columns)
+	{
+		string err;
+		if (_tvpStream)
+		{
+			err = "only one streamed table valued parameter can be bound per statement";
+		}
+		else
+		{
+			const auto stream = make_shared<TvpStream>(datum, columns);
+			if (stream->adopt(err))
+			{
+				_tvpStream = stream;
+				return true;
+			}
+		}
+		const auto message = "[msnodesql] " + err;
+		_errors->push_back(make_shared<OdbcError>("IMNOD", message.c_str(), -1, 0, "", "", 0));
+		return false;
+	}
+
 	Local<Array> OdbcStatement::unbind_params() const
 	{
 		if (_boundParamsSet != nullptr)
@@ -474,6 +923,13 @@ namespace mssql
 
 	Local<Value> OdbcStatement::get_meta_value() const
 	{
+		if (_tvpStream)
+		{
+			// not run yet - JS answers with the next chunk of the streamed tvp.
+			const auto need = Nan::New<Object>();
+			Nan::Set(need, Nan::New("tvp_need_rows").ToLocalChecked(), Nan::New(true));
+			return need;
+		}
 		if (_cancelRequested || _resultset == nullptr)
 		{
 			const nodeTypeFactory fact;
@@ -503,6 +959,12 @@ namespace mssql
 		if (!_statement)
 			return false;
 		_statement->read_errors(_errors);
+		if (_timedOut)
+		{
+			// the driver reports the cancel the watchdog sent, the caller wants to know why.
+			_errors->clear();
+			_errors->push_back(cancel_error());
+		}
 		return false;
 	}
 
@@ -528,6 +990,11 @@ namespace mssql
 
 		current.dataTypeName = swcvec2str(type_name, type_name_len);
 		// wcerr << "type_name_len " << current.dataTypeName << endl;
+		current.displaySize = 0;
+		ret = SQLColAttribute(*_statement, index, SQL_DESC_DISPLAY_SIZE, nullptr, 0, nullptr, &current.displaySize);
+		if (!check_odbc_error(ret))
+			return false;
+
 		switch (current.dataType)
 		{
 		case SQL_SS_VARIANT:
@@ -598,6 +1065,7 @@ namespace mssql
 			return false;
 
 		auto column = 0;
+		reset_prefetch();
 		_resultset = make_unique<ResultSet>(columns);
 		const auto cols = static_cast<int>(_resultset->get_column_count());
 		// cerr << "start_reading_results. cols = " << cols << " " << endl;
@@ -608,6 +1076,13 @@ namespace mssql
 				return false;
 			}
 		}
+		build_readers();
+		if (_maxInternedStrings > 0)
+		{
+			_resultset->_interner = make_shared<StringInterner>(cols, _maxInternedStrings);
+		}
+		_resultset->_for_json = _jsonReassemble && is_for_json();
+		_resultset->_local_dates = _query && _query->local_dates();
 
 		ret = SQLRowCount(statement, &_resultset->_row_count);
 		// cerr << "start_reading_results. row count = " << _resultset->_row_count << " " << endl;
@@ -649,6 +1124,7 @@ namespace mssql
 
 		_preparedStorage = make_shared<BoundDatumSet>(q);
 		_resultset = make_unique<ResultSet>(num_cols);
+		_resultset->_local_dates = q->local_dates();
 
 		for (auto i = 0; i < num_cols; i++)
 		{
@@ -681,6 +1157,7 @@ namespace mssql
 
 		if (ret == SQL_STILL_EXECUTING)
 		{
+			auto cancel_sent = false;
 			while (true)
 			{
 				if (direct)
@@ -692,7 +1169,6 @@ namespace mssql
 					ret = SQLExecute(statement);
 				}
 
-				bool submit_cancel;
 				if (ret != SQL_STILL_EXECUTING)
 				{
 					break;
@@ -704,13 +1180,9 @@ namespace mssql
 #if defined(LINUX_BUILD)
 				usleep(1000); // wait 1 MS
 #endif
+				if (!cancel_sent && _cancelRequested)
 				{
-					lock_guard<recursive_mutex> lock(g_i_mutex);
-					submit_cancel = _cancelRequested;
-				}
-
-				if (submit_cancel)
-				{
+					cancel_sent = true;
 					cancel_handle();
 				}
 			}
@@ -718,18 +1190,6 @@ namespace mssql
 		return ret;
 	}
 
-	bool OdbcStatement::raise_cancel()
-	{
-		_resultset = make_unique<ResultSet>(0);
-		_resultset->_end_of_rows = true;
-		_endOfResults = true; // reset
-		const string c_msg = "[Microsoft] Operation canceled";
-		const string c_state = "U00000";
-		const auto last = make_shared<OdbcError>(c_state.c_str(), c_msg.c_str(), 0, 0, "", "", 0);
-		_errors->push_back(last);
-		return true;
-	}
-
 	bool OdbcStatement::try_bcp(const shared_ptr<BoundDatumSet> &param_set, int32_t version)
 	{
 		// cerr << "bcp version " << version << endl;
@@ -749,12 +1209,20 @@ namespace mssql
 			return false;
 		const auto &statement = *_statement;
 		const bool polling_mode = get_polling();
+		// a request that landed after the last run finished is not for this one.
+		_cancelRequested = false;
 		const auto bound = bind_params(param_set);
 		if (!bound)
 		{
 			// error already set in BindParams
 			return false;
 		}
+		if (_tvpStream)
+		{
+			_tvpStream = nullptr;
+			_errors->push_back(make_shared<OdbcError>("IMNOD", "[msnodesql] a streamed table valued parameter cannot be bound to a prepared statement", -1, 0, "", "", 0));
+			return false;
+		}
 		if (polling_mode)
 		{
 			const auto s = SQLSetStmtAttr(statement, SQL_ATTR_ASYNC_ENABLE, reinterpret_cast<SQLPOINTER>(SQL_ASYNC_ENABLE_ON), 0);
@@ -764,17 +1232,18 @@ namespace mssql
 			}
 		}
 
+		set_state(OdbcStatementState::STATEMENT_SUBMITTED);
+		if (_cancelRequested)
+		{
+			return cancelled();
+		}
 		auto ret = SQLExecute(statement);
+		transition(OdbcStatementState::STATEMENT_SUBMITTED, OdbcStatementState::STATEMENT_READING);
 		if (polling_mode)
 		{
 			const auto vec = make_shared<vector<uint16_t>>();
 			ret = poll_check(ret, vec, false);
 		}
-		const auto state = get_state();
-		if (state == OdbcStatementState::STATEMENT_CANCELLED)
-		{
-			return raise_cancel();
-		}
 
 		if (ret == SQL_NO_DATA)
 		{
@@ -784,7 +1253,11 @@ namespace mssql
 		}
 
 		if (!check_odbc_error(ret))
+		{
+			// a cancel that stopped this execute is spent, the next one starts clean.
+			_cancelRequested = false;
 			return false;
+		}
 
 		ret = SQLRowCount(statement, &_resultset->_row_count);
 		return check_odbc_error(ret);
@@ -801,10 +1274,6 @@ namespace mssql
 			// fprintf(stderr, "cancel req failed state %d %ld \n", _statementState, _statementId);
 			return false;
 		}
-		{
-			lock_guard<recursive_mutex> lock(g_i_mutex);
-			_cancelRequested = false;
-		}
 		// set_state(OdbcStatementState::STATEMENT_CANCELLED);
 		return true;
 	}
@@ -828,48 +1297,80 @@ namespace mssql
 				return try_bcp(param_set, first->bcp_version);
 			}
 		}
-		const bool polling_mode = get_polling();
+		_timedOut = false;
+		{
+			// a deadline still pending from an earlier execute must not land on this one.
+			lock_guard<recursive_mutex> lock(_cancel_mutex);
+			_deadlineToken = 0;
+		}
+		set_state(OdbcStatementState::STATEMENT_BINDING);
+		const auto bound = bind_params(param_set);
+		if (!bound)
 		{
-			lock_guard<recursive_mutex> lock(g_i_mutex);
-			set_state(OdbcStatementState::STATEMENT_BINDING);
-			const auto bound = bind_params(param_set);
-			if (!bound)
+			// error already set in BindParams
+			return false;
+		}
+		// the deadline covers the server's work, not the client side binding above.
+		const auto deadline = q->deadline_ms();
+		if (deadline > 0)
+		{
+			static atomic<uint64_t> tokens(0);
+			const auto token = ++tokens;
 			{
-				// error already set in BindParams
-				return false;
+				lock_guard<recursive_mutex> lock(_cancel_mutex);
+				_deadlineToken = token;
 			}
-			
-			_endOfResults = true; // reset
-			const auto ret = query_timeout(timeout);
-			if (!check_odbc_error(ret))
-				return false;
-			
-			if (polling_mode)
-			{
-				SQLSetStmtAttr(*_statement, SQL_ATTR_ASYNC_ENABLE, reinterpret_cast<SQLPOINTER>(SQL_ASYNC_ENABLE_ON), 0);
-			} 
+			Watchdog::instance().arm(shared_from_this(), token, deadline);
 		}
+		// the rows of a streamed tvp are pushed from later operations, which needs the
+		// execute to return with the statement parked rather than polled to completion.
+		const bool polling_mode = get_polling() && !_tvpStream;
+		
+		_endOfResults = true; // reset
+		const auto timeout_ret = query_timeout(timeout);
+		if (!check_odbc_error(timeout_ret))
+			return false;
+		
+		if (polling_mode)
+		{
+			SQLSetStmtAttr(*_statement, SQL_ATTR_ASYNC_ENABLE, reinterpret_cast<SQLPOINTER>(SQL_ASYNC_ENABLE_ON), 0);
+		} 
 		const auto query = q->query_string();
 
 		set_state(OdbcStatementState::STATEMENT_SUBMITTED);	
-		SQLRETURN ret = SQLExecDirect(*_statement, reinterpret_cast<SQLWCHAR*>(query->data()), query->size());
+		if (_cancelRequested)
 		{
-			// we may have cancelled this query on a different thread
-			// so only switch state if this query completed.
-			lock_guard<recursive_mutex> lock(g_i_mutex);
-			{
-				const auto state = get_state();
-				if (state == OdbcStatementState::STATEMENT_SUBMITTED) {
-					set_state(OdbcStatementState::STATEMENT_READING);
-				}
-			}
+			return cancelled();
 		}
+		SQLRETURN ret = SQLExecDirect(*_statement, reinterpret_cast<SQLWCHAR*>(query->data()), query->size());
+		// we may have cancelled this query on a different thread
+		// so only switch state if this query completed.
+		transition(OdbcStatementState::STATEMENT_SUBMITTED, OdbcStatementState::STATEMENT_READING);
 		if (polling_mode)
 		{
 			set_state(OdbcStatementState::STATEMENT_POLLING);
 			ret = poll_check(ret, query, true);
 		} 
-	
+
+		if (ret == SQL_NEED_DATA && _tvpStream)
+		{
+			_boundParamsSet = param_set;
+			SQLPOINTER token = nullptr;
+			ret = SQLParamData(*_statement, &token);
+			if (ret != SQL_NEED_DATA)
+			{
+				return complete_execute(ret, param_set);
+			}
+			return push_tvp_rows();
+		}
+		return complete_execute(ret, param_set);
+	}
+
+	// everything after the statement has run, whether directly or once a streamed tvp
+	// has sent its last chunk.
+	bool OdbcStatement::complete_execute(const SQLRETURN ret, const shared_ptr<BoundDatumSet> &param_set)
+	{
+		_tvpStream = nullptr;
 		// cerr << "ret = " << ret << endl;
 		if (ret == SQL_NO_DATA)
 		{
@@ -884,6 +1385,7 @@ namespace mssql
 		{
 			// cerr << "SQL_SUCCEEDED = " << ret << endl;
 			return_odbc_error();
+			_cancelRequested = false;
 			_resultset = make_unique<ResultSet>(0);
 			_resultset->_end_of_rows = true;
 			return false;
@@ -910,6 +1412,85 @@ namespace mssql
 		return start_reading_results();
 	}
 
+	bool OdbcStatement::try_send_tvp_rows(const shared_ptr<BoundDatumSet> &chunk)
+	{
+		if (!_statement || !_tvpStream)
+		{
+			_errors->push_back(make_shared<OdbcError>("IMNOD", "[msnodesql] statement is not waiting for table valued parameter rows", -1, 0, "", "", 0));
+			return false;
+		}
+		_errors->clear();
+		if (_cancelRequested)
+		{
+			// leave the data at execution sequence before the cursor can be closed.
+			signal_cancel();
+			_tvpStream = nullptr;
+			return cancelled();
+		}
+		string err;
+		auto &set = *chunk;
+		BoundDatumSet::param_bindings columns;
+		for (size_t i = 1; i < set.size(); ++i)
+		{
+			columns.push_back(set.atIndex(static_cast<int>(i)));
+		}
+		if (set.size() == 0 || !set.atIndex(0)->is_tvp_stream || !_tvpStream->fill(set.atIndex(0), columns, err))
+		{
+			const auto message = "[msnodesql] " + (err.empty() ? string("tvp chunk is not a streamed table valued parameter") : err);
+			_errors->push_back(make_shared<OdbcError>("IMNOD", message.c_str(), -1, 0, "", "", 0));
+			return abandon_tvp_rows();
+		}
+		return push_tvp_rows();
+	}
+
+	// hand the driver what is in the buffers. the statement stays parked in SQLParamData
+	// until the chunk marked last, which is followed by the empty batch that ends the tvp.
+	bool OdbcStatement::push_tvp_rows()
+	{
+		const auto &statement = *_statement;
+		SQLPOINTER token = nullptr;
+		SQLRETURN ret;
+		const auto rows = _tvpStream->rows();
+		if (rows > 0)
+		{
+			ret = SQLPutData(statement, _tvpStream->token(), rows);
+			if (!check_odbc_error(ret))
+			{
+				return abandon_tvp_rows();
+			}
+			ret = SQLParamData(statement, &token);
+			if (ret != SQL_NEED_DATA)
+			{
+				return complete_execute(ret, _boundParamsSet);
+			}
+		}
+		if (!_tvpStream->ended())
+		{
+			return true;
+		}
+		ret = SQLPutData(statement, nullptr, 0);
+		if (!check_odbc_error(ret))
+		{
+			return abandon_tvp_rows();
+		}
+		ret = SQLParamData(statement, &token);
+		return complete_execute(ret, _boundParamsSet);
+	}
+
+	// the errors are already recorded - the driver is taken out of the data at execution
+	// sequence so the statement can be freed or run again.
+	bool OdbcStatement::abandon_tvp_rows()
+	{
+		_tvpStream = nullptr;
+		_cancelRequested = false;
+		signal_cancel();
+		_resultset = make_unique<ResultSet>(0);
+		_resultset->_end_of_rows = true;
+		_endOfResults = true;
+		set_state(OdbcStatementState::STATEMENT_ERROR);
+		return false;
+	}
+
 	bool OdbcStatement::dispatch_prepared(const SQLSMALLINT t, const size_t column_size, const size_t rows_read, const size_t column) const
 	{
 		auto res = false;
@@ -992,32 +1573,28 @@ namespace mssql
 		return res;
 	}
 
-	bool OdbcStatement::dispatch(const SQLSMALLINT t, const size_t row_id, const size_t column)
+	OdbcStatement::column_reader_t OdbcStatement::select_reader(const ResultSet::ColumnDefinition &definition) const
 	{
-		if (!_statement)
-			return false;
-		// cerr << " dispatch row = " << row_id << endl;
-		bool res;
-		switch (t)
+		switch (definition.dataType)
 		{
 		case SQL_SS_VARIANT:
-			res = d_variant(row_id, column);
-			break;
+			// underlying type can change row to row, so this one still dispatches per cell.
+			return &OdbcStatement::d_variant;
 
 		case SQL_CHAR:
 		case SQL_VARCHAR:
 		case SQL_LONGVARCHAR:
-		case SQL_WCHAR:
-		case SQL_WVARCHAR:
-		case SQL_WLONGVARCHAR:
-		case SQL_SS_XML:
-		case SQL_GUID:
-			res = try_read_string(false, row_id, column);
-			break;
+#ifdef WINDOWS_BUILD
+			// SQL_C_CHAR is in the ANSI code page on windows, not UTF-8, so stay wide there.
+			return &OdbcStatement::read_string;
+#else
+			return _utf8Enabled
+				? &OdbcStatement::get_data_utf8
+				: &OdbcStatement::read_string;
+#endif
 
 		case SQL_BIT:
-			res = get_data_bit(row_id, column);
-			break;
+			return &OdbcStatement::get_data_fixed<char, SQL_C_BIT, BoolColumn, false>;
 
 		case SQL_SMALLINT:
 		case SQL_TINYINT:
@@ -1028,76 +1605,66 @@ namespace mssql
 		case SQL_C_ULONG:
 		case SQL_C_USHORT:
 		case SQL_C_UTINYINT:
-			if (_numericStringEnabled)
-			{
-				res = try_read_string(false, row_id, column);
-			}
-			else
-			{
-				res = get_data_long(row_id, column);
-			}
-			break;
+			return _numericStringEnabled
+				? &OdbcStatement::read_string
+				: &OdbcStatement::get_data_fixed<long, SQL_C_SLONG, IntColumn, true>;
 
 		case SQL_C_SBIGINT:
 		case SQL_C_UBIGINT:
 		case SQL_BIGINT:
-			if (_numericStringEnabled)
-			{
-				res = try_read_string(false, row_id, column);
-			}
-			else
-			{
-				res = get_data_big_int(row_id, column);
-			}
-			break;
+			return _numericStringEnabled
+				? &OdbcStatement::read_string
+				: &OdbcStatement::get_data_fixed<DatumStorage::bigint_t, SQL_C_SBIGINT, BigIntColumn, true>;
 
 		case SQL_NUMERIC:
-			if (_numericStringEnabled)
-			{
-				res = try_read_string(false, row_id, column);
-			}
-			else
-			{
-				res = get_data_decimal(row_id, column);
-			}
-			break;
+			return _numericStringEnabled || _decimalStringEnabled
+				? &OdbcStatement::read_string
+				: &OdbcStatement::get_data_decimal;
 
 		case SQL_DECIMAL:
+			return _decimalStringEnabled
+				? &OdbcStatement::read_string
+				: &OdbcStatement::get_data_decimal;
+
 		case SQL_REAL:
 		case SQL_FLOAT:
 		case SQL_DOUBLE:
-			res = get_data_decimal(row_id, column);
-			break;
+			return &OdbcStatement::get_data_decimal;
 
 		case SQL_BINARY:
 		case SQL_VARBINARY:
 		case SQL_LONGVARBINARY:
 		case SQL_SS_UDT:
-			res = get_data_binary(row_id, column);
-			break;
+			return &OdbcStatement::get_data_binary;
 
 		case SQL_SS_TIMESTAMPOFFSET:
-			res = get_data_timestamp_offset(row_id, column);
-			break;
+			return &OdbcStatement::get_data_timestamp_offset;
 
 		case SQL_TYPE_TIME:
 		case SQL_SS_TIME2:
-			res = d_time(row_id, column);
-			break;
+			return &OdbcStatement::d_time;
 
 		case SQL_TIMESTAMP:
 		case SQL_DATETIME:
 		case SQL_TYPE_TIMESTAMP:
 		case SQL_TYPE_DATE:
-			res = get_data_timestamp(row_id, column);
-			break;
+			return &OdbcStatement::get_data_timestamp;
 
 		default:
-			res = try_read_string(false, row_id, column);
-			break;
+			// SQL_CHAR, SQL_WCHAR, SQL_SS_XML, SQL_GUID etc.
+			return &OdbcStatement::read_string;
 		}
+	}
 
-		return res;
+	void OdbcStatement::build_readers()
+	{
+		const auto column_count = static_cast<int>(_resultset->get_column_count());
+		_readers.resize(column_count);
+		for (auto c = 0; c < column_count; ++c)
+		{
+			_readers[c] = select_reader(_resultset->get_meta_data(c));
+		}
+		_resultset->_readers_built = true;
 	}
 
 	bool OdbcStatement::d_variant(const size_t row_id, const size_t column)
@@ -1107,18 +1674,26 @@ namespace mssql
 		SQLLEN iv = 0;
 		char b = 0;
 		// Figure out the length
-		auto ret = SQLGetData(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_BINARY, &b, 0, &iv);
+		auto ret = get_data(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_BINARY, &b, 0, &iv);
 		if (!check_odbc_error(ret))
 			return false;
 		// Figure out the type
 		ret = SQLColAttribute(statement, column + 1, SQL_CA_SS_VARIANT_TYPE, nullptr, 0, nullptr, &variant_type);
 		if (!check_odbc_error(ret))
 			return false;
-		// set the definiton to actual data underlying data type.
+		// set the definiton to actual data underlying data type, read as a column of that type
+		// would be so the utf8 and decimal string options apply here as well.
 		auto &definition = _resultset->get_meta_data(static_cast<int>(column));
 		definition.dataType = static_cast<SQLSMALLINT>(variant_type);
-		const auto res = dispatch(definition.dataType, row_id, column);
-		return res;
+		ret = SQLColAttribute(statement, column + 1, SQL_DESC_DISPLAY_SIZE, nullptr, 0, nullptr, &definition.displaySize);
+		if (!check_odbc_error(ret))
+			return false;
+		const auto reader = select_reader(definition);
+		if (reader == &OdbcStatement::d_variant)
+		{
+			return read_string(row_id, column);
+		}
+		return (this->*reader)(row_id, column);
 	}
 
 
@@ -1127,15 +1702,7 @@ namespace mssql
 		const auto &statement = *_statement;
 		SQLLEN str_len_or_ind_ptr = 0;
 		SQL_SS_TIME2_STRUCT time = {};
-		SQLLEN   precision = 0;
-		SQLLEN   colscale = 0;
-		const auto ret2 = SQLColAttribute(statement, column + 1, SQL_COLUMN_PRECISION, nullptr, 0, nullptr, &precision);
-		if (!check_odbc_error(ret2))
-        	return false;
-		const auto ret3 = SQLColAttribute(statement, column + 1, SQL_COLUMN_SCALE, nullptr, 0, nullptr, &colscale);
-		if (!check_odbc_error(ret3))
-        	return false;
-		const auto ret = SQLGetData(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_BINARY, &time, sizeof(time), &str_len_or_ind_ptr);
+		const auto ret = get_data(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_BINARY, &time, sizeof(time), &str_len_or_ind_ptr);
 		
 		if (!check_odbc_error(ret))
 			return false;
@@ -1166,7 +1733,7 @@ namespace mssql
 		storage->ReserveTimestampOffset(1);
 		SQLLEN str_len_or_ind_ptr = 0;
 
-		const auto ret = SQLGetData(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_DEFAULT, storage->timestampoffsetvec_ptr->data(),
+		const auto ret = get_data(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_DEFAULT, storage->timestampoffsetvec_ptr->data(),
 									sizeof(SQL_SS_TIMESTAMPOFFSET_STRUCT), &str_len_or_ind_ptr);
 		if (!check_odbc_error(ret))
 			return false;
@@ -1184,7 +1751,7 @@ namespace mssql
 		const auto &statement = *_statement;
 		SQLLEN str_len_or_ind_ptr = 0;
 		TIMESTAMP_STRUCT v;
-		const auto ret = SQLGetData(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_TIMESTAMP, &v,
+		const auto ret = get_data(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_TIMESTAMP, &v,
 									sizeof(TIMESTAMP_STRUCT), &str_len_or_ind_ptr);
 		if (!check_odbc_error(ret))
 			return false;
@@ -1197,36 +1764,13 @@ namespace mssql
 		return true;
 	}
 
-	bool OdbcStatement::get_data_big_int(const size_t row_id, const size_t column)
-	{
-		const auto &statement = *_statement;
-		DatumStorage::bigint_t v = 0;
-		SQLLEN str_len_or_ind_ptr = 0;
-		const auto ret = SQLGetData(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_SBIGINT, &v, sizeof(DatumStorage::bigint_t),
-									&str_len_or_ind_ptr);
-		if (!check_odbc_error(ret))
-			return false;
-		if (str_len_or_ind_ptr == SQL_NULL_DATA)
-		{
-			_resultset->add_column(row_id, make_shared<NullColumn>(column));
-			return true;
-		}
-		const auto col = make_shared<BigIntColumn>(column, v);
-		if (_numericStringEnabled)
-		{
-			col->AsString();
-		}
-		_resultset->add_column(row_id, col);
-		return true;
-	}
-
-	bool OdbcStatement::get_data_long(const size_t row_id, const size_t column)
+	template <typename T, SQLSMALLINT c_type, class TColumn, bool numeric>
+	bool OdbcStatement::get_data_fixed(const size_t row_id, const size_t column)
 	{
 		const auto &statement = *_statement;
-
-		long v = 0;
+		T v = 0;
 		SQLLEN str_len_or_ind_ptr = 0;
-		const auto ret = SQLGetData(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_SLONG, &v, sizeof(int64_t),
+		const auto ret = get_data(statement, static_cast<SQLSMALLINT>(column + 1), c_type, &v, sizeof(T),
 									&str_len_or_ind_ptr);
 		if (!check_odbc_error(ret))
 			return false;
@@ -1235,8 +1779,8 @@ namespace mssql
 			_resultset->add_column(row_id, make_shared<NullColumn>(column));
 			return true;
 		}
-		const auto col = make_shared<IntColumn>(column, v);
-		if (_numericStringEnabled)
+		const auto col = make_shared<TColumn>(column, v);
+		if (numeric && _numericStringEnabled)
 		{
 			col->AsString();
 		}
@@ -1244,24 +1788,6 @@ namespace mssql
 		return true;
 	}
 
-	bool OdbcStatement::get_data_bit(const size_t row_id, const size_t column)
-	{
-		const auto &statement = *_statement;
-		char v = 0;
-		SQLLEN str_len_or_ind_ptr = 0;
-		const auto ret = SQLGetData(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_BIT, &v, sizeof(char),
-									&str_len_or_ind_ptr);
-		if (!check_odbc_error(ret))
-			return false;
-		if (str_len_or_ind_ptr == SQL_NULL_DATA)
-		{
-			_resultset->add_column(row_id, make_shared<NullColumn>(column));
-			return true;
-		}
-		_resultset->add_column(row_id, make_shared<BoolColumn>(column, v));
-		return true;
-	}
-
 	bool OdbcStatement::reserved_bit(const size_t row_count, const size_t column) const
 	{
 		const auto &bound_datum = _preparedStorage->atIndex(static_cast<int>(column));
@@ -1441,7 +1967,7 @@ namespace mssql
 		const auto &statement = *_statement;
 		SQLLEN str_len_or_ind_ptr = 0;
 		SQL_NUMERIC_STRUCT v;
-		const auto ret = SQLGetData(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_NUMERIC, &v, sizeof(SQL_NUMERIC_STRUCT),
+		const auto ret = get_data(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_NUMERIC, &v, sizeof(SQL_NUMERIC_STRUCT),
 									&str_len_or_ind_ptr);
 		if (!check_odbc_error(ret))
 			return false;
@@ -1480,7 +2006,7 @@ namespace mssql
 		const auto &statement = *_statement;
 		SQLLEN str_len_or_ind_ptr = 0;
 		double v = NAN;
-		const auto ret = SQLGetData(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_DOUBLE, &v, sizeof(double),
+		const auto ret = get_data(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_DOUBLE, &v, sizeof(double),
 									&str_len_or_ind_ptr);
 		if (!check_odbc_error(ret))
 			return false;
@@ -1527,7 +2053,7 @@ namespace mssql
 		const auto &char_data = storage->charvec_ptr;
 		auto *write_ptr = char_data->data();
 		SQLLEN total_bytes_to_read = 0;
-		auto r = SQLGetData(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_BINARY, write_ptr, bytes_to_read, &total_bytes_to_read);
+		auto r = get_data(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_BINARY, write_ptr, bytes_to_read, &total_bytes_to_read);
 		if (!check_odbc_error(r))
 			return false;
 		if (total_bytes_to_read == SQL_NULL_DATA)
@@ -1552,7 +2078,7 @@ namespace mssql
 		while (more)
 		{
 			bytes_to_read = min(static_cast<SQLLEN>(atomic_read), total_bytes_to_read);
-			r = SQLGetData(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_BINARY, write_ptr, bytes_to_read, &total_bytes_to_read);
+			r = get_data(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_BINARY, write_ptr, bytes_to_read, &total_bytes_to_read);
 			if (!check_odbc_error(r))
 				return false;
 			more = check_more_read(r, status);
@@ -1569,6 +2095,11 @@ namespace mssql
 
 	bool OdbcStatement::check_more_read(SQLRETURN r, bool &status)
 	{
+		if (_cancelRequested)
+		{
+			status = false;
+			return cancelled();
+		}
 		const auto &statement = *_statement;
 		vector<SQLWCHAR> sql_state(6);
 		SQLINTEGER native_error = 0;
@@ -1674,7 +2205,7 @@ namespace mssql
 		// cerr << "lob ..... " << endl;
 		const auto &statement = *_statement;
 		lob_capture capture;
-		auto r = SQLGetData(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_WCHAR, capture.write_ptr, capture.bytes_to_read + capture.item_size, &capture.total_bytes_to_read);
+		auto r = get_data(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_WCHAR, capture.write_ptr, capture.bytes_to_read + capture.item_size, &capture.total_bytes_to_read);
 		if (capture.total_bytes_to_read == SQL_NULL_DATA)
 		{
 			// cerr << "lob NullColumn " << endl;
@@ -1694,7 +2225,7 @@ namespace mssql
 		while (more)
 		{
 			capture.bytes_to_read = min(capture.atomic_read_bytes, capture.total_bytes_to_read);
-			r = SQLGetData(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_WCHAR, capture.write_ptr, capture.bytes_to_read + capture.item_size, &capture.total_bytes_to_read);
+			r = get_data(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_WCHAR, capture.write_ptr, capture.bytes_to_read + capture.item_size, &capture.total_bytes_to_read);
 			capture.on_next_read();
 			if (!check_odbc_error(r))
 			{
@@ -1790,7 +2321,7 @@ namespace mssql
 
 		display_size++;
 		storage->ReserveUint16(display_size); // increment for null terminator
-		const auto r = SQLGetData(*_statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_WCHAR, storage->uint16vec_ptr->data(), display_size * size,
+		const auto r = get_data(*_statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_WCHAR, storage->uint16vec_ptr->data(), display_size * size,
 								  &value_len);
 
 		if (r != SQL_NO_DATA && !check_odbc_error(r))
@@ -1806,20 +2337,29 @@ namespace mssql
 
 		assert(value_len >= 0 && value_len <= display_size - 1);
 		storage->uint16vec_ptr->resize(value_len);
+		const auto &interner = _resultset->_interner;
+		if (interner && interner->active(column))
+		{
+			const auto *bytes = storage->uint16vec_ptr->data();
+			const auto hit = interner->find(column, bytes, value_len * size);
+			if (hit)
+			{
+				_resultset->add_column(row_id, hit);
+				return true;
+			}
+			const auto value = make_shared<StringColumn>(column, storage, value_len);
+			interner->add(column, bytes, value_len * size, value);
+			_resultset->add_column(row_id, value);
+			return true;
+		}
 		const auto value = make_shared<StringColumn>(column, storage, value_len);
 		_resultset->add_column(row_id, value);
 
 		return true;
 	}
 
-	bool OdbcStatement::try_read_string(bool binary, const size_t row_id, const size_t column)
+	bool OdbcStatement::string_reader(const SQLLEN display_size, const size_t row_id, const size_t column)
 	{
-		SQLLEN display_size = 0;
-		// cerr << " try_read_string row_id = " << row_id << " column = " << column;
-		const auto r = SQLColAttribute(*_statement, column + 1, SQL_DESC_DISPLAY_SIZE, nullptr, 0, nullptr, &display_size);
-		if (!check_odbc_error(r))
-			return false;
-
 		// when a field type is LOB, we read a packet at time and pass that back.
 		if (display_size == 0 || display_size == numeric_limits<int>::max() ||
 			display_size == numeric_limits<int>::max() >> 1 ||
@@ -1836,15 +2376,160 @@ namespace mssql
 		return false;
 	}
 
+	// narrow columns fetched as SQL_C_CHAR come back in the client encoding, which is UTF-8
+	// for the linux and macos drivers, so a UTF-8 collated varchar is moved once with no UTF-16
+	// round trip. not selected on windows where the client encoding is the ANSI code page.
+	bool OdbcStatement::get_data_utf8(const size_t row_id, const size_t column)
+	{
+		const auto &statement = *_statement;
+		const auto &definition = _resultset->get_meta_data(static_cast<int>(column));
+		constexpr SQLLEN atomic_read = 24 * 1024;
+		const auto bounded = definition.displaySize >= 1 && definition.displaySize <= SQL_SERVER_MAX_STRING_SIZE;
+		const auto chunk = bounded ? definition.displaySize : atomic_read;
+		const auto storage = make_shared<DatumStorage>();
+		storage->ReserveChars(chunk + 1);
+		auto &char_data = *storage->charvec_ptr;
+		size_t total = 0;
+		auto more = true;
+		while (more)
+		{
+			char_data.resize(total + chunk + 1); // increment for null terminator
+			SQLLEN value_len = 0;
+			const auto r = get_data(statement, static_cast<SQLSMALLINT>(column + 1), SQL_C_CHAR, char_data.data() + total, chunk + 1, &value_len);
+			if (r == SQL_NO_DATA)
+			{
+				break;
+			}
+			if (!check_odbc_error(r))
+				return false;
+			if (value_len == SQL_NULL_DATA)
+			{
+				_resultset->add_column(row_id, make_shared<NullColumn>(column));
+				return true;
+			}
+			auto status = false;
+			more = check_more_read(r, status);
+			if (!status)
+			{
+				return false;
+			}
+			// a truncated read stops short of a sequence that would not fit, so count what
+			// was written up to the terminator rather than the whole chunk.
+			total += more || value_len < 0 || value_len > chunk
+				? strnlen(char_data.data() + total, static_cast<size_t>(chunk))
+				: value_len;
+		}
+		char_data.resize(total);
+		const auto &interner = _resultset->_interner;
+		if (bounded && interner && interner->active(column))
+		{
+			const auto hit = interner->find(column, char_data.data(), total);
+			if (hit)
+			{
+				_resultset->add_column(row_id, hit);
+				return true;
+			}
+			const auto value = make_shared<CharColumn>(column, storage->charvec_ptr, total);
+			interner->add(column, char_data.data(), total, value);
+			_resultset->add_column(row_id, value);
+			return true;
+		}
+		_resultset->add_column(row_id, make_shared<CharColumn>(column, storage->charvec_ptr, total));
+		return true;
+	}
+
+	// display size was captured in read_col_attributes when the result set opened.
+	bool OdbcStatement::read_string(const size_t row_id, const size_t column)
+	{
+		const auto &definition = _resultset->get_meta_data(static_cast<int>(column));
+		return string_reader(definition.displaySize, row_id, column);
+	}
+
+	// the walk the JS reader makes with nextResult, without coming back to the loop thread
+	// between results. an error from one statement of the entry is kept with the rest and the
+	// walk goes on while the driver has a result after it, as the reader does.
+	bool OdbcStatement::try_execute_steps(const shared_ptr<QueryOperationParams> &q, const shared_ptr<BoundDatumSet> &param_set, const step_t &step)
+	{
+		if (!_statement)
+			return false;
+		// nothing from an earlier use of the handle - an open cursor or its params - carries over.
+		const auto &statement = *_statement;
+		SQLFreeStmt(statement, SQL_CLOSE);
+		SQLFreeStmt(statement, SQL_RESET_PARAMS);
+		SQLSetStmtAttr(statement, SQL_ATTR_PARAMSET_SIZE, reinterpret_cast<SQLPOINTER>(1), 0);
+		_resultset = make_unique<ResultSet>(0);
+		_resultset->_end_of_rows = true;
+
+		auto opened = try_execute_direct(q, param_set) || !_resultset->_end_of_rows;
+		for (;;)
+		{
+			if (opened && _resultset->get_column_count() > 0)
+			{
+				_resultset->start_results();
+				fetch_read(numeric_limits<size_t>::max());
+				_stats->column_objects += _resultset->get_result_count() * _resultset->get_column_count();
+			}
+			const vector<shared_ptr<OdbcError>> raised(_errors->begin(), _errors->end());
+			_errors->clear();
+			if (!step(_resultset, raised))
+				break;
+			if (_cancelRequested)
+			{
+				cancelled();
+				const vector<shared_ptr<OdbcError>> cancel(_errors->begin(), _errors->end());
+				_errors->clear();
+				step(_resultset, cancel);
+				break;
+			}
+			const auto ret = SQLMoreResults(statement);
+			if (ret == SQL_NO_DATA)
+				break;
+			_resultset = make_unique<ResultSet>(0);
+			_resultset->_end_of_rows = true;
+			opened = false;
+			if (!SQL_SUCCEEDED(ret))
+			{
+				// the statement that failed is a step of its own, the ones after it follow. with
+				// nothing to say why, the link gone or the handle no longer executing there is
+				// nothing more to read.
+				return_odbc_error();
+				if (_errors->empty() || unreadable(*_errors))
+				{
+					step(_resultset, *_errors);
+					_errors->clear();
+					break;
+				}
+				continue;
+			}
+			if (ret == SQL_SUCCESS_WITH_INFO)
+			{
+				return_odbc_error();
+			}
+			opened = start_reading_results();
+		}
+		{
+			// finished inside the deadline.
+			lock_guard<recursive_mutex> lock(_cancel_mutex);
+			_deadlineToken = 0;
+		}
+		_endOfResults = true;
+		_resultset->_end_of_rows = true;
+		return true;
+	}
+
 	bool OdbcStatement::try_read_next_result()
 	{
 		// fprintf(stderr, "TryReadNextResult\n");
 		// fprintf(stderr, "TryReadNextResult ID = %llu\n ", get_statement_id());
+		if (_cancelRequested)
+		{
+			// fprintf(stderr, "TryReadNextResult - cancel mode.\n");
+			return cancelled();
+		}
 		const auto state = get_state();
 		if (state == OdbcStatementState::STATEMENT_CANCELLED || 
 			state == OdbcStatementState::STATEMENT_CANCEL_HANDLE)
 		{
-			// fprintf(stderr, "TryReadNextResult - cancel mode.\n");
 			_resultset->_end_of_rows = true;
 			_endOfResults = true;
 			set_state(OdbcStatementState::STATEMENT_ERROR);
@@ -1857,6 +2542,11 @@ namespace mssql
 		case SQL_NO_DATA:
 		{
 			// fprintf(stderr, "SQL_NO_DATA\n");
+			// finished inside the deadline.
+			{
+				lock_guard<recursive_mutex> lock(_cancel_mutex);
+				_deadlineToken = 0;
+			}
 			_endOfResults = true;
 			_resultset->_end_of_rows = true;
 			if (_prepared)
@@ -21,6 +21,9 @@
 
 #include <ResultSet.h>
 #include <CriticalSection.h>
+#include <atomic>
+#include <deque>
+#include <mutex>
 
 namespace mssql
 {
@@ -29,10 +32,12 @@ namespace mssql
 	class DatumStorage;
 	class QueryOperationParams;
 	class ConnectionHandles;
+	class DriverStats;
+	class TvpStream;
 
 	using namespace std;
 
-	class OdbcStatement
+	class OdbcStatement : public enable_shared_from_this<OdbcStatement>
 	{
 	public:
 		mutex _statement_mutex;
@@ -52,8 +57,9 @@ namespace mssql
 
 		bool created() { return  _statementState == OdbcStatementState::STATEMENT_CREATED; }
 		bool cancel();
+		void expire(uint64_t token);
 
-		OdbcStatement(long statement_id, shared_ptr<ConnectionHandles> c);
+		OdbcStatement(long statement_id, shared_ptr<ConnectionHandles> c, shared_ptr<DriverStats> stats);
 		virtual ~OdbcStatement();
 		SQLLEN get_row_count() const { return _resultset != nullptr ? _resultset->row_count() : -1; }
 		shared_ptr<ResultSet> get_result_set() const
@@ -77,11 +83,26 @@ namespace mssql
 		Local<Value> handle_end_of_results() const;
 		Local<Value> end_of_rows() const;
 		Local<Value> get_column_values() const;
+		// the rows of any result set as arrays of cells, converted as get_column_values does.
+		static Local<Array> rows_to_value(const ResultSet& result_set);
 		bool set_polling(bool mode);
-		bool get_polling();
+		bool get_polling() const;
 		void set_state(const OdbcStatement::OdbcStatementState state);
-		OdbcStatement::OdbcStatementState get_state();
+		OdbcStatement::OdbcStatementState get_state() const;
+		// move from -> to only if nothing else has moved the state first, a cancel
+		// arriving on another thread races the executing thread through this.
+		bool transition(OdbcStatement::OdbcStatementState from, OdbcStatement::OdbcStatementState to);
 		bool set_numeric_string(bool mode);
+		// decimal and numeric read as text whatever numeric_string says, so no digit is lost.
+		bool set_decimal_string(bool mode);
+		bool set_utf8_data(bool mode);
+		bool set_max_interned_strings(size_t cap);
+		bool set_prefetch_depth(size_t depth);
+		// from the isolate thread once a batch has been converted for JS - fetch up to the
+		// depth of further batches on the thread pool while JS works through this one.
+		void prefetch(size_t number_rows);
+		void pause_prefetch();
+		bool set_json_mode(bool reassemble, bool parse);
 
 		shared_ptr<vector<shared_ptr<OdbcError>>> errors(void) const
 		{
@@ -92,25 +113,51 @@ namespace mssql
 		bool bind_fetch(const shared_ptr<BoundDatumSet>& param_set);
 		bool try_bcp(const shared_ptr<BoundDatumSet>& param_set, int32_t version);
 		bool try_execute_direct(const shared_ptr<QueryOperationParams>& q, const shared_ptr<BoundDatumSet>& paramSet);
+		// a streamed tvp leaves the execute parked in SQLParamData until JS has pushed
+		// its last chunk, each chunk arrives bound as a set of its own.
+		bool awaiting_tvp_rows() const { return _tvpStream != nullptr; }
+		bool try_send_tvp_rows(const shared_ptr<BoundDatumSet>& chunk);
 		bool cancel_handle();
 		bool try_read_columns(size_t number_rows);
 		bool try_read_next_result();
+		// executed once, then every step the driver gives back - a result set read to its last
+		// row, a row count or the errors of a statement that failed - is handed to step in order
+		// with the messages it raised. step returns false to stop, the reading modes it sets
+		// apply to the steps after it.
+		typedef function<bool(const shared_ptr<ResultSet>&, const vector<shared_ptr<OdbcError>>&)> step_t;
+		bool try_execute_steps(const shared_ptr<QueryOperationParams>& q, const shared_ptr<BoundDatumSet>& param_set, const step_t& step);
+		// called before the handle is freed - once this returns no cancel can reach it. a batch
+		// being fetched ahead on the thread pool holds the statement, so this waits for it to
+		// finish with the handle, and any batch queued after finds no handle and ends.
 		void done() {
+			lock_guard<mutex> statement_lock(_statement_mutex);
+			lock_guard<recursive_mutex> lock(_cancel_mutex);
+			_deadlineToken = 0;
 			_statementState = OdbcStatementState::STATEMENT_CLOSED;
 			_statement = nullptr;
 		}
 
 	private:
+		// a reader is chosen per column when the result set opens, so the fetch loop
+		// calls straight through this table rather than switching on type for each cell.
+		typedef bool (OdbcStatement::*column_reader_t)(size_t row_id, size_t column);
+		column_reader_t select_reader(const ResultSet::ColumnDefinition& definition) const;
+		void build_readers();
+		template <typename T, SQLSMALLINT c_type, class TColumn, bool numeric> bool get_data_fixed(size_t row_id, size_t column);
+		bool read_string(size_t row_id, size_t column);
+		bool get_data_utf8(size_t row_id, size_t column);
+		bool string_reader(SQLLEN display_size, size_t row_id, size_t column);
+
 		bool fetch_read(const size_t number_rows);
+		bool fetch_json();
+		bool is_for_json() const;
+		bool append_wchars(size_t column, vector<uint16_t>& dest);
 		bool prepared_read();
 		SQLRETURN poll_check(SQLRETURN ret, shared_ptr<vector<uint16_t>> vec, const bool direct);
 		bool get_data_binary(size_t row_id, size_t column);
 		bool get_data_decimal(size_t row_id, size_t column);
 		bool get_data_numeric(size_t row_id, size_t column);
-		bool get_data_bit(size_t row_id, size_t column);
 		bool get_data_timestamp(size_t row_id, size_t column);
-		bool get_data_long(size_t row_id, size_t column);
-		bool get_data_big_int(size_t row_id, size_t column);
 		bool get_data_timestamp_offset(size_t row_id, size_t column);
 
 		bool start_reading_results();
@@ -131,19 +178,24 @@ namespace mssql
 		bool apply_precision(const shared_ptr<BoundDatum>& datum, int current_param);
 		bool read_col_attributes(ResultSet::ColumnDefinition& current, int column);
 		bool read_next(int column);
-		bool raise_cancel();
+		bool cancelled();
+		shared_ptr<OdbcError> cancel_error() const;
+		void signal_cancel() const;
 		bool check_more_read(SQLRETURN r, bool& status);
 		bool lob(size_t, size_t column);
-		static OdbcEnvironmentHandle environment;
-		bool dispatch(SQLSMALLINT t, size_t row, size_t column);
 		bool dispatch_prepared(const SQLSMALLINT t, const size_t column_size, const size_t rows_count, const size_t column) const;
 		typedef vector<shared_ptr<BoundDatum>> param_bindings;
 		typedef pair<int, shared_ptr<param_bindings>> tvp_t;
 		bool bind_tvp(vector<tvp_t>& tvps);
 		bool bind_datum(int current_param, const shared_ptr<BoundDatum>& datum);
 		bool bind_params(const shared_ptr<BoundDatumSet>& params);
+		bool stream_tvp(const shared_ptr<BoundDatum>& datum, const shared_ptr<param_bindings>& columns);
+		bool push_tvp_rows();
+		bool abandon_tvp_rows();
+		bool complete_execute(SQLRETURN ret, const shared_ptr<BoundDatumSet>& param_set);
 		void queue_tvp(int current_param, param_bindings::iterator& itr, shared_ptr<BoundDatum>& datum, vector <tvp_t>& tvps);
-		bool try_read_string(bool binary, size_t row_id, size_t column);
+		// SQLGetData, counted into the connection stats.
+		SQLRETURN get_data(SQLHSTMT statement, SQLUSMALLINT column, SQLSMALLINT c_type, SQLPOINTER target, SQLLEN buffer_length, SQLLEN* str_len_or_ind);
 
 		bool return_odbc_error();
 		bool check_odbc_error(SQLRETURN ret);
@@ -151,6 +203,7 @@ namespace mssql
 		shared_ptr<QueryOperationParams> _query;
 		shared_ptr<OdbcStatementHandle> _statement;
 		shared_ptr<ConnectionHandles> _connectionHandles;
+		shared_ptr<DriverStats> _stats;
 	
 		// any error that occurs when a Try* function returns false is stored here
 		// and may be retrieved via the Error function below.
@@ -160,20 +213,60 @@ namespace mssql
 		bool _endOfResults;
 		long _statementId;
 		bool _prepared;
-		bool _cancelRequested;
-		bool _pollingEnabled;
+		atomic<bool> _cancelRequested;
+		atomic<bool> _pollingEnabled;
 		bool _numericStringEnabled;
+		bool _decimalStringEnabled;
+		bool _utf8Enabled;
+		size_t _maxInternedStrings;
+		bool _jsonReassemble;
+		bool _jsonParse;
 
-		OdbcStatementState _statementState = OdbcStatementState::STATEMENT_CREATED;
+		// state and the two flags above are the only members another thread touches,
+		// everything else is owned by the operation currently executing on the statement.
+		atomic<OdbcStatementState> _statementState;
+		// set by the watchdog when the deadline passes, so the cancel reports as a timeout.
+		atomic<bool> _timedOut;
+		// the deadline armed for the current execute, 0 when none - a watchdog entry that no
+		// longer matches is ignored.
+		atomic<uint64_t> _deadlineToken;
+		// held by the cancelling thread across the token check and SQLCancelHandle, and by
+		// done() and the token writes, so a cancel never reaches a freed handle or a later execute.
+		mutable recursive_mutex _cancel_mutex;
 
 		// set binary true if a binary Buffer should be returned instead of a JS string
 
 		shared_ptr<ResultSet> _resultset;
+		vector<column_reader_t> _readers;
 		shared_ptr<BoundDatumSet> _boundParamsSet;
 		shared_ptr<BoundDatumSet> _preparedStorage;
+		shared_ptr<TvpStream> _tvpStream;
+
+		// batches fetched ahead of JS. the fetch runs under _statement_mutex like any operation,
+		// the queue and flags are also read from the isolate thread so have their own guard.
+		struct PrefetchBatch
+		{
+			vector<ResultSet::t_row> rows;
+			bool end_of_rows;
+			bool ok;
+		};
+		static void prefetch_background(uv_work_t* work);
+		static void prefetch_foreground(uv_work_t* work, int status);
+		void schedule_prefetch(size_t number_rows);
+		bool prefetch_batch(size_t number_rows, uint64_t generation);
+		bool take_prefetched(bool& res);
+		void reset_prefetch();
 
-		recursive_mutex g_i_mutex;
-		
+		size_t _prefetchDepth;
+		mutex _prefetchMutex;
+		deque<PrefetchBatch> _prefetched;
+		bool _prefetchRunning;
+		bool _prefetchEnded;
+		// set while a read's rows sit in the result set waiting to be converted.
+		bool _prefetchHeld;
+		// bumped per result set, a batch scheduled against an earlier one is dropped.
+		uint64_t _prefetchGeneration;
+		atomic<bool> _prefetchPaused;
 
 		const static size_t prepared_rows_to_bind = 50;
 	};
@@ -26,9 +26,10 @@ namespace mssql
 {
 	using namespace std;
 
-	OdbcStatementCache::OdbcStatementCache(const shared_ptr<ConnectionHandles>  connectionHandles) 
+	OdbcStatementCache::OdbcStatementCache(const shared_ptr<ConnectionHandles>  connectionHandles, const shared_ptr<DriverStats> stats) 
 		: 
-		_connectionHandles(connectionHandles)
+		_connectionHandles(connectionHandles),
+		_stats(stats)
 	{
 	}
 
@@ -39,6 +40,7 @@ namespace mssql
 	void OdbcStatementCache::clear()
 	{
 		// cerr << "OdbcStatementCache - size = " << statements.size() << endl;
+		lock_guard<mutex> lock(_statements_mutex);
 		vector<long> ids;
 		// fprintf(stderr, "destruct OdbcStatementCache\n");
 
@@ -48,12 +50,20 @@ namespace mssql
 
 		for_each(ids.begin(), ids.end(), [&](const long id) {
 			// cerr << "destruct OdbcStatementCache - erase statement" << id << endl;
+			// the handles are freed next, a cancel or deadline still holding the statement must not reach them.
+			statements[id]->done();
 			statements.erase(id);
 		});
 		_spent_statements.clear();
 	}
 
 	shared_ptr<OdbcStatement> OdbcStatementCache::find(const long statement_id)
+	{
+		lock_guard<mutex> lock(_statements_mutex);
+		return find_locked(statement_id);
+	}
+
+	shared_ptr<OdbcStatement> OdbcStatementCache::find_locked(const long statement_id)
 	{
 		shared_ptr<OdbcStatement> statement = nullptr;
 		const auto itr = statements.find(statement_id);
@@ -76,17 +86,19 @@ namespace mssql
 			//fprintf(stderr, "dont fetch id %ld\n", statementId);
 			return nullptr;
 		}
+		lock_guard<mutex> lock(_statements_mutex);
 		if (_spent_statements.find(statement_id) != _spent_statements.end()) {
 			return nullptr;
 		}
-		if (auto statement = find(statement_id)) return statement;
-		return store(make_shared<OdbcStatement>(statement_id, _connectionHandles));
+		if (auto statement = find_locked(statement_id)) return statement;
+		return store(make_shared<OdbcStatement>(statement_id, _connectionHandles, _stats));
 	}
 
 	void OdbcStatementCache::checkin(const long statement_id)
 	{
 		if (statement_id < 0) return;
-		const auto statement = find(statement_id);
+		lock_guard<mutex> lock(_statements_mutex);
+		const auto statement = find_locked(statement_id);
 		if (statement != nullptr) {
 			statement->done();
 		    // cerr << "checkin  " << statement_id << endl;
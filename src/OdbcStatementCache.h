@@ -22,6 +22,7 @@
 #include "stdafx.h"
 #include <map>
 #include <unordered_set>
+#include <mutex>
 #include <OdbcConnection.h>
 
 namespace mssql
@@ -34,15 +35,16 @@ namespace mssql
 	class OdbcStatementCache
 	{
 	public:		
-		OdbcStatementCache(const shared_ptr<ConnectionHandles> connectionHandles);
+		OdbcStatementCache(const shared_ptr<ConnectionHandles> connectionHandles, const shared_ptr<DriverStats> stats);
 		~OdbcStatementCache();
 		shared_ptr<OdbcStatement> checkout(long statement_id);
 		void checkin(long statement_id);
 		size_t size() const { return statements.size(); } 
 		void clear();
+		// unlike checkout, an unknown id gives nullptr rather than a new statement.
+		shared_ptr<OdbcStatement> find(long statement_id);
 
 	private:
-		shared_ptr<OdbcStatement> find(long statement_id);
 		shared_ptr<OdbcStatement> store(shared_ptr<OdbcStatement> statement);
 
 		typedef map<long, shared_ptr<OdbcStatement>> map_statements_t;
@@ -50,6 +52,11 @@ namespace mssql
 
 		map_statements_t statements;
 		shared_ptr<ConnectionHandles> _connectionHandles;
+		shared_ptr<DriverStats> _stats;
 		set_ids_t _spent_statements;
+		// statements are checked out on the js thread and checked in on a worker, which
+		// with pipelining can overlap other statements of the same connection.
+		mutex _statements_mutex;
+		shared_ptr<OdbcStatement> find_locked(long statement_id);
 	};
 }
@@ -44,6 +44,7 @@ namespace mssql
 		virtual ~OpenOperation(void);
 		bool TryInvokeOdbc() override;
 		Local<Value> CreateCompletionArg() override;
+		OperationKind kind() const override { return OperationKind::Open; }
 	};
 }
 
@@ -43,6 +43,7 @@ namespace mssql
 		bool TryInvokeOdbc() override;
 
 		Local<Value> CreateCompletionArg() override;
+		OperationKind kind() const override { return OperationKind::PollingMode; }
 	};
 }
 
@@ -32,6 +32,7 @@ namespace mssql
 	{
 	public:
 		bool TryInvokeOdbc() override;
+		OperationKind kind() const override { return OperationKind::Prepare; }
 		PrepareOperation(const shared_ptr<OdbcConnection> &connection, const shared_ptr<QueryOperationParams> &query, Local<Object> callback);
 	};
 }
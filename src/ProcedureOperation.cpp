@@ -19,6 +19,7 @@ namespace mssql
 		_statement = _connection->getStatamentCache()->checkout(_statementId);
 		if (!_statement) return false;
 		_statement->set_polling(_query->polling());
+		_statement->set_utf8_data(_query->utf8_data());
 		return _statement->try_execute_direct(_query, _params);
 	}
 
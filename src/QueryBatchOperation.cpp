@@ -0,0 +1,349 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: QueryBatchOperation.cpp
+// Contents: send a batch of statements in one round trip and read all of their results
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include <OdbcConnection.h>
+#include <OdbcStatement.h>
+#include <OdbcStatementCache.h>
+#include <QueryBatchOperation.h>
+#include <QueryOperationParams.h>
+#include <BoundDatumSet.h>
+#include <BoundDatum.h>
+#include <OdbcError.h>
+
+namespace mssql
+{
+	// selected after each entry, the column name is what marks it.
+	static const char batch_marker[] = "__msnodesql_batch_entry";
+
+	// a cancel or deadline is consumed by the entry it lands in, the batch must not carry on past it.
+	static bool stopped(const vector<shared_ptr<OdbcError>> &errors)
+	{
+		for (const auto &e : errors)
+		{
+			const string state(e->SqlState());
+			if (state == "HY008" || state == "HYT00" || state == "U00000") return true;
+		}
+		return false;
+	}
+
+	static bool is_marker(const ResultSet &result)
+	{
+		if (result.get_column_count() != 1) return false;
+		const auto &name = result.get_meta_data(0).name;
+		const auto len = sizeof(batch_marker) - 1;
+		if (name.size() != len) return false;
+		for (size_t i = 0; i < len; ++i)
+		{
+			if (name[i] != static_cast<SQLWCHAR>(batch_marker[i])) return false;
+		}
+		return true;
+	}
+
+	static void append(vector<uint16_t> &text, const string &s)
+	{
+		text.insert(text.end(), s.begin(), s.end());
+	}
+
+	// the entry as the body of an N'' literal with its ? markers renamed @p1, @p2 ... in order.
+	// a ? inside a string, a quoted or bracketed name or a comment is not a marker and is
+	// copied as it is. returns the number of markers.
+	static size_t quote_entry(const vector<uint16_t> &sql, vector<uint16_t> &text)
+	{
+		const auto put = [&](const uint16_t c)
+		{
+			text.push_back(c);
+			if (c == '\'') text.push_back(c);
+		};
+		const auto n = sql.size();
+		const auto at = [&](const size_t i, const char c) { return i < n && sql[i] == c; };
+		size_t markers = 0;
+		size_t i = 0;
+		while (i < n)
+		{
+			const auto c = sql[i];
+			if (c == '\'' || c == '"' || c == '[')
+			{
+				const char close = c == '[' ? ']' : static_cast<char>(c);
+				put(sql[i++]);
+				while (i < n)
+				{
+					const auto d = sql[i++];
+					put(d);
+					if (d != close) continue;
+					// doubled, the close is part of the text.
+					if (!at(i, close)) break;
+					put(sql[i++]);
+				}
+			}
+			else if (c == '-' && at(i + 1, '-'))
+			{
+				while (i < n && sql[i] != '\n') put(sql[i++]);
+			}
+			else if (c == '/' && at(i + 1, '*'))
+			{
+				// block comments nest in t-sql.
+				size_t depth = 0;
+				while (i < n)
+				{
+					if (sql[i] == '/' && at(i + 1, '*'))
+					{
+						++depth;
+						put(sql[i++]);
+					}
+					else if (sql[i] == '*' && at(i + 1, '/'))
+					{
+						put(sql[i++]);
+						put(sql[i++]);
+						if (--depth == 0) break;
+						continue;
+					}
+					put(sql[i++]);
+				}
+			}
+			else if (c == '?')
+			{
+				append(text, "@p" + to_string(++markers));
+				++i;
+			}
+			else
+			{
+				put(sql[i++]);
+			}
+		}
+		return markers;
+	}
+
+	// what sp_executesql is told a param is - wide enough for any value the driver binds as
+	// that sql type, the server converting the bound value as it would for a column.
+	static bool declared_type(const BoundDatum &d, string &type)
+	{
+		switch (d.sql_type)
+		{
+		case SQL_BIT: type = "bit"; break;
+		case SQL_TINYINT: type = "tinyint"; break;
+		case SQL_SMALLINT: type = "smallint"; break;
+		case SQL_INTEGER: type = "int"; break;
+		case SQL_BIGINT: type = "bigint"; break;
+		case SQL_REAL: type = "real"; break;
+		case SQL_FLOAT:
+		case SQL_DOUBLE: type = "float"; break;
+		case SQL_NUMERIC:
+		case SQL_DECIMAL: type = "decimal(38, " + to_string(min(max(static_cast<int>(d.digits), 0), 38)) + ")"; break;
+		case SQL_CHAR:
+		case SQL_VARCHAR:
+		case SQL_LONGVARCHAR: type = "varchar(max)"; break;
+		case SQL_WCHAR:
+		case SQL_WVARCHAR:
+		case SQL_WLONGVARCHAR: type = "nvarchar(max)"; break;
+		case SQL_BINARY:
+		case SQL_VARBINARY:
+		case SQL_LONGVARBINARY: type = "varbinary(max)"; break;
+		case SQL_TYPE_DATE: type = "date"; break;
+		case SQL_SS_TIME2: type = "time(7)"; break;
+		case SQL_TYPE_TIMESTAMP: type = "datetime2(7)"; break;
+		case SQL_SS_TIMESTAMPOFFSET: type = "datetimeoffset(7)"; break;
+		case SQL_GUID: type = "uniqueidentifier"; break;
+		case SQL_SS_XML: type = "xml"; break;
+		case SQL_SS_VARIANT: type = "sql_variant"; break;
+		default: return false;
+		}
+		return true;
+	}
+
+	QueryBatchOperation::QueryBatchOperation(const shared_ptr<OdbcConnection> &connection, const size_t query_id, const Local<Object> callback)
+		: OdbcOperation(connection, query_id, callback),
+		_bound(make_shared<BoundDatumSet>())
+	{
+	}
+
+	void QueryBatchOperation::add_entries(const Local<Number> query_id, const Local<Array> entries)
+	{
+		const auto query_key = Nan::New("query").ToLocalChecked();
+		const auto params_key = Nan::New("params").ToLocalChecked();
+		auto text = make_shared<vector<uint16_t>>();
+		for (uint32_t i = 0; i < entries->Length(); ++i)
+		{
+			const auto e = Nan::To<Object>(Nan::Get(entries, i).ToLocalChecked()).ToLocalChecked();
+			const auto query_object = Nan::To<Object>(Nan::Get(e, query_key).ToLocalChecked()).ToLocalChecked();
+			auto params = Nan::Get(e, params_key).ToLocalChecked().As<Array>();
+			entry added;
+			added.query = make_shared<QueryOperationParams>(query_id, query_object);
+			added.params = make_shared<BoundDatumSet>();
+			added.errors = make_shared<vector<shared_ptr<OdbcError>>>();
+			if (!_batch)
+			{
+				// the timeout and deadline are the batch's, taken from the first entry.
+				_batch = make_shared<QueryOperationParams>(query_id, query_object);
+			}
+			if (!added.params->bind(params))
+			{
+				stringstream message;
+				message << "[msnodesql] Parameter " << added.params->first_error + 1 << ": " << added.params->err;
+				added.errors->push_back(make_shared<OdbcError>("IMNOD", message.str().c_str(), -1, 0, "", "", 0));
+				added.params = nullptr;
+			}
+			else if (add_to_batch(added, *text))
+			{
+				_sent.push_back(_entries.size());
+			}
+			_entries.push_back(std::move(added));
+		}
+		if (_batch)
+		{
+			_batch->set_query_string(text);
+		}
+	}
+
+	// exec sp_executesql N'<entry>', N'@p1 int, ...', ?, ... then the marker - the entry's
+	// params become params of the batch, bound to the ? passed on for each.
+	bool QueryBatchOperation::add_to_batch(entry &e, vector<uint16_t> &text)
+	{
+		auto &params = *e.params;
+		string declared;
+		for (size_t p = 0; p < params.size(); ++p)
+		{
+			auto &datum = *params.atIndex(static_cast<int>(p));
+			string type;
+			const char *refused = nullptr;
+			if (datum.is_tvp || datum.param_type != SQL_PARAM_INPUT || datum.get_ind_vec().size() > 1)
+			{
+				refused = "table valued, output and array parameters cannot be sent in a batch";
+			}
+			else if (!declared_type(datum, type))
+			{
+				refused = "the type of this parameter cannot be sent in a batch";
+			}
+			if (refused)
+			{
+				stringstream message;
+				message << "[msnodesql] Parameter " << p + 1 << ": " << refused;
+				e.errors->push_back(make_shared<OdbcError>("IMNOD", message.str().c_str(), -1, 0, "", "", 0));
+				return false;
+			}
+			declared += (p == 0 ? "@p" : ", @p") + to_string(p + 1) + " " + type;
+		}
+		vector<uint16_t> quoted;
+		const auto markers = quote_entry(*e.query->query_string(), quoted);
+		if (markers != params.size())
+		{
+			stringstream message;
+			message << "[msnodesql] the statement has " << markers << " parameter markers but " << params.size() << " parameters were given";
+			e.errors->push_back(make_shared<OdbcError>("IMNOD", message.str().c_str(), -1, 0, "", "", 0));
+			return false;
+		}
+		append(text, "exec sp_executesql N'");
+		text.insert(text.end(), quoted.begin(), quoted.end());
+		append(text, "'");
+		if (params.size() > 0)
+		{
+			append(text, ", N'" + declared + "'");
+			for (size_t p = 0; p < params.size(); ++p)
+			{
+				append(text, ", ?");
+				_bound->push_back(params.atIndex(static_cast<int>(p)));
+			}
+		}
+		append(text, ";\nselect 0 as [" + string(batch_marker) + "];\n");
+		return true;
+	}
+
+	// the reading modes are the entry's own, set before its first result opens.
+	void QueryBatchOperation::use_modes(const entry &e) const
+	{
+		const auto &q = e.query;
+		_statement->set_numeric_string(q->numeric_string());
+		_statement->set_decimal_string(q->decimal_string());
+		_statement->set_utf8_data(q->utf8_data());
+		_statement->set_max_interned_strings(q->max_interned_strings());
+	}
+
+	bool QueryBatchOperation::TryInvokeOdbc()
+	{
+		_statement = _connection->getStatamentCache()->checkout(_statementId);
+		if (!_statement) return false;
+		if (_sent.empty()) return true;
+		// rows are read whole and converted once the batch is done, none of the reading
+		// modes that hand rows back a batch at a time apply. the results are walked in this
+		// one call rather than polled, a cancel reaches it through the handle.
+		_statement->set_prefetch_depth(0);
+		_statement->set_json_mode(false, false);
+		_statement->set_polling(false);
+		use_modes(_entries[_sent[0]]);
+		size_t current = 0;
+		_statement->try_execute_steps(_batch, _bound, [&](const shared_ptr<ResultSet> &result, const vector<shared_ptr<OdbcError>> &raised)
+		{
+			if (current == _sent.size()) return true;
+			auto &e = _entries[_sent[current]];
+			e.errors->insert(e.errors->end(), raised.begin(), raised.end());
+			if (is_marker(*result))
+			{
+				if (++current < _sent.size()) use_modes(_entries[_sent[current]]);
+				return true;
+			}
+			e.results.push_back(result);
+			return !stopped(raised);
+		});
+		// the entry running when the batch stopped has what stopped it, unless the server
+		// gave no reason. those after it never ran.
+		for (auto k = current; k < _sent.size(); ++k)
+		{
+			auto &e = _entries[_sent[k]];
+			if (k == current && !e.errors->empty()) continue;
+			e.errors->push_back(make_shared<OdbcError>("IMNOD", "[msnodesql] batch stopped before this statement ran", -1, 0, "", "", 0));
+		}
+		return true;
+	}
+
+	// [{ results: [{ meta, rows, rowcount } or { rowcount }], errors }] in entry order.
+	Local<Value> QueryBatchOperation::CreateCompletionArg()
+	{
+		const nodeTypeFactory fact;
+		const auto res = fact.new_array(static_cast<int>(_entries.size()));
+		const auto results_key = Nan::New("results").ToLocalChecked();
+		const auto errors_key = Nan::New("errors").ToLocalChecked();
+		const auto meta_key = Nan::New("meta").ToLocalChecked();
+		const auto rows_key = Nan::New("rows").ToLocalChecked();
+		const auto rowcount_key = Nan::New("rowcount").ToLocalChecked();
+		for (size_t i = 0; i < _entries.size(); ++i)
+		{
+			auto &e = _entries[i];
+			const auto results = fact.new_array(static_cast<int>(e.results.size()));
+			for (size_t r = 0; r < e.results.size(); ++r)
+			{
+				const auto &result_set = e.results[r];
+				const auto result = Nan::New<Object>();
+				if (result_set->get_column_count() > 0)
+				{
+					Nan::Set(result, meta_key, result_set->meta_to_value());
+					Nan::Set(result, rows_key, OdbcStatement::rows_to_value(*result_set));
+				}
+				Nan::Set(result, rowcount_key, Nan::New<Number>(static_cast<double>(result_set->row_count())));
+				Nan::Set(results, static_cast<uint32_t>(r), result);
+			}
+			const auto value = Nan::New<Object>();
+			Nan::Set(value, results_key, results);
+			Nan::Set(value, errors_key, errors_to_value(*e.errors));
+			Nan::Set(res, static_cast<uint32_t>(i), value);
+			// the rows are JS values now, the columns they were read into can go.
+			e.results.clear();
+		}
+		return res;
+	}
+}
@@ -0,0 +1,69 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: QueryBatchOperation.h
+// Contents: send a batch of statements in one round trip and read all of their results
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <OdbcOperation.h>
+#include <ResultSet.h>
+
+namespace mssql
+{
+	using namespace std;
+	using namespace v8;
+
+	class OdbcConnection;
+	class OdbcError;
+	class BoundDatumSet;
+	class QueryOperationParams;
+
+	// the entries go to the server as one batch in a single round trip, each wrapped in its own
+	// sp_executesql so it is parsed as a batch of its own and nothing declared or created in
+	// one is seen by another. a marker result set follows each, which is how the results and
+	// errors read back are handed to the entry that gave them. an entry that fails does not
+	// stop the ones after it unless the server aborts the batch, a cancel stops them all.
+	class QueryBatchOperation : public OdbcOperation
+	{
+		struct entry
+		{
+			shared_ptr<QueryOperationParams> query;
+			shared_ptr<BoundDatumSet> params;
+			vector<shared_ptr<ResultSet>> results;
+			shared_ptr<vector<shared_ptr<OdbcError>>> errors;
+		};
+
+		vector<entry> _entries;
+		// the one statement sent - every entry that bound, in order, with all of their params.
+		shared_ptr<QueryOperationParams> _batch;
+		shared_ptr<BoundDatumSet> _bound;
+		vector<size_t> _sent;
+
+		bool add_to_batch(entry &e, vector<uint16_t> &text);
+		void use_modes(const entry &e) const;
+
+	public:
+
+		QueryBatchOperation(const shared_ptr<OdbcConnection>& connection, size_t query_id, Local<Object> callback);
+		// each of { query, params } - a param that will not bind, or cannot be passed on through
+		// sp_executesql, is that entry's error and the entry is left out of the batch.
+		void add_entries(Local<Number> query_id, Local<Array> entries);
+		bool TryInvokeOdbc() override;
+		Local<Value> CreateCompletionArg() override;
+		OperationKind kind() const override { return OperationKind::QueryBatch; }
+	};
+}
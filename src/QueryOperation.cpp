@@ -66,6 +66,11 @@ namespace mssql
 		if (!_statement) return false;
 		_statement->set_polling(_query->polling());
 		_statement->set_numeric_string(_query->numeric_string());
+		_statement->set_decimal_string(_query->decimal_string());
+		_statement->set_utf8_data(_query->utf8_data());
+		_statement->set_max_interned_strings(_query->max_interned_strings());
+		_statement->set_prefetch_depth(_query->prefetch_depth());
+		_statement->set_json_mode(_query->json_reassemble(), _query->json_parse());
 		const auto res = _statement->try_execute_direct(_query, _params);
 		return res;
 	}
@@ -43,6 +43,7 @@ namespace mssql
 		bool parameter_error_to_user_callback(uint32_t param, const char* error) const;
 		bool TryInvokeOdbc() override;
 		Local<Value> CreateCompletionArg() override;
+		OperationKind kind() const override { return OperationKind::Query; }
 		virtual ~QueryOperation();
 	protected:
 		shared_ptr<QueryOperationParams> _query;
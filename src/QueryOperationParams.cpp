@@ -10,19 +10,35 @@ namespace mssql
 /*
 shared_ptr<vector<uint16_t>> _query_string;
 		int32_t _timeout;
+		int64_t _deadline_ms;
 		int32_t _query_tz_adjustment;
 		int64_t _id;
 		size_t _max_prepared_column_size;
+		size_t _max_interned_strings;
+		size_t _prefetch_depth;
 		bool _numeric_string;
+		bool _decimal_string;
+		bool _utf8_data;
+		bool _json_reassemble;
+		bool _json_parse;
+		bool _local_dates;
 		bool _polling;
 */
 	QueryOperationParams::QueryOperationParams(const Local<Number> query_id, 
 		const Local<Object> query_object) :
 		_timeout(MutateJS::getint32(query_object, "query_timeout")),
+		_deadline_ms(MutateJS::getint64(query_object, "query_deadline_ms")),
 		_query_tz_adjustment(0),
 		_id(MutateJS::getint32(query_id)),
 		_max_prepared_column_size(MutateJS::getint64(query_object, "max_prepared_column_size")),
+		_max_interned_strings(MutateJS::getint64(query_object, "max_interned_strings")),
+		_prefetch_depth(MutateJS::getint64(query_object, "prefetch_depth")),
 		_numeric_string(MutateJS::getbool(query_object, "numeric_string")),
+		_decimal_string(MutateJS::getbool(query_object, "decimal_string")),
+		_utf8_data(MutateJS::getbool(query_object, "utf8_data")),
+		_json_reassemble(MutateJS::getbool(query_object, "json_reassemble")),
+		_json_parse(MutateJS::getbool(query_object, "json_parse")),
+		_local_dates(MutateJS::getbool(query_object, "local_dates")),
 		_polling(MutateJS::getbool(query_object, "query_polling"))
 	{
 		const auto qs = Nan::Get(query_object, Nan::New("query_str").ToLocalChecked()).ToLocalChecked();
@@ -11,21 +11,38 @@ namespace mssql
 	{
 	public:
 		shared_ptr<vector<uint16_t>> query_string() { return _query_string; }
+		void set_query_string(const shared_ptr<vector<uint16_t>> &query_string) { _query_string = query_string; }
 		int64_t id() { return _id; }
 		int32_t timeout() { return _timeout; }
+		int64_t deadline_ms() { return _deadline_ms; }
 		int32_t query_tz_adjustment() { return _query_tz_adjustment; }
 		size_t max_prepared_column_size() { return _max_prepared_column_size; }
+		size_t max_interned_strings() { return _max_interned_strings; }
+		size_t prefetch_depth() { return _prefetch_depth; }
 		bool polling() { return _polling; }
 		bool numeric_string() { return _numeric_string; }
+		bool decimal_string() { return _decimal_string; }
+		bool utf8_data() { return _utf8_data; }
+		bool json_reassemble() { return _json_reassemble || _json_parse; }
+		bool json_parse() { return _json_parse; }
+		bool local_dates() { return _local_dates; }
 	
 		QueryOperationParams(Local<Number> query_id, Local<Object> query_object);
 	private:
 		shared_ptr<vector<uint16_t>> _query_string;
 		int32_t _timeout;
+		int64_t _deadline_ms;
 		int32_t _query_tz_adjustment;
 		int64_t _id;
 		size_t _max_prepared_column_size;
+		size_t _max_interned_strings;
+		size_t _prefetch_depth;
 		bool _numeric_string;
+		bool _decimal_string;
+		bool _utf8_data;
+		bool _json_reassemble;
+		bool _json_parse;
+		bool _local_dates;
 		bool _polling;
 	};
 }
@@ -41,6 +41,7 @@ namespace mssql
 		bool parameter_error_to_user_callback(uint32_t param, const char* error) const;
 		bool TryInvokeOdbc() override;
 		Local<Value> CreateCompletionArg() override;
+		OperationKind kind() const override { return OperationKind::QueryPrepared; }
 
 	protected:
 	
@@ -0,0 +1,51 @@
+#include "stdafx.h"
+#include <OdbcStatement.h>
+#include <ReadArrowOperation.h>
+#include <Arrow.h>
+#include <OdbcError.h>
+
+namespace mssql
+{
+	bool ReadArrowOperation::TryInvokeOdbc()
+	{
+		if (!_statement) return false;
+		if (!_statement->try_read_columns(_number_rows)) return false;
+		_buffer = make_unique<vector<uint8_t>>();
+		string error;
+		const auto result_set = _statement->get_result_set();
+		// the last batch of the result set closes the stream.
+		if (!arrow::encode(*result_set, _with_schema, result_set->EndOfRows(), *_buffer, error))
+		{
+			_buffer = nullptr;
+			_statement->errors()->push_back(make_shared<OdbcError>("IMNOD", error.c_str(), -1, 0, "", "", 0));
+			return false;
+		}
+		return true;
+	}
+
+	static void release_buffer(char*, void* hint)
+	{
+		delete static_cast<vector<uint8_t>*>(hint);
+	}
+
+	Local<Value> ReadArrowOperation::CreateCompletionArg()
+	{
+		const auto result = Nan::New<Object>();
+		Nan::Set(result, Nan::New("end_rows").ToLocalChecked(), _statement->end_of_rows());
+		auto* const buffer = _buffer.release();
+		// the encoded vector backs the Buffer and is freed with it.
+		const auto arrow = Nan::NewBuffer(reinterpret_cast<char*>(buffer->data()), buffer->size(), release_buffer, buffer);
+		Local<Object> bytes;
+		if (arrow.ToLocal(&bytes))
+		{
+			Nan::Set(result, Nan::New("arrow").ToLocalChecked(), bytes);
+		}
+		else
+		{
+			delete buffer;
+		}
+		// the batch was encoded on the worker, the result set is free for the next one.
+		_statement->prefetch(_number_rows);
+		return result;
+	}
+}
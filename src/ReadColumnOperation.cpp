@@ -12,6 +12,8 @@ namespace mssql
 
 	Local<Value> ReadColumnOperation::CreateCompletionArg()
 	{
-		return _statement->get_column_values();
+		const auto values = _statement->get_column_values();
+		_statement->prefetch(_number_rows);
+		return values;
 	}
 }
@@ -0,0 +1,60 @@
+#include "stdafx.h"
+#include <OdbcStatement.h>
+#include <ReadColumnarOperation.h>
+#include <Columnar.h>
+#include <OdbcError.h>
+#include <cstring>
+
+namespace mssql
+{
+	bool ReadColumnarOperation::TryInvokeOdbc()
+	{
+		if (!_statement) return false;
+		if (!_statement->try_read_columns(_number_rows)) return false;
+		_buffer = make_unique<vector<uint8_t>>();
+		string error;
+		if (!columnar::encode(*_statement->get_result_set(), *_buffer, error))
+		{
+			_buffer = nullptr;
+			_statement->errors()->push_back(make_shared<OdbcError>("IMNOD", error.c_str(), -1, 0, "", "", 0));
+			return false;
+		}
+		return true;
+	}
+
+	static void release_buffer(void*, size_t, void* deleter_data)
+	{
+		delete static_cast<vector<uint8_t>*>(deleter_data);
+	}
+
+	Local<Value> ReadColumnarOperation::CreateCompletionArg()
+	{
+		const auto result = Nan::New<Object>();
+		Nan::Set(result, Nan::New("end_rows").ToLocalChecked(), _statement->end_of_rows());
+		auto* const isolate = Isolate::GetCurrent();
+		auto* const buffer = _buffer.release();
+		Local<Value> columnar;
+#if V8_MAJOR_VERSION >= 8
+		// the encoded vector becomes the backing store, V8 frees it with the buffer.
+		if (_shared)
+		{
+			auto store = SharedArrayBuffer::NewBackingStore(buffer->data(), buffer->size(), release_buffer, buffer);
+			columnar = SharedArrayBuffer::New(isolate, std::move(store));
+		}
+		else
+		{
+			auto store = ArrayBuffer::NewBackingStore(buffer->data(), buffer->size(), release_buffer, buffer);
+			columnar = ArrayBuffer::New(isolate, std::move(store));
+		}
+#else
+		const auto ab = ArrayBuffer::New(isolate, buffer->size());
+		memcpy(ab->GetContents().Data(), buffer->data(), buffer->size());
+		delete buffer;
+		columnar = ab;
+#endif
+		Nan::Set(result, Nan::New("columnar").ToLocalChecked(), columnar);
+		// the batch was encoded on the worker, the result set is free for the next one.
+		_statement->prefetch(_number_rows);
+		return result;
+	}
+}
@@ -0,0 +1,52 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: ReadColumnarOperation.h
+// Contents: fetch a batch of rows and hand it back as one columnar buffer
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <OdbcOperation.h>
+
+namespace mssql
+{
+	using namespace std;
+	using namespace v8;
+
+	class OdbcConnection;
+
+	class ReadColumnarOperation : public OdbcOperation
+	{
+		int _number_rows;
+		bool _shared;
+		unique_ptr<vector<uint8_t>> _buffer;
+
+	public:
+
+		ReadColumnarOperation(shared_ptr<OdbcConnection> connection, size_t queryId, int number_rows, bool shared, Local<Object> callback)
+			: OdbcOperation(connection, callback),
+			_number_rows(number_rows),
+			_shared(shared)
+		{
+			_statementId = queryId;
+		}
+
+		bool TryInvokeOdbc() override;
+
+		Local<Value> CreateCompletionArg() override;
+		OperationKind kind() const override { return OperationKind::ReadColumnar; }
+	};
+}
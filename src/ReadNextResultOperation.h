@@ -40,6 +40,7 @@ namespace mssql
 		bool TryInvokeOdbc() override;
 
 		Local<Value> CreateCompletionArg() override;
+		OperationKind kind() const override { return OperationKind::ReadNextResult; }
 		SQLLEN preRowCount;
 		SQLLEN postRowCount;
 	};
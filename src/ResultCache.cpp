@@ -0,0 +1,264 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: ResultCache.cpp
+// Contents: byte bounded LRU of encoded query results held outside the V8 heap
+//
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include <ResultCache.h>
+#include <MutateJS.h>
+
+namespace mssql
+{
+	using namespace v8;
+
+	static string to_string(const Local<Value>& v)
+	{
+		const Nan::Utf8String s(v);
+		return string(*s, static_cast<size_t>(s.length()));
+	}
+
+	static void release_batch(void*, size_t, void* deleter_data)
+	{
+		delete static_cast<shared_ptr<vector<uint8_t>>*>(deleter_data);
+	}
+
+	// the ArrayBuffer holds its own reference to the batch, which outlives the entry if
+	// it is evicted while JS still has the buffer.
+	static Local<Value> batch_buffer(const shared_ptr<vector<uint8_t>>& batch)
+	{
+		auto* const isolate = Isolate::GetCurrent();
+#if V8_MAJOR_VERSION >= 8
+		auto* const held = new shared_ptr<vector<uint8_t>>(batch);
+		auto store = ArrayBuffer::NewBackingStore(batch->data(), batch->size(), release_batch, held);
+		return ArrayBuffer::New(isolate, std::move(store));
+#else
+		const auto ab = ArrayBuffer::New(isolate, batch->size());
+		memcpy(ab->GetContents().Data(), batch->data(), batch->size());
+		return ab;
+#endif
+	}
+
+	ResultCache::ResultCache(const size_t max_bytes)
+		: _max_bytes(max_bytes)
+	{
+	}
+
+	ResultCache::~ResultCache()
+	{
+	}
+
+	void ResultCache::erase(const lru_list::iterator it)
+	{
+		for (const auto& tag : it->tags)
+		{
+			const auto t = _tags.find(tag);
+			if (t == _tags.end()) continue;
+			t->second.erase(it->key);
+			if (t->second.empty()) _tags.erase(t);
+		}
+		_bytes -= it->bytes;
+		_index.erase(it->key);
+		_lru.erase(it);
+	}
+
+	void ResultCache::evict_to(const size_t bytes)
+	{
+		while (_bytes > bytes && !_lru.empty())
+		{
+			erase(prev(_lru.end()));
+			++_evictions;
+		}
+	}
+
+	void ResultCache::Init(Local<Object> exports)
+	{
+		Nan::HandleScope scope;
+		const auto name = Nan::New("ResultCache").ToLocalChecked();
+		auto tpl = Nan::New<FunctionTemplate>(New);
+		tpl->SetClassName(name);
+		tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+		Nan::SetPrototypeMethod(tpl, "put", put);
+		Nan::SetPrototypeMethod(tpl, "get", get);
+		Nan::SetPrototypeMethod(tpl, "invalidate", invalidate);
+		Nan::SetPrototypeMethod(tpl, "invalidateTag", invalidate_tag);
+		Nan::SetPrototypeMethod(tpl, "clear", clear);
+		Nan::SetPrototypeMethod(tpl, "getStats", get_stats);
+
+		Nan::Set(exports, name, Nan::GetFunction(tpl).ToLocalChecked());
+	}
+
+	void ResultCache::New(NanCb info)
+	{
+		if (!info.IsConstructCall())
+		{
+			const nodeTypeFactory fact;
+			fact.throwError("ResultCache must be constructed with new");
+			return;
+		}
+		const auto max_bytes = MutateJS::getint64(info[0].As<Number>());
+		auto* obj = new ResultCache(static_cast<size_t>(max_bytes > 0 ? max_bytes : 0));
+		obj->Wrap(info.This());
+		info.GetReturnValue().Set(info.This());
+	}
+
+	// put(key, ttl_ms, tags, info, batches) - info is opaque to the cache (the JS side keeps
+	// the metadata there), each batch a Buffer copied in. false if the entry alone would
+	// not fit, in which case any older entry under the key is still dropped.
+	void ResultCache::put(NanCb info)
+	{
+		auto* const cache = Unwrap<ResultCache>(info.This());
+		const auto key = to_string(info[0]);
+		const auto ttl_ms = MutateJS::getint64(info[1].As<Number>());
+		const auto tags = info[2].As<Array>();
+		const auto batches = info[4].As<Array>();
+
+		const auto existing = cache->_index.find(key);
+		if (existing != cache->_index.end())
+		{
+			cache->erase(existing->second);
+		}
+
+		entry e;
+		e.key = key;
+		e.info = to_string(info[3]);
+		e.expires = clock::now() + chrono::milliseconds(ttl_ms);
+		e.bytes = e.key.size() + e.info.size();
+		for (uint32_t i = 0; i < tags->Length(); ++i)
+		{
+			e.tags.push_back(to_string(Nan::Get(tags, i).ToLocalChecked()));
+		}
+		for (uint32_t i = 0; i < batches->Length(); ++i)
+		{
+			const auto b = Nan::Get(batches, i).ToLocalChecked();
+			const auto* const data = reinterpret_cast<const uint8_t*>(node::Buffer::Data(b));
+			const auto len = node::Buffer::Length(b);
+			e.batches.push_back(make_shared<vector<uint8_t>>(data, data + len));
+			e.bytes += len;
+		}
+		if (ttl_ms <= 0 || e.bytes > cache->_max_bytes)
+		{
+			info.GetReturnValue().Set(Nan::False());
+			return;
+		}
+
+		cache->evict_to(cache->_max_bytes - e.bytes);
+		cache->_bytes += e.bytes;
+		for (const auto& tag : e.tags)
+		{
+			cache->_tags[tag].insert(key);
+		}
+		cache->_lru.push_front(std::move(e));
+		cache->_index[key] = cache->_lru.begin();
+		info.GetReturnValue().Set(Nan::True());
+	}
+
+	// get(key) - { info, batches } or null on a miss or once the entry has expired.
+	void ResultCache::get(NanCb info)
+	{
+		auto* const cache = Unwrap<ResultCache>(info.This());
+		const auto key = to_string(info[0]);
+		const auto found = cache->_index.find(key);
+		if (found == cache->_index.end())
+		{
+			++cache->_misses;
+			info.GetReturnValue().Set(Nan::Null());
+			return;
+		}
+		const auto it = found->second;
+		if (it->expires <= clock::now())
+		{
+			cache->erase(it);
+			++cache->_expirations;
+			++cache->_misses;
+			info.GetReturnValue().Set(Nan::Null());
+			return;
+		}
+		++cache->_hits;
+		cache->_lru.splice(cache->_lru.begin(), cache->_lru, it);
+
+		const auto res = Nan::New<Object>();
+		const auto batches = Nan::New<Array>(static_cast<int>(it->batches.size()));
+		for (size_t i = 0; i < it->batches.size(); ++i)
+		{
+			Nan::Set(batches, static_cast<uint32_t>(i), batch_buffer(it->batches[i]));
+		}
+		Nan::Set(res, Nan::New("info").ToLocalChecked(), Nan::New(it->info).ToLocalChecked());
+		Nan::Set(res, Nan::New("batches").ToLocalChecked(), batches);
+		info.GetReturnValue().Set(res);
+	}
+
+	void ResultCache::invalidate(NanCb info)
+	{
+		auto* const cache = Unwrap<ResultCache>(info.This());
+		const auto found = cache->_index.find(to_string(info[0]));
+		const auto present = found != cache->_index.end();
+		if (present)
+		{
+			cache->erase(found->second);
+		}
+		info.GetReturnValue().Set(Nan::New(present));
+	}
+
+	// drops every entry carrying the tag, returns how many went.
+	void ResultCache::invalidate_tag(NanCb info)
+	{
+		auto* const cache = Unwrap<ResultCache>(info.This());
+		const auto found = cache->_tags.find(to_string(info[0]));
+		uint32_t count = 0;
+		if (found != cache->_tags.end())
+		{
+			// erase() edits the tag sets, work from a copy of the keys.
+			const vector<string> keys(found->second.begin(), found->second.end());
+			for (const auto& key : keys)
+			{
+				const auto it = cache->_index.find(key);
+				if (it == cache->_index.end()) continue;
+				cache->erase(it->second);
+				++count;
+			}
+		}
+		info.GetReturnValue().Set(Nan::New(count));
+	}
+
+	void ResultCache::clear(NanCb info)
+	{
+		auto* const cache = Unwrap<ResultCache>(info.This());
+		cache->_lru.clear();
+		cache->_index.clear();
+		cache->_tags.clear();
+		cache->_bytes = 0;
+	}
+
+	void ResultCache::get_stats(NanCb info)
+	{
+		const auto* const cache = Unwrap<ResultCache>(info.This());
+		const auto res = Nan::New<Object>();
+		const auto set = [&res](const char* name, const double v)
+		{
+			Nan::Set(res, Nan::New(name).ToLocalChecked(), Nan::New<Number>(v));
+		};
+		set("entries", static_cast<double>(cache->_lru.size()));
+		set("bytes", static_cast<double>(cache->_bytes));
+		set("maxBytes", static_cast<double>(cache->_max_bytes));
+		set("hits", static_cast<double>(cache->_hits));
+		set("misses", static_cast<double>(cache->_misses));
+		set("evictions", static_cast<double>(cache->_evictions));
+		set("expirations", static_cast<double>(cache->_expirations));
+		info.GetReturnValue().Set(res);
+	}
+}
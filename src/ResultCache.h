@@ -0,0 +1,87 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: ResultCache.h
+// Contents: byte bounded LRU of encoded query results held outside the V8 heap
+//
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <nan.h>
+#include <chrono>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace mssql
+{
+	using namespace std;
+	using namespace v8;
+
+	// results kept as the columnar batches ReadColumnarOperation encodes (see Columnar.h),
+	// copied once into native memory on put. get() hands each batch back as an ArrayBuffer
+	// over the cached bytes, the entry's storage shared with it, so a hit costs no copy and an
+	// eviction never frees a batch JS still reads. entries carry an expiry and a set of tags,
+	// the least recently used go first once the byte bound is passed. only the loop thread
+	// calls in, so there is no locking.
+	class ResultCache : public Nan::ObjectWrap
+	{
+	public:
+		static NAN_MODULE_INIT(Init);
+		virtual ~ResultCache();
+
+	private:
+		typedef Nan::NAN_METHOD_ARGS_TYPE NanCb;
+		typedef chrono::steady_clock clock;
+		typedef shared_ptr<vector<uint8_t>> batch_ptr;
+
+		struct entry
+		{
+			string key;
+			string info;
+			vector<batch_ptr> batches;
+			vector<string> tags;
+			clock::time_point expires;
+			size_t bytes = 0;
+		};
+
+		typedef list<entry> lru_list;
+
+		explicit ResultCache(size_t max_bytes);
+		static NAN_METHOD(New);
+		static NAN_METHOD(put);
+		static NAN_METHOD(get);
+		static NAN_METHOD(invalidate);
+		static NAN_METHOD(invalidate_tag);
+		static NAN_METHOD(clear);
+		static NAN_METHOD(get_stats);
+
+		void erase(lru_list::iterator it);
+		void evict_to(size_t bytes);
+
+		size_t _max_bytes;
+		size_t _bytes = 0;
+		// front is the most recently used.
+		lru_list _lru;
+		unordered_map<string, lru_list::iterator> _index;
+		unordered_map<string, unordered_set<string>> _tags;
+		uint64_t _hits = 0;
+		uint64_t _misses = 0;
+		uint64_t _evictions = 0;
+		uint64_t _expirations = 0;
+	};
+}
@@ -98,6 +98,13 @@ namespace mssql
 		row[column->Id()] = column;
 	}
 
+	// the date and time columns JS meta calls 'date', as the JS shift before it did - a date
+	// inside a sql_variant is left in UTC.
+	bool ResultSet::local_date(const size_t column) const
+	{
+		return _local_dates && strcmp(map_type(_metadata[column].dataType), "date") == 0;
+	}
+
 	Local<Object> ResultSet::get_entry(const ColumnDefinition & definition)  {
 		const auto* const type_name = map_type(definition.dataType);
 		const auto entry = Nan::New<Object>();
@@ -21,6 +21,7 @@
 
 #include<vector>
 #include "Column.h"
+#include "StringInterner.h"
 
 namespace mssql
 {
@@ -40,6 +41,8 @@ namespace mssql
             SQLSMALLINT decimalDigits;
             SQLSMALLINT nullable;
             string udtTypeName;
+            // read once when the result set opens so the fetch loop need not ask the driver per cell.
+            SQLLEN displaySize;
         };
 
         ResultSet(int num_columns) 
@@ -54,6 +57,11 @@ namespace mssql
             return _metadata[column];
         }
 
+        const ColumnDefinition & get_meta_data(int column) const
+        {
+            return _metadata[column];
+        }
+
         size_t get_column_count() const
         {
             return _metadata.size();
@@ -64,6 +72,8 @@ namespace mssql
         }
         Local<Value> meta_to_value();
 		void add_column(size_t row_id, const shared_ptr<Column> & column);
+		// is the column shifted to local time when read out as rows.
+		bool local_date(size_t column) const;
 		shared_ptr<Column> get_column(size_t row_id, size_t id) const;
 		size_t get_result_count() const
 		{
@@ -87,6 +97,13 @@ namespace mssql
         SQLLEN _row_count;
         bool _end_of_rows;
 		vector<t_row> _rows;
+		shared_ptr<StringInterner> _interner;
+		bool _for_json = false;
+		// set once OdbcStatement has chosen readers for these columns.
+		bool _readers_built = false;
+		// date columns are shifted to local time as the rows are converted for JS, the
+		// columnar, arrow and cached encodings stay in UTC.
+		bool _local_dates = false;
 
 		friend class OdbcStatement;
     };
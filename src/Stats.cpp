@@ -0,0 +1,221 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: Stats.cpp
+// Contents: always on latency histograms and driver call counters
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include <Stats.h>
+
+namespace mssql
+{
+	static const char* operation_names[] = {
+		"other",
+		"open",
+		"close",
+		"query",
+		"queryPrepared",
+		"prepare",
+		"procedure",
+		"readColumn",
+		"readColumnar",
+		"readNextResult",
+		"unbind",
+		"freeStatement",
+		"cancel",
+		"pollingMode",
+		"beginTransaction",
+		"endTransaction",
+		"collect",
+		"tvpRows",
+		"readArrow",
+		"queryBatch"
+	};
+
+	static_assert(sizeof(operation_names) / sizeof(operation_names[0]) == static_cast<size_t>(OperationKind::Count),
+		"operation_names must match OperationKind");
+
+	size_t Histogram::index_of(uint64_t value)
+	{
+		constexpr uint64_t limit = (static_cast<uint64_t>(1) << 32) - 1;
+		if (value > limit) value = limit;
+		if (value < sub_buckets) return static_cast<size_t>(value);
+		size_t exponent = 0;
+		for (auto v = value; v > 1; v >>= 1) ++exponent;
+		const auto mantissa = static_cast<size_t>((value >> (exponent - 2)) & (sub_buckets - 1));
+		return sub_buckets + (exponent - 2) * sub_buckets + mantissa;
+	}
+
+	// exclusive upper bound of the values counted in a bucket.
+	uint64_t Histogram::upper_bound(const size_t index)
+	{
+		if (index < sub_buckets) return index + 1;
+		const auto exponent = (index - sub_buckets) / sub_buckets + 2;
+		const auto mantissa = (index - sub_buckets) % sub_buckets;
+		return static_cast<uint64_t>(sub_buckets + mantissa + 1) << (exponent - 2);
+	}
+
+	void Histogram::record(const uint64_t value)
+	{
+		_buckets[index_of(value)].fetch_add(1, memory_order_relaxed);
+		_count.fetch_add(1, memory_order_relaxed);
+		_sum.fetch_add(value, memory_order_relaxed);
+		auto seen = _max.load(memory_order_relaxed);
+		while (value > seen && !_max.compare_exchange_weak(seen, value, memory_order_relaxed))
+		{
+		}
+	}
+
+	void Histogram::merge_into(Histogram& other) const
+	{
+		for (size_t i = 0; i < bucket_count; ++i)
+		{
+			const auto n = _buckets[i].load(memory_order_relaxed);
+			if (n) other._buckets[i].fetch_add(n, memory_order_relaxed);
+		}
+		other._count.fetch_add(_count.load(memory_order_relaxed), memory_order_relaxed);
+		other._sum.fetch_add(_sum.load(memory_order_relaxed), memory_order_relaxed);
+		const auto max = _max.load(memory_order_relaxed);
+		auto seen = other._max.load(memory_order_relaxed);
+		while (max > seen && !other._max.compare_exchange_weak(seen, max, memory_order_relaxed))
+		{
+		}
+	}
+
+	Local<Object> Histogram::to_value() const
+	{
+		const auto res = Nan::New<Object>();
+		// read once so the percentiles agree with the buckets reported.
+		array<uint64_t, bucket_count> counts{};
+		uint64_t total = 0;
+		for (size_t i = 0; i < bucket_count; ++i)
+		{
+			counts[i] = _buckets[i].load(memory_order_relaxed);
+			total += counts[i];
+		}
+		const auto sum = _sum.load(memory_order_relaxed);
+		Nan::Set(res, Nan::New("count").ToLocalChecked(), Nan::New<Number>(static_cast<double>(total)));
+		Nan::Set(res, Nan::New("sumMicros").ToLocalChecked(), Nan::New<Number>(static_cast<double>(sum)));
+		Nan::Set(res, Nan::New("maxMicros").ToLocalChecked(), Nan::New<Number>(static_cast<double>(_max.load(memory_order_relaxed))));
+		Nan::Set(res, Nan::New("meanMicros").ToLocalChecked(), Nan::New<Number>(total ? static_cast<double>(sum) / static_cast<double>(total) : 0));
+
+		const pair<const char*, double> quantiles[] = { { "p50", 0.5 }, { "p90", 0.9 }, { "p99", 0.99 }, { "p999", 0.999 } };
+		for (const auto& q : quantiles)
+		{
+			uint64_t bound = 0;
+			if (total)
+			{
+				const auto rank = static_cast<uint64_t>(q.second * static_cast<double>(total - 1)) + 1;
+				uint64_t seen = 0;
+				for (size_t i = 0; i < bucket_count; ++i)
+				{
+					seen += counts[i];
+					if (seen >= rank)
+					{
+						bound = upper_bound(i);
+						break;
+					}
+				}
+			}
+			Nan::Set(res, Nan::New(q.first).ToLocalChecked(), Nan::New<Number>(static_cast<double>(bound)));
+		}
+
+		// cumulative [le, count] pairs for the occupied buckets - the shape a prometheus
+		// histogram wants.
+		const auto buckets = Nan::New<Array>();
+		uint32_t n = 0;
+		uint64_t cumulative = 0;
+		for (size_t i = 0; i < bucket_count; ++i)
+		{
+			if (!counts[i]) continue;
+			cumulative += counts[i];
+			const auto pair = Nan::New<Array>(2);
+			Nan::Set(pair, 0, Nan::New<Number>(static_cast<double>(upper_bound(i))));
+			Nan::Set(pair, 1, Nan::New<Number>(static_cast<double>(cumulative)));
+			Nan::Set(buckets, n++, pair);
+		}
+		Nan::Set(res, Nan::New("buckets").ToLocalChecked(), buckets);
+		return res;
+	}
+
+	DriverStats::~DriverStats()
+	{
+		for (auto& op : _operations)
+		{
+			delete op.load(memory_order_relaxed);
+		}
+	}
+
+	OperationStats& DriverStats::operation(OperationKind kind)
+	{
+		auto& slot = _operations[static_cast<size_t>(kind)];
+		auto* existing = slot.load(memory_order_acquire);
+		if (existing) return *existing;
+		auto* created = new OperationStats();
+		if (slot.compare_exchange_strong(existing, created, memory_order_acq_rel))
+		{
+			return *created;
+		}
+		// another thread won the race, existing now holds its allocation.
+		delete created;
+		return *existing;
+	}
+
+	void DriverStats::merge_into(DriverStats& other) const
+	{
+		for (size_t i = 0; i < _operations.size(); ++i)
+		{
+			const auto* op = _operations[i].load(memory_order_acquire);
+			if (!op) continue;
+			auto& target = other.operation(static_cast<OperationKind>(i));
+			op->queue_wait.merge_into(target.queue_wait);
+			op->execute.merge_into(target.execute);
+			op->complete.merge_into(target.complete);
+		}
+		other.fetch_calls.fetch_add(fetch_calls.load(memory_order_relaxed), memory_order_relaxed);
+		other.get_data_calls.fetch_add(get_data_calls.load(memory_order_relaxed), memory_order_relaxed);
+		other.bytes_fetched.fetch_add(bytes_fetched.load(memory_order_relaxed), memory_order_relaxed);
+		other.column_objects.fetch_add(column_objects.load(memory_order_relaxed), memory_order_relaxed);
+		other.prefetched_batches.fetch_add(prefetched_batches.load(memory_order_relaxed), memory_order_relaxed);
+		other.prefetch_hits.fetch_add(prefetch_hits.load(memory_order_relaxed), memory_order_relaxed);
+	}
+
+	Local<Object> DriverStats::to_value() const
+	{
+		const auto res = Nan::New<Object>();
+		const auto operations = Nan::New<Object>();
+		for (size_t i = 0; i < _operations.size(); ++i)
+		{
+			const auto* op = _operations[i].load(memory_order_acquire);
+			if (!op) continue;
+			const auto entry = Nan::New<Object>();
+			Nan::Set(entry, Nan::New("queueWait").ToLocalChecked(), op->queue_wait.to_value());
+			Nan::Set(entry, Nan::New("execute").ToLocalChecked(), op->execute.to_value());
+			Nan::Set(entry, Nan::New("complete").ToLocalChecked(), op->complete.to_value());
+			Nan::Set(operations, Nan::New(operation_names[i]).ToLocalChecked(), entry);
+		}
+		Nan::Set(res, Nan::New("operations").ToLocalChecked(), operations);
+		const auto counters = Nan::New<Object>();
+		Nan::Set(counters, Nan::New("fetchCalls").ToLocalChecked(), Nan::New<Number>(static_cast<double>(fetch_calls.load(memory_order_relaxed))));
+		Nan::Set(counters, Nan::New("getDataCalls").ToLocalChecked(), Nan::New<Number>(static_cast<double>(get_data_calls.load(memory_order_relaxed))));
+		Nan::Set(counters, Nan::New("bytesFetched").ToLocalChecked(), Nan::New<Number>(static_cast<double>(bytes_fetched.load(memory_order_relaxed))));
+		Nan::Set(counters, Nan::New("columnObjects").ToLocalChecked(), Nan::New<Number>(static_cast<double>(column_objects.load(memory_order_relaxed))));
+		Nan::Set(counters, Nan::New("prefetchedBatches").ToLocalChecked(), Nan::New<Number>(static_cast<double>(prefetched_batches.load(memory_order_relaxed))));
+		Nan::Set(counters, Nan::New("prefetchHits").ToLocalChecked(), Nan::New<Number>(static_cast<double>(prefetch_hits.load(memory_order_relaxed))));
+		Nan::Set(res, Nan::New("counters").ToLocalChecked(), counters);
+		return res;
+	}
+}
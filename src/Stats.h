@@ -0,0 +1,120 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: Stats.h
+// Contents: always on latency histograms and driver call counters
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <v8.h>
+
+namespace mssql
+{
+	using namespace std;
+	using namespace v8;
+
+	// log linear buckets in the HDR style - 4 per power of two so any recorded value
+	// is within 25% of its bucket bound. values are microseconds, clamped at ~71 minutes.
+	// record() is a handful of relaxed atomic adds and may be called from any thread.
+	class Histogram
+	{
+	public:
+		static constexpr size_t sub_buckets = 4;
+		static constexpr size_t bucket_count = 124;
+
+		void record(uint64_t value);
+		void merge_into(Histogram& other) const;
+		uint64_t count() const { return _count.load(memory_order_relaxed); }
+		Local<Object> to_value() const;
+
+		static size_t index_of(uint64_t value);
+		static uint64_t upper_bound(size_t index);
+
+	private:
+		array<atomic<uint64_t>, bucket_count> _buckets{};
+		atomic<uint64_t> _count{ 0 };
+		atomic<uint64_t> _sum{ 0 };
+		atomic<uint64_t> _max{ 0 };
+	};
+
+	enum class OperationKind : uint8_t
+	{
+		Other = 0,
+		Open,
+		Close,
+		Query,
+		QueryPrepared,
+		Prepare,
+		Procedure,
+		ReadColumn,
+		ReadColumnar,
+		ReadNextResult,
+		Unbind,
+		FreeStatement,
+		Cancel,
+		PollingMode,
+		BeginTran,
+		EndTran,
+		Collect,
+		TvpRows,
+		ReadArrow,
+		QueryBatch,
+		Count
+	};
+
+	struct OperationStats
+	{
+		Histogram queue_wait;   // handed to libuv until Execute starts
+		Histogram execute;      // Execute on the worker thread
+		Histogram complete;     // HandleOKCallback on the isolate thread
+	};
+
+	// one per OdbcConnection. histograms for an operation kind are allocated the first
+	// time that kind runs, most connections only ever see a few of them.
+	class DriverStats
+	{
+	public:
+		typedef chrono::steady_clock clock;
+
+		DriverStats() = default;
+		~DriverStats();
+		DriverStats(const DriverStats&) = delete;
+		DriverStats& operator=(const DriverStats&) = delete;
+
+		OperationStats& operation(OperationKind kind);
+		void merge_into(DriverStats& other) const;
+		Local<Object> to_value() const;
+
+		static uint64_t micros(clock::time_point from, clock::time_point to)
+		{
+			return static_cast<uint64_t>(chrono::duration_cast<chrono::microseconds>(to - from).count());
+		}
+
+		atomic<uint64_t> fetch_calls{ 0 };
+		atomic<uint64_t> get_data_calls{ 0 };
+		atomic<uint64_t> bytes_fetched{ 0 };
+		atomic<uint64_t> column_objects{ 0 };
+		atomic<uint64_t> prefetched_batches{ 0 };
+		atomic<uint64_t> prefetch_hits{ 0 };
+
+	private:
+		array<atomic<OperationStats*>, static_cast<size_t>(OperationKind::Count)> _operations{};
+	};
+}
@@ -50,10 +50,17 @@ namespace mssql
 		  	return ToValue();
 	   }
 
+	   Kind kind() const override { return Kind::Utf16; }
+	   const uint8_t* bytes(size_t& n) const override
+	   {
+		   n = size * sizeof(uint16_t);
+		   return reinterpret_cast<const uint8_t*>(storage->data() + offset);
+	   }
+
 	   inline Local<Value> ToNative() override
 	   {
 		   	auto sptr = storage->data();
-		  	auto s = Nan::Encode(sptr + offset, size * 2, Nan::UCS2);
+		  	auto s = ucs2_to_value(sptr + offset, size);
 		  	return s;
 	   }
 
@@ -0,0 +1,79 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: StringInterner.h
+// Contents: per result set cache of repeated string cells
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Column.h"
+
+namespace mssql
+{
+	using namespace std;
+
+	// low cardinality columns (status, country ...) repeat a handful of values, so a cell whose
+	// bytes were already seen in this result set shares the earlier column and its buffer.
+	// a column that exceeds the cap of distinct values is given up on and read as normal.
+	class StringInterner
+	{
+	public:
+		StringInterner(const size_t column_count, const size_t cap) :
+			_cap(cap),
+			_columns(column_count)
+		{
+		}
+
+		bool active(const size_t column) const
+		{
+			return column < _columns.size() && !_columns[column].exhausted;
+		}
+
+		shared_ptr<Column> find(const size_t column, const void* bytes, const size_t length) const
+		{
+			const auto& entry = _columns[column];
+			const auto itr = entry.values.find(string(static_cast<const char*>(bytes), length));
+			return itr == entry.values.end() ? nullptr : itr->second;
+		}
+
+		void add(const size_t column, const void* bytes, const size_t length, const shared_ptr<Column>& value)
+		{
+			auto& entry = _columns[column];
+			if (entry.exhausted)
+				return;
+			if (entry.values.size() >= _cap)
+			{
+				entry.exhausted = true;
+				entry.values.clear();
+				return;
+			}
+			entry.values.emplace(string(static_cast<const char*>(bytes), length), value);
+		}
+
+	private:
+		struct interned_column
+		{
+			bool exhausted = false;
+			unordered_map<string, shared_ptr<Column>> values;
+		};
+
+		size_t _cap;
+		vector<interned_column> _columns;
+	};
+}
@@ -96,6 +96,24 @@ namespace mssql {
 		nanoseconds_delta = time_struct.fraction % NANOSECONDS_PER_MS;
 	}
 
+	// shift the instant back by the local offset in force at it - the same as
+	// new Date(ms - getTimezoneOffset() * -60000) on the JS side.
+	void TimestampColumn::to_local()
+	{
+		const auto seconds = static_cast<time_t>(floor(milliseconds / ms_per_second));
+		tm local = {};
+#ifdef WINDOWS_BUILD
+		if (localtime_s(&local, &seconds) != 0) return;
+#else
+		if (localtime_r(&seconds, &local) == nullptr) return;
+#endif
+		auto local_ms = DaysSinceEpoch(static_cast<SQLSMALLINT>(local.tm_year + 1900), 
+			static_cast<SQLUSMALLINT>(local.tm_mon + 1), 
+			static_cast<SQLUSMALLINT>(local.tm_mday)) * ms_per_day;
+		local_ms += local.tm_hour * ms_per_hour + local.tm_min * ms_per_minute + local.tm_sec * ms_per_second;
+		milliseconds -= local_ms - static_cast<double>(seconds) * ms_per_second;
+	}
+
 	int64_t TimestampColumn::year_from_day(int64_t& day)
 	{
 		int64_t year = 1970;
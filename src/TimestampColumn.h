@@ -55,6 +55,14 @@ namespace mssql
 			return AsString<double>(milliseconds);
 		}
 
+		Kind kind() const override { return Kind::Date; }
+		double as_double() const override { return milliseconds; }
+		// the instant to the microsecond, the part below the millisecond taken from the delta.
+		int64_t as_microseconds() const
+		{
+			return static_cast<int64_t>(floor(milliseconds)) * 1000 + nanoseconds_delta / 1000;
+		}
+
 		Local<Value> ToNative() override
 		{
 			nodeTypeFactory fact;
@@ -99,6 +107,9 @@ namespace mssql
 			dt.day = ts.day;
 		}
 
+		// read the UTC fields as local wall clock time, for a connection not using UTC.
+		void to_local();
+
 		static const int64_t NANOSECONDS_PER_MS = static_cast<int64_t>(1e6);                  // nanoseconds per millisecond
 
 	private:
@@ -0,0 +1,82 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: TvpRowsOperation.cpp
+// Contents: push the next chunk of a streamed table valued parameter
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include <OdbcConnection.h>
+#include <OdbcStatement.h>
+#include <BoundDatumSet.h>
+#include <TvpRowsOperation.h>
+#include <MutateJS.h>
+
+namespace mssql
+{
+	TvpRowsOperation::TvpRowsOperation(
+		const shared_ptr<OdbcConnection> &connection,
+		const size_t query_id,
+		const Local<Object> callback) :
+		OdbcOperation(connection, callback)
+	{
+		_statementId = static_cast<long>(query_id);
+		_params = make_shared<BoundDatumSet>();
+	}
+
+	bool TvpRowsOperation::parameter_error_to_user_callback(const uint32_t param, const char* error) const
+	{
+		const nodeTypeFactory fact;
+
+		_params->clear();
+
+		stringstream full_error;
+		full_error << "IMNOD: [msnodesql] Parameter " << param + 1 << ": " << error;
+
+		const auto err = fact.error(full_error);
+		const auto imn = fact.new_string("IMNOD");
+		MutateJS::set_property_value(err, fact.new_string("sqlstate"), imn);
+		MutateJS::set_property_value(err, fact.new_string("code"), Nan::New(-1));
+
+		Local<Value> args[1];
+		args[0] = err;
+		constexpr auto argc = 1;
+
+		Nan::Call(Nan::New(_callback), Nan::GetCurrentContext()->Global(), argc, args);
+		return false;
+	}
+
+	bool TvpRowsOperation::bind_parameters(Local<Array> &node_params) const
+	{
+		const auto res = _params->bind(node_params);
+		if (!res)
+		{
+			parameter_error_to_user_callback(_params->first_error, _params->err);
+		}
+
+		return res;
+	}
+
+	bool TvpRowsOperation::TryInvokeOdbc()
+	{
+		if (_statement == nullptr) return false;
+		return _statement->try_send_tvp_rows(_params);
+	}
+
+	Local<Value> TvpRowsOperation::CreateCompletionArg()
+	{
+		return _statement->get_meta_value();
+	}
+}
@@ -0,0 +1,47 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: TvpRowsOperation.h
+// Contents: push the next chunk of a streamed table valued parameter
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <OdbcOperation.h>
+
+namespace mssql
+{
+	using namespace std;
+	using namespace v8;
+
+	class OdbcConnection;
+	class OdbcStatement;
+	class BoundDatumSet;
+
+	class TvpRowsOperation : public OdbcOperation
+	{
+	public:
+		TvpRowsOperation(const shared_ptr<OdbcConnection> &connection, size_t query_id, Local<Object> callback);
+		// the chunk is a one parameter array holding the tvp, bound on the isolate thread.
+		bool bind_parameters(Local<Array> & node_params) const;
+		bool parameter_error_to_user_callback(uint32_t param, const char* error) const;
+		bool TryInvokeOdbc() override;
+		Local<Value> CreateCompletionArg() override;
+		OperationKind kind() const override { return OperationKind::TvpRows; }
+
+	protected:
+		shared_ptr<BoundDatumSet> _params;
+	};
+}
@@ -0,0 +1,188 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: TvpStream.cpp
+// Contents: fixed size column buffers a streamed table valued parameter is pushed through
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include <TvpStream.h>
+#include <BoundDatum.h>
+#include <cstring>
+
+namespace mssql
+{
+	// element size of the fixed width c types, 0 for those laid out at buffer_len per row.
+	static SQLLEN fixed_size(const SQLSMALLINT c_type)
+	{
+		switch (c_type)
+		{
+		case SQL_C_BIT:
+		case SQL_C_TINYINT:
+		case SQL_C_STINYINT:
+		case SQL_C_UTINYINT:
+			return 1;
+		case SQL_C_SHORT:
+		case SQL_C_SSHORT:
+		case SQL_C_USHORT:
+			return 2;
+		case SQL_C_LONG:
+		case SQL_C_SLONG:
+		case SQL_C_ULONG:
+		case SQL_C_FLOAT:
+			return 4;
+		case SQL_C_SBIGINT:
+		case SQL_C_UBIGINT:
+		case SQL_C_DOUBLE:
+			return 8;
+		case SQL_C_TIMESTAMP:
+		case SQL_C_TYPE_TIMESTAMP:
+			return sizeof(SQL_TIMESTAMP_STRUCT);
+		case SQL_C_DATE:
+		case SQL_C_TYPE_DATE:
+			return sizeof(SQL_DATE_STRUCT);
+		case SQL_C_NUMERIC:
+			return sizeof(SQL_NUMERIC_STRUCT);
+		default:
+			return 0;
+		}
+	}
+
+	static SQLLEN stride_of(const shared_ptr<BoundDatum>& datum)
+	{
+		const auto fixed = fixed_size(datum->c_type);
+		return fixed > 0 ? fixed : datum->buffer_len;
+	}
+
+	// text and binary vary per chunk with the longest value, so are given the declared width.
+	// time2 and offset also travel as SQL_C_BINARY but are structs of one size.
+	static bool is_variable(const shared_ptr<BoundDatum>& datum)
+	{
+		switch (datum->c_type)
+		{
+		case SQL_C_CHAR:
+		case SQL_C_WCHAR:
+			return true;
+		case SQL_C_BINARY:
+			return datum->sql_type == SQL_BINARY
+				|| datum->sql_type == SQL_VARBINARY
+				|| datum->sql_type == SQL_LONGVARBINARY;
+		default:
+			return false;
+		}
+	}
+
+	TvpStream::TvpStream(const shared_ptr<BoundDatum>& tvp, const shared_ptr<param_bindings>& columns) :
+		_tvp(tvp),
+		_capacity(static_cast<SQLLEN>(tvp->param_size)),
+		_rows(tvp->tvp_stream_rows),
+		_ended(tvp->tvp_stream_end)
+	{
+		for (const auto& datum : *columns)
+		{
+			Column column;
+			column.datum = datum;
+			column.variable = is_variable(datum);
+			column.stride = column.variable && datum->stream_width > 0 ? datum->stream_width : stride_of(datum);
+			_columns.push_back(move(column));
+		}
+	}
+
+	void* TvpStream::token() const
+	{
+		return _tvp->buffer;
+	}
+
+	bool TvpStream::adopt(string& err)
+	{
+		if (_rows > _capacity)
+		{
+			err = "tvp chunk holds more rows than the stream was bound for";
+			return false;
+		}
+		for (auto& column : _columns)
+		{
+			const auto& datum = column.datum;
+			column.storage.resize(static_cast<size_t>(column.stride * _capacity));
+			if (!copy(column, datum, _rows, err)) return false;
+			// the first chunk keeps its own types, only where the values live changes.
+			datum->get_ind_vec().resize(static_cast<size_t>(_capacity), SQL_NULL_DATA);
+			datum->buffer = column.storage.data();
+			if (column.variable)
+			{
+				datum->buffer_len = column.stride;
+				const auto chars = datum->c_type == SQL_C_WCHAR ? column.stride / 2 : column.stride;
+				datum->param_size = datum->stream_max ? 0 : static_cast<SQLULEN>(chars);
+			}
+		}
+		return true;
+	}
+
+	bool TvpStream::fill(const shared_ptr<BoundDatum>& tvp, const param_bindings& columns, string& err)
+	{
+		const auto rows = tvp->tvp_stream_rows;
+		if (rows > _capacity)
+		{
+			err = "tvp chunk holds more rows than the stream was bound for";
+			return false;
+		}
+		if (rows > 0 && columns.size() != _columns.size())
+		{
+			err = "tvp chunk does not have the columns the stream was bound with";
+			return false;
+		}
+		for (size_t i = 0; rows > 0 && i < _columns.size(); ++i)
+		{
+			if (!copy(_columns[i], columns[i], rows, err)) return false;
+		}
+		_rows = rows;
+		_ended = tvp->tvp_stream_end;
+		return true;
+	}
+
+	bool TvpStream::copy(Column& column, const shared_ptr<BoundDatum>& from, const SQLLEN rows, string& err) const
+	{
+		if (from->c_type != column.datum->c_type)
+		{
+			err = "tvp chunk column is not the type the stream was bound with";
+			return false;
+		}
+		const auto& from_ind = from->get_ind_vec();
+		if (static_cast<SQLLEN>(from_ind.size()) < rows)
+		{
+			err = "tvp chunk column is shorter than the chunk";
+			return false;
+		}
+		auto& to_ind = column.datum->get_ind_vec();
+		if (static_cast<SQLLEN>(to_ind.size()) < rows) to_ind.resize(static_cast<size_t>(rows));
+		const auto* const src = static_cast<const char*>(from->buffer);
+		auto* const dest = column.storage.data();
+		const auto from_stride = stride_of(from);
+		for (SQLLEN row = 0; row < rows; ++row)
+		{
+			const auto ind = from_ind[row];
+			to_ind[row] = ind;
+			if (ind == SQL_NULL_DATA) continue;
+			const auto bytes = column.variable ? ind : column.stride;
+			if (bytes > column.stride)
+			{
+				err = "tvp value is wider than the width its column is streamed with";
+				return false;
+			}
+			memcpy(dest + row * column.stride, src + row * from_stride, static_cast<size_t>(bytes));
+		}
+		return true;
+	}
+}
@@ -0,0 +1,67 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: TvpStream.h
+// Contents: fixed size column buffers a streamed table valued parameter is pushed through
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mssql
+{
+	using namespace std;
+
+	class BoundDatum;
+
+	// a table valued parameter bound data at execution. each column owns one block of
+	// capacity rows at a fixed stride which stays bound for the whole execute, every chunk
+	// pushed from JS is copied over the last so memory is one chunk whatever the row count.
+	class TvpStream
+	{
+	public:
+		typedef vector<shared_ptr<BoundDatum>> param_bindings;
+
+		TvpStream(const shared_ptr<BoundDatum>& tvp, const shared_ptr<param_bindings>& columns);
+		// move the first chunk's columns onto the stream buffers, before they are bound.
+		bool adopt(string& err);
+		// copy a later chunk, bound from JS as a set of its own, into the same buffers.
+		bool fill(const shared_ptr<BoundDatum>& tvp, const param_bindings& columns, string& err);
+		// the tvp buffer, handed back by SQLParamData when the driver wants its rows.
+		void* token() const;
+		SQLLEN rows() const { return _rows; }
+		bool ended() const { return _ended; }
+
+	private:
+		struct Column
+		{
+			shared_ptr<BoundDatum> datum;
+			vector<char> storage;
+			SQLLEN stride;
+			bool variable;
+		};
+
+		bool copy(Column& column, const shared_ptr<BoundDatum>& from, SQLLEN rows, string& err) const;
+
+		shared_ptr<BoundDatum> _tvp;
+		vector<Column> _columns;
+		SQLLEN _capacity;
+		SQLLEN _rows;
+		bool _ended;
+	};
+}
@@ -45,6 +45,82 @@ namespace mssql
 		return s;
 	}
 
+	// checks four code units per step so the compiler can vectorise the loop.
+	bool is_latin1(const uint16_t *s, const size_t n)
+	{
+		constexpr uint64_t high_bytes = 0xFF00FF00FF00FF00ULL;
+		size_t i = 0;
+		uint64_t acc = 0;
+		for (; i + 4 <= n; i += 4)
+		{
+			uint64_t block;
+			memcpy(&block, s + i, sizeof(block));
+			acc |= block;
+		}
+		if (acc & high_bytes)
+			return false;
+		for (; i < n; ++i)
+		{
+			if (s[i] > 0xFF)
+				return false;
+		}
+		return true;
+	}
+
+	bool is_ascii(const char *s, const size_t n)
+	{
+		constexpr uint64_t high_bits = 0x8080808080808080ULL;
+		size_t i = 0;
+		uint64_t acc = 0;
+		for (; i + 8 <= n; i += 8)
+		{
+			uint64_t block;
+			memcpy(&block, s + i, sizeof(block));
+			acc |= block;
+		}
+		if (acc & high_bits)
+			return false;
+		for (; i < n; ++i)
+		{
+			if (static_cast<unsigned char>(s[i]) & 0x80)
+				return false;
+		}
+		return true;
+	}
+
+	Local<Value> ucs2_to_value(const uint16_t *s, const size_t n)
+	{
+		if (n == 0)
+			return Nan::EmptyString();
+		if (!is_latin1(s, n))
+			return Nan::Encode(s, n * 2, Nan::UCS2);
+
+		constexpr size_t small = 256;
+		uint8_t local[small];
+		vector<uint8_t> heap;
+		auto *narrow = local;
+		if (n > small)
+		{
+			heap.resize(n);
+			narrow = heap.data();
+		}
+		for (size_t i = 0; i < n; ++i)
+		{
+			narrow[i] = static_cast<uint8_t>(s[i]);
+		}
+		return String::NewFromOneByte(Isolate::GetCurrent(), narrow, NewStringType::kNormal, static_cast<int>(n)).ToLocalChecked();
+	}
+
+	Local<Value> utf8_to_value(const char *s, const size_t n)
+	{
+		if (n == 0)
+			return Nan::EmptyString();
+		// plain ASCII is already valid Latin-1, so skip the UTF-8 decoder.
+		if (is_ascii(s, n))
+			return String::NewFromOneByte(Isolate::GetCurrent(), reinterpret_cast<const uint8_t *>(s), NewStringType::kNormal, static_cast<int>(n)).ToLocalChecked();
+		return Nan::Encode(s, n, Nan::UTF8);
+	}
+
 	shared_ptr<vector<uint16_t>> js2u16(Local<String> str)
 	{
 		const auto str_len = str->Length();
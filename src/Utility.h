@@ -37,6 +37,13 @@ namespace mssql
 	wstring s2ws(const string & s);
     wstring FromV8String(Local<String> input);
 	
+	// result strings are mostly ASCII; when every code unit fits in one byte hand V8 a
+	// one-byte string, which takes half the heap of the two-byte form.
+	bool is_latin1(const uint16_t * s, size_t n);
+	bool is_ascii(const char * s, size_t n);
+	Local<Value> ucs2_to_value(const uint16_t * s, size_t n);
+	Local<Value> utf8_to_value(const char * s, size_t n);
+
 	void encode_numeric_struct(double v, int precision, int upscale_limit, SQL_NUMERIC_STRUCT & numeric);
 	double decode_numeric_struct(const SQL_NUMERIC_STRUCT & numeric);
 
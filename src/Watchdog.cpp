@@ -0,0 +1,111 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: Watchdog.cpp
+// Contents: process wide timer wheel enforcing per query deadlines
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include <Watchdog.h>
+#include <OdbcStatement.h>
+#include <thread>
+
+namespace mssql
+{
+	// never destroyed - the thread is detached and may still be parked on the condition
+	// variable as the process exits.
+	Watchdog& Watchdog::instance()
+	{
+		static auto* const watchdog = new Watchdog();
+		return *watchdog;
+	}
+
+	Watchdog::Watchdog() :
+		_wheel(slot_count),
+		_cursor(0),
+		_pending(0),
+		_started(false)
+	{
+	}
+
+	void Watchdog::arm(const shared_ptr<OdbcStatement>& statement, const uint64_t token, const int64_t after_ms)
+	{
+		const auto now = chrono::steady_clock::now();
+		const auto deadline = now + chrono::milliseconds(after_ms);
+		{
+			lock_guard<mutex> lock(_mutex);
+			if (!_started)
+			{
+				_started = true;
+				thread([this] { run(); }).detach();
+			}
+			if (_pending == 0)
+			{
+				// the wheel stood still while empty, restart it from now.
+				_next_tick = now + chrono::milliseconds(tick_ms);
+			}
+			// slot k ahead of the cursor is run at _next_tick + (k - 1) ticks. the current tick
+			// may be partly gone, so count from _next_tick and round up - a deadline fires on or
+			// after its time, never before.
+			const auto remaining = chrono::duration_cast<chrono::nanoseconds>(deadline - _next_tick).count();
+			const int64_t tick_ns = tick_ms * 1000000;
+			const auto ticks = static_cast<size_t>(1 + (remaining > 0 ? (remaining + tick_ns - 1) / tick_ns : 0));
+			_wheel[(_cursor + ticks) % slot_count].push_back(Entry{ statement, token, (ticks - 1) / slot_count });
+			++_pending;
+		}
+		_wake.notify_one();
+	}
+
+	void Watchdog::run()
+	{
+		vector<Entry> due;
+		while (true)
+		{
+			{
+				unique_lock<mutex> lock(_mutex);
+				_wake.wait(lock, [this] { return _pending > 0; });
+				if (_wake.wait_until(lock, _next_tick, [this] { return _pending == 0; })) continue;
+				_next_tick += chrono::milliseconds(tick_ms);
+				_cursor = (_cursor + 1) % slot_count;
+				auto& slot = _wheel[_cursor];
+				if (slot.empty()) continue;
+				vector<Entry> later;
+				for (auto& entry : slot)
+				{
+					if (entry.rounds > 0)
+					{
+						--entry.rounds;
+						later.push_back(move(entry));
+					}
+					else
+					{
+						due.push_back(move(entry));
+					}
+				}
+				slot.swap(later);
+				_pending -= due.size();
+			}
+			// the cancel calls into the driver, so it is made outside the lock.
+			for (const auto& entry : due)
+			{
+				if (const auto statement = entry.statement.lock())
+				{
+					statement->expire(entry.token);
+				}
+			}
+			due.clear();
+		}
+	}
+}
@@ -0,0 +1,68 @@
+//---------------------------------------------------------------------------------------------------------------------------------
+// File: Watchdog.h
+// Contents: process wide timer wheel enforcing per query deadlines
+// 
+// Copyright Microsoft Corporation and contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// You may obtain a copy of the License at:
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mssql
+{
+	using namespace std;
+
+	class OdbcStatement;
+
+	// one thread for the whole process cancels statements whose deadline has passed. deadlines
+	// are hashed into a wheel of 10ms ticks, so arming is a push under a short lock and nothing
+	// is ever removed - a statement that finishes in time changes its token and the entry is
+	// dropped harmlessly when its slot comes round.
+	class Watchdog
+	{
+	public:
+		static Watchdog& instance();
+
+		void arm(const shared_ptr<OdbcStatement>& statement, uint64_t token, int64_t after_ms);
+
+	private:
+		Watchdog();
+		void run();
+
+		struct Entry
+		{
+			weak_ptr<OdbcStatement> statement;
+			uint64_t token;
+			size_t rounds;
+		};
+
+		static constexpr size_t slot_count = 512;
+		static constexpr int64_t tick_ms = 10;
+
+		vector<vector<Entry>> _wheel;
+		size_t _cursor;
+		size_t _pending;
+		chrono::steady_clock::time_point _next_tick;
+		mutex _mutex;
+		condition_variable _wake;
+		bool _started;
+	};
+}
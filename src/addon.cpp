@@ -1,8 +1,12 @@
 #include "stdafx.h"
 #include "Connection.h"
+#include "ConnectionPool.h"
+#include "ResultCache.h"
 
 void InitAll(v8::Local<v8::Object> exports) {
   mssql::Connection::Init(exports);
+  mssql::ConnectionPool::Init(exports);
+  mssql::ResultCache::Init(exports);
 }
 
 NAN_MODULE_WORKER_ENABLED(addon, InitAll)
\ No newline at end of file
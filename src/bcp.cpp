@@ -11,6 +11,7 @@
 #ifdef LINUX_BUILD
 #include <dlfcn.h>
 #include <unistd.h>
+#include <cstdlib>
 #endif
 
 #ifdef LINUX_BUILD
@@ -294,7 +295,14 @@ namespace mssql
         #endif
         #ifdef LINUX_BUILD
         auto vs = std::to_string(version);
-        if (!dynload("libmsodbcsql-" + vs + ".so") && !dynload("libmsodbcsql." + vs + ".dylib")) {
+        // lets the mock driver (npm run build-mock) stand in for msodbcsql.
+        const auto* const library = getenv("MSNODESQLV8_BCP_LIBRARY");
+        if (library && *library) {
+            if (!dynload(library)) {
+                return -1;
+            }
+        }
+        else if (!dynload("libmsodbcsql-" + vs + ".so") && !dynload("libmsodbcsql." + vs + ".dylib")) {
             return -1;
         }
         #endif
@@ -1499,6 +1499,52 @@ describe('bulk', function () {
     await simpleColumnBulkTest(params)
   }
 
+  it('connection: bulk insert arrow stream read back from a query', async function handler () {
+    const tableName = 'test_table_bulk_arrow'
+    await env.theConnection.promises.query(`IF OBJECT_ID('${tableName}', 'U') IS NOT NULL DROP TABLE ${tableName};`)
+    await env.theConnection.promises.query(`create TABLE ${tableName}(
+\tid int,
+\tbig bigint,
+\tf float,
+\ts nvarchar(50),
+\tb varbinary(10),
+\tok bit
+)`)
+    const source = `SELECT v.id, CAST(v.big AS bigint) AS big, CAST(v.f AS float) AS f, v.s, CAST(v.b AS varbinary(10)) AS b, CAST(v.ok AS bit) AS ok
+FROM (VALUES (1, 1099511627776, 1.5, N'héllo', 0x0102, 1),
+  (2, NULL, NULL, NULL, NULL, NULL),
+  (3, -7, -2.25, N'', 0x, 0)) AS v(id, big, f, s, b, ok)`
+    const res = await env.theConnection.promises.query({ query_str: source, columnar: 'arrow' })
+    const ipc = Buffer.concat(res.arrow[0])
+    await env.theConnection.promises.bulkInsertArrow(tableName, ipc)
+    const back = await env.theConnection.promises.query(`select * from ${tableName} order by id`)
+    expect(back.first).to.deep.equal([
+      { id: 1, big: 1099511627776, f: 1.5, s: 'héllo', b: Buffer.from([1, 2]), ok: true },
+      { id: 2, big: null, f: null, s: null, b: null, ok: null },
+      { id: 3, big: -7, f: -2.25, s: '', b: Buffer.alloc(0), ok: false }
+    ])
+  })
+
+  it('connection: bulk insert arrow stream that fails leaves nothing behind', async function handler () {
+    const tableName = 'test_table_bulk_arrow_fail'
+    await env.theConnection.promises.query(`IF OBJECT_ID('${tableName}', 'U') IS NOT NULL DROP TABLE ${tableName};`)
+    await env.theConnection.promises.query(`create TABLE ${tableName}(id int primary key)`)
+    const dup = await env.theConnection.promises.query({ query_str: 'SELECT v.id FROM (VALUES (1), (1)) AS v(id)', columnar: 'arrow' })
+    let err = null
+    try {
+      await env.theConnection.promises.bulkInsertArrow(tableName, Buffer.concat(dup.arrow[0]))
+    } catch (e) {
+      err = e
+    }
+    expect(err).to.not.equal(null)
+    const one = await env.theConnection.promises.query({ query_str: 'SELECT 2 AS id', columnar: 'arrow' })
+    await env.theConnection.promises.bulkInsertArrow(tableName, Buffer.concat(one.arrow[0]))
+    const state = await env.theConnection.promises.query('SELECT @@TRANCOUNT AS n')
+    expect(state.first[0].n).to.equal(0)
+    const back = await env.theConnection.promises.query(`select id from ${tableName} order by id`)
+    expect(back.first).to.deep.equal([{ id: 2 }])
+  })
+
   async function setupSimpleType (conn, tableName) {
     const dropTableSql = `IF OBJECT_ID('${tableName}', 'U') IS NOT NULL 
   DROP TABLE ${tableName};`
@@ -235,4 +235,35 @@ describe('concurrent', function () {
       })
     })
   })
+
+  it('pipelined queries on one MARS connection - each gets its own results on the one session', async function handler () {
+    const conn = await env.sql.promises.open(`${env.connectionString};MultipleActiveResultSets=yes`)
+    try {
+      conn.setPipelineDepth(2)
+      assert.strictEqual(conn.getPipelineDepth(), 2)
+      const workQueue = conn.driverMgr.workQueue
+      const settled = []
+      let liveWithFast = 0
+      const slow = conn.promises.query('waitfor delay \'00:00:01\'; select @@SPID as spid, \'slow\' as tag')
+        .then(res => { settled.push('slow'); return res })
+      const fast = conn.promises.query('select @@SPID as spid, \'fast\' as tag')
+        .then(res => {
+          settled.push('fast')
+          liveWithFast = workQueue.ordered().filter(op => workQueue.isLive(op)).length
+          return res
+        })
+      const [slowRes, fastRes] = await Promise.all([slow, fast])
+      // run one at a time the slow query, queued first, would have to finish first. the
+      // fast one only overtakes it when both were with the driver together.
+      assert.deepStrictEqual(settled, ['fast', 'slow'])
+      assert.isAtLeast(liveWithFast, 1)
+      assert.strictEqual(slowRes.first[0].tag, 'slow')
+      assert.strictEqual(fastRes.first[0].tag, 'fast')
+      assert.strictEqual(slowRes.first[0].spid, fastRes.first[0].spid)
+      const after = await conn.promises.query('select 1 as n')
+      assert.deepStrictEqual(after.first, [{ n: 1 }])
+    } finally {
+      await conn.promises.close()
+    }
+  })
 })
@@ -5,6 +5,7 @@ const assert = chai.assert
 const expect = chai.expect
 chai.use(require('chai-as-promised'))
 const { TestEnv } = require('./env/test-env')
+const { serialise } = require('../lib/single-flight')
 const env = new TestEnv()
 
 describe('connection-pool', function () {
@@ -647,4 +648,149 @@ describe('connection-pool', function () {
       testDone()
     })
   })
+
+  it('pool of 1 - queued query checked out on checkin with wait reported', async function handler () {
+    const pool = env.pool(1)
+    const waits = []
+    const order = []
+    let opened = false
+    pool.on('status', s => {
+      if (!opened) return
+      if (s.op === 'checkout' && s.activity === 'work') {
+        waits.push(s.waitMs)
+        order.push('out')
+      } else if (s.op === 'checkin' && s.activity === 'work') {
+        order.push('in')
+      }
+    })
+    await pool.promises.open()
+    opened = true
+    await Promise.all([
+      pool.promises.query('waitfor delay \'00:00:01\';'),
+      pool.promises.query('select 1 as n')
+    ])
+    await pool.promises.close()
+    // ordering rather than wall clock - the second only goes out once the first is back,
+    // having waited longer than the first did.
+    expect(waits.length).to.equal(2)
+    expect(order.slice(0, 3)).to.deep.equal(['out', 'in', 'out'])
+    expect(waits[1]).to.be.greaterThan(waits[0])
+  })
+
+  it('coalesce reads - params of different types that print alike never share a key', function handler () {
+    const d = new Date('2020-01-02T03:04:05.000Z')
+    const b = Buffer.from([1, 2])
+    const pairs = [
+      [1n, '1n'],
+      [1n, '1'],
+      [d, d.toISOString()],
+      [b, b.toJSON()],
+      [b, { t: 'buf', v: '0102' }],
+      [new Uint8Array([1, 2]), b]
+    ]
+    pairs.forEach(([x, y]) => expect(serialise(['q', [x]])).to.not.equal(serialise(['q', [y]])))
+    expect(serialise(['q', [1n, d, b, { a: 1 }]])).to.equal(serialise(['q', [1n, new Date(d), Buffer.from(b), { a: 1 }]]))
+  })
+
+  it('coalesce reads - identical reads in flight share one execution and frozen results', async function handler () {
+    const pool = new env.sql.Pool({
+      connectionString: env.connectionString,
+      ceiling: 4,
+      coalesceReads: true
+    })
+    await pool.promises.open()
+    const sql = 'waitfor delay \'00:00:00.5\'; select ? as n'
+    const res = await Promise.all([1, 1, 1, 2].map(n => pool.promises.query(sql, [n], { read: true })))
+    const unmarked = await pool.promises.query(sql, [1])
+    const coalesced = pool.getStats().pool.coalesced
+    await pool.promises.close()
+    expect(coalesced).to.equal(2)
+    expect(res[0]).to.equal(res[1])
+    expect(res[0]).to.equal(res[2])
+    expect(res[3].first).to.deep.equal([{ n: 2 }])
+    expect(Object.isFrozen(res[0].first[0])).to.equal(true)
+    expect(unmarked).to.not.equal(res[0])
+  })
+
+  it('result cache - hits served from the cache until invalidated by tag', async function handler () {
+    const pool = new env.sql.Pool({
+      connectionString: env.connectionString,
+      ceiling: 2,
+      resultCacheBytes: 1024 * 1024
+    })
+    await pool.promises.open()
+    const sql = 'select v.n, v.s from (values (?, N\'one\'), (2, N\'two\')) as v(n, s)'
+    const options = { ttlMs: 60000, tags: ['v'] }
+    // first seen, the sql is read the ordinary way and only its columns are looked at.
+    const seen = await pool.promises.query(sql, [1], options)
+    expect(pool.getStats().cache.entries).to.equal(0)
+    const miss = await pool.promises.query(sql, [1], options)
+    const before = pool.getStats().operations.query.execute.count
+    const hit = await pool.promises.query(sql, [1], options)
+    const afterHit = pool.getStats()
+    const dropped = pool.invalidateTag('v')
+    await pool.promises.query(sql, [1], options)
+    const afterDrop = pool.getStats()
+    await pool.promises.close()
+    expect(seen.first).to.deep.equal([{ n: 1, s: 'one' }, { n: 2, s: 'two' }])
+    expect(miss.first).to.deep.equal(seen.first)
+    expect(hit.first).to.deep.equal(miss.first)
+    expect(afterHit.operations.query.execute.count).to.equal(before)
+    expect(afterHit.cache.hits).to.equal(1)
+    expect(dropped).to.equal(1)
+    expect(afterDrop.operations.query.execute.count).to.equal(before + 1)
+  })
+
+  it('result cache - a miss invalidated while it runs is not stored and dates are never cached', async function handler () {
+    const pool = new env.sql.Pool({
+      connectionString: env.connectionString,
+      ceiling: 2,
+      resultCacheBytes: 1024 * 1024
+    })
+    await pool.promises.open()
+    const options = { ttlMs: 60000, tags: ['slow'] }
+    const slow = 'waitfor delay \'00:00:00.3\'; select ? as n'
+    await pool.promises.query(slow, [2], options)
+    const running = pool.promises.query(slow, [1], options)
+    pool.invalidateTag('slow')
+    await running
+    const afterInvalidate = pool.getStats().cache.entries
+    const dated = 'select cast(\'2020-01-02 03:04:05.1234567\' as datetime2(7)) as d'
+    const executes = () => pool.getStats().operations.query.execute.count
+    const beforeDated = executes()
+    const first = await pool.promises.query(dated, [], options)
+    const afterFirst = executes()
+    const second = await pool.promises.query(dated, [], options)
+    const afterSecond = executes()
+    const stats = pool.getStats().cache
+    await pool.promises.close()
+    expect(afterInvalidate).to.equal(0)
+    // one round trip each, the first read is not repeated once its dates are seen.
+    expect(afterFirst - beforeDated).to.equal(1)
+    expect(afterSecond - afterFirst).to.equal(1)
+    expect(first.first[0].d.nanosecondsDelta).to.be.closeTo(0.0004567, 1e-9)
+    expect(second.first[0].d.nanosecondsDelta).to.equal(first.first[0].d.nanosecondsDelta)
+    expect(stats.entries).to.equal(0)
+    expect(stats.hits).to.equal(0)
+  })
+
+  it('result cache - a hit hands out its own copy of binary cells', async function handler () {
+    const pool = new env.sql.Pool({
+      connectionString: env.connectionString,
+      ceiling: 2,
+      resultCacheBytes: 1024 * 1024
+    })
+    await pool.promises.open()
+    const sql = 'select cast(0x01020304 as varbinary(4)) as b'
+    const options = { ttlMs: 60000 }
+    await pool.promises.query(sql, [], options)
+    await pool.promises.query(sql, [], options)
+    const hit = await pool.promises.query(sql, [], options)
+    hit.first[0].b.fill(0xff)
+    const next = await pool.promises.query(sql, [], options)
+    const stats = pool.getStats().cache
+    await pool.promises.close()
+    expect(stats.hits).to.equal(2)
+    expect(next.first[0].b).to.deep.equal(Buffer.from([1, 2, 3, 4]))
+  })
 })
@@ -61,4 +61,25 @@ describe('json', function () {
     const selected = selectedRecords.first.map(rec => rec.json)
     expect(selected).to.deep.equals(expected)
   })
+
+  const forJsonName = 'JSON_F52E2B61-18A1-11d1-B105-00805F49916B'
+  const forJsonSql = 'SELECT TOP 500 o.object_id, o.name, o.type_desc FROM sys.all_objects o ORDER BY o.object_id FOR JSON PATH'
+
+  it('FOR JSON fragments reassembled natively into one row', async function handler () {
+    const promises = env.theConnection.promises
+    const raw = await promises.query(forJsonSql)
+    const joined = raw.first.map(r => r[forJsonName]).join('')
+    const res = await promises.query({ query_str: forJsonSql, json_reassemble: true })
+    expect(res.first.length).to.equal(1)
+    expect(res.first[0][forJsonName]).to.equal(joined)
+  })
+
+  it('FOR JSON document parsed natively into an object', async function handler () {
+    const promises = env.theConnection.promises
+    const raw = await promises.query(forJsonSql)
+    const expected = JSON.parse(raw.first.map(r => r[forJsonName]).join(''))
+    const res = await promises.query({ query_str: forJsonSql, json_parse: true })
+    expect(res.first.length).to.equal(1)
+    expect(res.first[0][forJsonName]).to.deep.equal(expected)
+  })
 })
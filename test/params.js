@@ -201,6 +201,32 @@ describe('params', function () {
       })
   })
 
+  it('insert rows bound per column by the driver', async function handler () {
+    const tableName = 'test_bind_rows'
+    const rows = [
+      { id: 1, name: 'one' },
+      { id: 2, name: null },
+      { id: 3 },
+      { id: 4, name: 'four' }
+    ]
+    await testBoilerPlateAsync(tableName, { id: 'int', name: 'nvarchar(20)' },
+      async function () {
+        const columns = [{ key: 'id', param: env.sql.Int() }, { key: 'name' }]
+        await env.theConnection.promises.query(`INSERT INTO ${tableName} VALUES (?, ?)`, [env.sql.BindRows(rows, columns)])
+        assert.strictEqual(columns[0].param.value, undefined)
+      },
+      async function handler () {
+        const r = await env.theConnection.promises.query(`SELECT id, name FROM ${tableName} order by id`, [], { raw: true })
+        const expected = [
+          [1, 'one'],
+          [2, null],
+          [3, null],
+          [4, 'four']
+        ]
+        assert.deepStrictEqual(expected, r.first)
+      })
+  })
+
   it('query a numeric - configure connection to return as string', async function handler () {
     const num = '12345678.876'
     env.theConnection.setUseNumericString(true)
@@ -200,6 +200,64 @@ describe('pause', function () {
     })
   })
 
+  it('pause a large prefetched query every 100 rows - rows arrive in order', testDone => {
+    let expected = 0
+    const sql = 'select top 3000 * from syscolumns'
+    const q0 = env.theConnection.query(sql)
+    q0.on('row', () => {
+      ++expected
+    })
+    const before = env.theConnection.getStats().counters.prefetchedBatches
+    let rows = 0
+    const q = env.theConnection.query({
+      query_str: sql,
+      prefetch_depth: 4
+    })
+    q.on('error', (e) => {
+      assert.ifError(e)
+    })
+    q.on('row', i => {
+      assert.strictEqual(rows, i)
+      ++rows
+      if (rows % 100 === 0) {
+        q.pauseQuery()
+        setTimeout(() => {
+          q.resumeQuery()
+        }, 50)
+      }
+    })
+    q.on('done', () => {
+      assert.strictEqual(expected, rows)
+      assert(env.theConnection.getStats().counters.prefetchedBatches > before)
+      testDone()
+    })
+  })
+
+  it('iterate a large query in batches with a slow consumer - all rows in order', async function handler () {
+    const sql = 'select top 3000 colid from syscolumns'
+    const expected = await env.theConnection.promises.query(sql, [], { raw: true })
+    const rows = []
+    let batches = 0
+    for await (const batch of env.theConnection.queryStream(sql, [], { batchRows: 250 })) {
+      assert(batch.rows.length <= 250)
+      batch.rows.forEach(r => rows.push(r))
+      ++batches
+      await new Promise(resolve => setTimeout(resolve, 5))
+    }
+    assert.deepStrictEqual(rows, expected.first)
+    assert(batches >= Math.ceil(rows.length / 250))
+  })
+
+  it('leave a batch iteration early then submit new query', async function handler () {
+    const sql = 'select top 3000 * from syscolumns'
+    for await (const batch of env.theConnection.queryStream(sql, [], { batchRows: 100 })) {
+      assert(batch.rows.length > 0)
+      break
+    }
+    const res = await env.theConnection.promises.query('select 1 as n')
+    assert.deepStrictEqual(res.first, [{ n: 1 }])
+  })
+
   it('pause a large query every 100 rows - submit new query', testDone => {
     let expected = 0
     const sql1 = 'select top 3000 * from syscolumns'
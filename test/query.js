@@ -701,4 +701,196 @@ describe('query', function () {
     expect(res.meta[0]).to.deep.equal(expectedMeta)
     expect(res.first).to.deep.equal(expectedData)
   })
+
+  it('fetch varchar as utf8 - bounded and max columns', async function handler () {
+    const conn = env.theConnection
+    const was = conn.getUseUTF8Data()
+    try {
+      conn.setUseUTF8Data(true)
+      const long = 'abcdefghij'.repeat(3000)
+      // 6 bytes a repeat, so sequences straddle the boundary of each chunk read.
+      const wide = 'a\u00e9\u20ac'.repeat(10000)
+      const q = `SELECT CAST('hello' AS varchar(20)) as s, CAST(NULL AS varchar(10)) as n, REPLICATE(CAST('abcdefghij' AS varchar(max)), 3000) as m,
+        REPLICATE(CAST(N'a\u00e9\u20ac' COLLATE Latin1_General_100_CI_AS_SC_UTF8 AS varchar(max)), 10000) as w`
+      const res = await conn.promises.query(q)
+      expect(res.first[0].s).to.equal('hello')
+      expect(res.first[0].n).to.equal(null)
+      expect(res.first[0].m).to.equal(long)
+      expect(res.first[0].w).to.equal(wide)
+    } finally {
+      conn.setUseUTF8Data(was)
+    }
+  })
+
+  it('fetch varchar as utf8 - query object overrides connection', async function handler () {
+    const conn = env.theConnection
+    const sql = 'SELECT CAST(N\'caf\u00e9 \u00fcber\' COLLATE Latin1_General_100_CI_AS_SC_UTF8 AS varchar(20)) as s'
+    const was = conn.getUseUTF8Data()
+    try {
+      conn.setUseUTF8Data(false)
+      const on = await conn.promises.query({ query_str: sql, utf8_data: true })
+      expect(on.first[0].s).to.equal('caf\u00e9 \u00fcber')
+      conn.setUseUTF8Data(true)
+      const off = await conn.promises.query({ query_str: sql, utf8_data: false })
+      expect(off.first[0].s).to.equal('caf\u00e9 \u00fcber')
+    } finally {
+      conn.setUseUTF8Data(was)
+    }
+  })
+
+  it('intern repeated strings - values unchanged with cap exceeded on one column', async function handler () {
+    const conn = env.theConnection
+    const was = conn.getMaxInternedStrings()
+    try {
+      conn.setMaxInternedStrings(2)
+      const q = `SELECT v.status, CAST(v.n AS nvarchar(10)) as code FROM (VALUES ('open', 1), ('closed', 2), ('open', 3), ('closed', 4), ('open', 5)) AS v(status, n)`
+      const res = await conn.promises.query(q)
+      expect(res.first.map(r => r.status)).to.deep.equal(['open', 'closed', 'open', 'closed', 'open'])
+      expect(res.first.map(r => r.code)).to.deep.equal(['1', '2', '3', '4', '5'])
+    } finally {
+      conn.setMaxInternedStrings(was)
+    }
+  })
+
+  it('columnar batches - shared buffer decodes to the same rows', async function handler () {
+    const q = {
+      query_str: `SELECT v.n, v.s, v.b, CAST(v.s AS varchar(10)) as a FROM (VALUES (1, N'one', CAST(1 AS bit)), (2, NULL, CAST(0 AS bit)), (3, N'three', NULL)) AS v(n, s, b)`,
+      columnar: 'shared'
+    }
+    const res = await env.theConnection.promises.query(q)
+    expect(res.first.length).to.equal(0)
+    const views = res.columnar[0]
+    expect(views.length).to.equal(1)
+    const view = views[0]
+    expect(view.buffer).to.be.instanceOf(SharedArrayBuffer)
+    expect(view.rows()).to.deep.equal([
+      [1, 'one', true, 'one'],
+      [2, null, false, null],
+      [3, 'three', null, 'three']
+    ])
+    expect(view.objects()[1]).to.deep.equal({ n: 2, s: null, b: false, a: null })
+  })
+
+  it('columnar batches - row_batches sets the rows per batch', async function handler () {
+    const q = {
+      query_str: 'SELECT v.n FROM (VALUES (1), (2), (3), (4), (5)) AS v(n)',
+      columnar: true,
+      row_batches: 2
+    }
+    const res = await env.theConnection.promises.query(q)
+    const views = res.columnar[0]
+    expect(views.map(v => v.rowCount)).to.deep.equal([2, 2, 1])
+    expect([].concat(...views.map(v => v.rows()))).to.deep.equal([[1], [2], [3], [4], [5]])
+  })
+
+  it('arrow batches - one ipc stream per result set framed by schema and end marker', async function handler () {
+    const q = {
+      query_str: `SELECT v.n, v.s FROM (VALUES (1, N'one'), (2, NULL), (3, N'three')) AS v(n, s)`,
+      columnar: 'arrow'
+    }
+    const res = await env.theConnection.promises.query(q)
+    expect(res.first.length).to.equal(0)
+    const batches = res.arrow[0]
+    expect(batches.length).to.be.greaterThan(0)
+    const stream = Buffer.concat(batches)
+    // every message opens with the continuation marker, the stream ends with a zero length one
+    expect(stream.readUInt32LE(0)).to.equal(0xffffffff)
+    expect(stream.readUInt32LE(stream.length - 8)).to.equal(0xffffffff)
+    expect(stream.readUInt32LE(stream.length - 4)).to.equal(0)
+    expect(stream.includes(Buffer.from('three'))).to.equal(true)
+  })
+
+  it('arrow batches - bigint and decimal keep every digit', async function handler () {
+    const q = {
+      query_str: `SELECT CAST(9007199254740993 AS bigint) AS b, CAST('12345678901234567890.1234567890' AS decimal(38, 10)) AS d`,
+      columnar: 'arrow'
+    }
+    const res = await env.theConnection.promises.query(q)
+    const stream = Buffer.concat(res.arrow[0])
+    const big = Buffer.alloc(8)
+    big.writeBigInt64LE(9007199254740993n)
+    expect(stream.includes(big)).to.equal(true)
+    expect(stream.includes(Buffer.from('12345678901234567890.1234567890'))).to.equal(true)
+  })
+
+  it('granularity row and none - values without column events', async function handler () {
+    const sql = `SELECT v.n, v.s FROM (VALUES (1, N'one'), (2, NULL), (3, N'three')) AS v(n, s)`
+    const expected = [[1, 'one'], [2, null], [3, 'three']]
+    const run = granularity => new Promise((resolve, reject) => {
+      const rows = []
+      let columns = 0
+      const q = env.theConnection.queryRaw({ query_str: sql, granularity }, (err, res) => {
+        if (err) {
+          reject(err)
+          return
+        }
+        resolve({ rows, columns, res })
+      })
+      q.on('row', (i, values) => rows.push(values))
+      q.on('column', () => ++columns)
+    })
+    const byRow = await run('row')
+    expect(byRow.rows).to.deep.equal(expected)
+    expect(byRow.columns).to.equal(0)
+    expect(byRow.res.rows).to.deep.equal(expected)
+    const none = await run('none')
+    expect(none.rows.length).to.equal(0)
+    expect(none.columns).to.equal(0)
+    expect(none.res.rows).to.deep.equal(expected)
+  })
+
+  it('connection stats count the fetches and time each operation', async function handler () {
+    const before = env.theConnection.getStats()
+    await env.theConnection.promises.query(`SELECT v.n, v.s FROM (VALUES (1, N'one'), (2, N'two')) AS v(n, s)`)
+    const after = env.theConnection.getStats()
+    const query = after.operations.query
+    expect(query.execute.count).to.be.greaterThan(0)
+    expect(query.queueWait.count).to.equal(query.execute.count)
+    expect(query.execute.p50).to.be.at.most(query.execute.buckets[query.execute.buckets.length - 1][0])
+    expect(after.counters.fetchCalls).to.be.greaterThan(before.counters.fetchCalls)
+    expect(after.counters.getDataCalls - before.counters.getDataCalls).to.be.at.least(4)
+    expect(after.counters.columnObjects - before.counters.columnObjects).to.be.at.least(4)
+    expect(after.counters.bytesFetched).to.be.greaterThan(before.counters.bytesFetched)
+  })
+
+  it('batch - each statement runs on its own and gets its own results in one round trip', async function handler () {
+    const conn = env.theConnection
+    const before = conn.getStats().operations.queryBatch.execute.count
+    const [a, b, c, d, e, f] = conn.batch([
+      { sql: 'declare @n int = ?; select @n as n', params: [1] },
+      { sql: 'declare @n int = ?; select v.s from (values (?), (@n)) as v(s);', params: [2, 3] },
+      { sql: 'declare @t table (n int); insert into @t values (?); select n from @t', params: [4] },
+      'create procedure #batch_proc as select 5 as n',
+      'exec #batch_proc',
+      'print \'done\''
+    ])
+    expect((await a).first).to.deep.equal([{ n: 1 }])
+    expect((await b).first).to.deep.equal([{ s: 3 }, { s: 2 }])
+    const inserted = await c
+    expect(inserted.counts).to.deep.equal([1])
+    expect(inserted.first).to.deep.equal([{ n: 4 }])
+    expect((await d).results.length).to.equal(0)
+    expect((await e).first).to.deep.equal([{ n: 5 }])
+    expect((await f).info.some(m => m.includes('done'))).to.equal(true)
+    expect(conn.getStats().operations.queryBatch.execute.count - before).to.equal(1)
+
+    const settled = await Promise.allSettled(conn.batch([
+      'select 1 as n',
+      'select 1 / 0 as n',
+      { sql: 'select ? as n', params: [3] }
+    ]))
+    expect(settled.map(s => s.status)).to.deep.equal(['fulfilled', 'rejected', 'fulfilled'])
+    expect(settled[1].reason.batchIndex).to.equal(1)
+    expect(settled[2].value.first).to.deep.equal([{ n: 3 }])
+
+    // a conversion error aborts the batch on the server, so the entry after it never runs.
+    const aborted = await Promise.allSettled(conn.batch([
+      'select \'?\' as q, 1 as n',
+      'select cast(\'z\' as int) as n',
+      'select 3 as n'
+    ]))
+    expect(aborted.map(s => s.status)).to.deep.equal(['fulfilled', 'rejected', 'rejected'])
+    expect(aborted[0].value.first).to.deep.equal([{ q: '?', n: 1 }])
+    expect(aborted[2].reason.message).to.include('batch stopped before this statement ran')
+  })
 })
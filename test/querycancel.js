@@ -100,15 +100,15 @@ describe('querycancel', function () {
     })
   })
 
-  it('cancel single waitfor on non polling query - expect cancel error and query to complete', testDone => {
-    const q = env.theConnection.query(env.waitForSql(3), err => {
-      assert(!err)
+  it('cancel single waitfor on non polling query - expect Operation canceled', testDone => {
+    const q = env.theConnection.query(env.waitForSql(20), err => {
+      assert(err)
+      assert(err.message.indexOf('Operation canceled') > 0)
       testDone()
     })
 
     env.theConnection.cancelQuery(q, err => {
-      assert(err)
-      assert(err.message.indexOf('only supported') > 0)
+      assert(!err)
     })
   })
 
@@ -240,6 +240,50 @@ describe('querycancel', function () {
     })
   })
 
+  it('cancel a prepared query then run it again - expect columns and rows', testDone => {
+    const s = 'waitfor delay ?; select cast(? as int) as n, cast(? as nvarchar(20)) as s'
+    let prepared
+
+    const fns = [
+      asyncDone => {
+        env.theConnection.prepare(env.sql.PollingQuery(s), (err, pq) => {
+          assert(!err)
+          prepared = pq
+          asyncDone()
+        })
+      },
+
+      asyncDone => {
+        const q = prepared.preparedQuery(['00:00:20', 1, 'first'], err => {
+          assert(err)
+          assert(err.message.indexOf('Operation canceled') > 0)
+          asyncDone()
+        })
+
+        q.on('submitted', () => {
+          q.cancelQuery(err => {
+            assert(!err)
+          })
+        })
+      },
+
+      asyncDone => {
+        prepared.preparedQuery(['00:00:00', 2, 'second'], (err, res) => {
+          assert.ifError(err)
+          assert.deepStrictEqual(prepared.getMeta().map(m => m.name), ['n', 's'])
+          assert.deepStrictEqual(res, [{ n: 2, s: 'second' }])
+          asyncDone()
+        })
+      }
+    ]
+
+    env.async.series(fns, () => {
+      prepared.free(() => {
+        testDone()
+      })
+    })
+  })
+
   it('cancel a call to proc that waits for delay of input param.', testDone => {
     const spName = 'test_spwait_for'
 
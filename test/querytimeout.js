@@ -132,6 +132,19 @@ describe('querytimeout', function () {
     })
   })
 
+  it('test deadline 1000 ms on waitfor delay 10', testDone => {
+    const queryObj = {
+      query_str: 'waitfor delay \'00:00:10\';',
+      query_deadline_ms: 1000
+    }
+
+    env.theConnection.query(queryObj, err => {
+      assert(err)
+      assert(err.message.indexOf('Query timeout expired') > 0)
+      testDone()
+    })
+  })
+
   it('test timeout 0 secs on waitfor delay 4', testDone => {
     const queryObj = {
       query_str: 'waitfor delay \'00:00:4\';'
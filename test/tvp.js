@@ -45,6 +45,33 @@ describe('tvp', function () {
     await checkTxt(tableName, vec)
   })
 
+  it('use streamed tvp to insert rows in several chunks', async function handler () {
+    const tableName = 'TestTvp'
+    const helper = env.tvpHelper(tableName)
+    const promises = env.theConnection.promises
+    const table = await helper.create(tableName)
+    const vec = []
+    for (let i = 0; i < 2500; ++i) {
+      vec.push({
+        description: `row ${i}`,
+        username: `user ${i % 7}`,
+        age: i,
+        salary: i * 2,
+        code: i + 0.5,
+        start_date: new Date(2010, 1, 1 + (i % 28))
+      })
+    }
+    async function * source () {
+      for (const row of vec) {
+        yield row
+      }
+    }
+    const tp = env.sql.TvpStream(table, source(), { chunkRows: 1000 })
+    await promises.query('exec insertTestTvp @tvp = ?;', [tp])
+    const res = await promises.query(`select * from ${tableName}`)
+    expect(res.first).to.deep.equal(vec)
+  })
+
   async function namedtvp (tableName) {
     const helper = env.tvpHelper(tableName)
     const vec = helper.getVec(100)